@@ -21,10 +21,13 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/atomic.h"
+#include "common/config-manager.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 
 #include "audio/mixer_intern.h"
+#include "audio/mixer_kernels.h"
 #include "audio/rate.h"
 #include "audio/audiostream.h"
 #include "audio/timestamp.h"
@@ -42,19 +45,21 @@ namespace Audio {
  */
 class Channel {
 public:
-	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent);
+	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, Mixer::ResamplerQuality quality);
 	~Channel();
 
 	/**
-	 * Mixes the channel's samples into the given buffer.
+	 * Mixes the channel's samples into the given accumulator.
 	 *
-	 * @param data buffer where to mix the data
-	 * @param len  number of sample *pairs*. So a value of
-	 *             10 means that the buffer contains twice 10 sample, each
-	 *             16 bits, for a total of 40 bytes.
+	 * @param data  stereo accumulator where to mix the data
+	 * @param block scratch buffer receiving the converted, unscaled block
+	 *              before it is mixed. Must hold 2 * len samples.
+	 * @param len   number of sample *pairs*. So a value of
+	 *              10 means that the accumulator contains twice 10
+	 *              values.
 	 * @return number of sample pairs processed (which can still be silence!)
 	 */
-	int mix(int16 *data, uint len);
+	int mix(int32 *data, int16 *block, uint len);
 
 	/**
 	 * Queries whether the channel is still playing or not.
@@ -78,8 +83,9 @@ public:
 	 *
 	 * @param paused true, when the channel should be paused.
 	 *               false when it should be unpaused.
+	 * @param time   the time of the request, as returned by getMillis(true).
 	 */
-	void pause(bool paused);
+	void pause(bool paused, uint32 time);
 
 	/**
 	 * Queries whether the channel is currently paused.
@@ -134,16 +140,27 @@ public:
 	*/
 	void resetRate();
 
+	/**
+	 * Replace the channel's rate converter with one using the given
+	 * resampling method.
+	 *
+	 * @param quality	The new resampling method.
+	 */
+	void setResamplerQuality(Mixer::ResamplerQuality quality);
+
 	/**
 	 * Notifies the channel that the global sound type
 	 * volume settings changed.
+	 *
+	 * @param volume the volume of the channel's sound type
+	 * @param mute   whether the channel's sound type is muted
 	 */
-	void notifyGlobalVolChange() { updateChannelVolumes(); }
+	void notifyGlobalVolChange(int volume, bool mute) { _typeVolume = volume; _typeMuted = mute; updateChannelVolumes(); }
 
 	/**
-	 * Queries how long the channel has been playing.
+	 * Fills in what is needed to compute how long the channel has been playing.
 	 */
-	Timestamp getElapsedTime();
+	void getTiming(MixerImpl::ChannelTiming &timing) const;
 
 	/**
 	 * Replaces the channel's stream with a version that loops indefinitely.
@@ -167,6 +184,16 @@ public:
 	 */
 	SoundHandle getHandle() const { return _handle; }
 
+	/**
+	 * Fills in the channel's profiling counters.
+	 */
+	void getStats(Mixer::ChannelStats &stats) const;
+
+	/**
+	 * Resets the channel's profiling counters.
+	 */
+	void resetStats();
+
 private:
 	const Mixer::SoundType _type;
 	SoundHandle _handle;
@@ -176,9 +203,13 @@ private:
 
 	byte _volume;
 	int8 _balance;
+	bool _reverseStereo;
+	Mixer::ResamplerQuality _resamplerQuality;
 
 	void updateChannelVolumes();
 	st_volume_t _volL, _volR;
+	int _typeVolume;
+	bool _typeMuted;
 
 	Mixer *_mixer;
 
@@ -188,6 +219,11 @@ private:
 	uint32 _pauseStartTime;
 	uint32 _pauseTime;
 
+	uint32 _callbacks;
+	uint32 _starvedCallbacks;
+	uint64 _samplesProduced;
+	uint64 _mixTime;
+
 	RateConverter *_converter;
 	Common::DisposablePtr<AudioStream> _stream;
 };
@@ -197,22 +233,49 @@ private:
 #pragma mark -
 
 MixerImpl::MixerImpl(uint sampleRate, bool stereo, uint outBufSize)
-	: _mutex(), _sampleRate(sampleRate), _stereo(stereo), _outBufSize(outBufSize), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _streamMutex(), _queueMutex(), _sampleRate(sampleRate), _stereo(stereo), _outBufSize(outBufSize), _mixerReady(false), _handleSeed(0), _resamplerQuality(kResamplerLinear), _soundTypeSettings(),
+	  _commandWrite(0), _commandRead(0), _mixingChannel(NUM_CHANNELS), _retiredWrite(0), _retiredRead(0),
+	  _mixBuffer(nullptr), _blockBuffer(nullptr), _mixBufferLen(0), _snapshotSequence(0) {
 
 	assert(sampleRate > 0);
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
+	memset(&_stats, 0, sizeof(_stats));
+
+	for (int i = 0; i != NUM_CHANNELS; i++) {
 		_channels[i] = nullptr;
+		_channelStates[i].active = false;
+		_finishedHandles[i] = SoundHandle()._val;
+		_activeHandles[i] = SoundHandle()._val;
+	}
+
+	publishSnapshot();
+
+	if (ConfMan.hasKey("resampler") && ConfMan.get("resampler") == "polyphase")
+		_resamplerQuality = kResamplerPolyphase;
 }
 
 MixerImpl::~MixerImpl() {
+	// Make sure channels which were never handed to the audio thread are
+	// freed as well
+	do {
+		deleteRetiredChannels();
+		processCommands();
+	} while (_commandRead != _commandWrite);
+	deleteRetiredChannels();
+
+	for (uint i = 0; i < _overflowCommands.size(); i++) {
+		if (_overflowCommands[i].type == Command::kPlay)
+			delete _overflowCommands[i].channel;
+	}
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		delete _channels[i];
+
+	delete[] _mixBuffer;
+	delete[] _blockBuffer;
 }
 
 void MixerImpl::setReady(bool ready) {
-	Common::StackLock lock(_mutex);
-
 	_mixerReady = ready;
 }
 
@@ -228,10 +291,211 @@ uint MixerImpl::getOutputBufSize() const {
 	return _outBufSize;
 }
 
+void MixerImpl::queueCommand(Command::Type type, int index, uint32 handle, int value, Channel *channel) {
+	Command cmd;
+	cmd.type = type;
+	cmd.index = index;
+	cmd.handle = handle;
+	cmd.value = value;
+	cmd.time = g_system->getMillis(true);
+	cmd.channel = channel;
+
+	flushOverflowCommands();
+
+	if (_overflowCommands.empty() && _commandWrite - Common::atomicLoadAcquire(&_commandRead) < COMMAND_QUEUE_SIZE) {
+		_commands[_commandWrite % COMMAND_QUEUE_SIZE] = cmd;
+		Common::atomicStoreRelease(&_commandWrite, _commandWrite + 1);
+		return;
+	}
+
+	// The queue is full when the audio thread did not run for a while, or
+	// is not running at all. Keep the commands in order until there is
+	// room again, and only keep the latest of repeated setting changes.
+	if (!_overflowCommands.empty()) {
+		Command &last = _overflowCommands.back();
+		const bool isSetting = (type == Command::kVolume || type == Command::kBalance || type == Command::kRate ||
+		                        type == Command::kResamplerQuality || type == Command::kSoundTypeSettings);
+		if (isSetting && last.type == type && last.index == index && (type == Command::kSoundTypeSettings || last.handle == handle)) {
+			last = cmd;
+			return;
+		}
+	}
+
+	_overflowCommands.push_back(cmd);
+}
+
+void MixerImpl::flushOverflowCommands() {
+	uint count = 0;
+	while (count < _overflowCommands.size() && _commandWrite - Common::atomicLoadAcquire(&_commandRead) < COMMAND_QUEUE_SIZE) {
+		_commands[_commandWrite % COMMAND_QUEUE_SIZE] = _overflowCommands[count++];
+		Common::atomicStoreRelease(&_commandWrite, _commandWrite + 1);
+	}
+
+	if (count > 0)
+		_overflowCommands.erase(_overflowCommands.begin(), _overflowCommands.begin() + count);
+}
+
+void MixerImpl::processCommands() {
+	const uint32 write = Common::atomicLoadAcquire(&_commandWrite);
+
+	uint32 read;
+	for (read = _commandRead; read != write; read++) {
+		// Every command retires at most one channel, and so does mixing for
+		// every slot. Leave the rest for the next callback if no API call
+		// deleted the retired channels for a while.
+		if (_retiredWrite - Common::atomicLoadAcquire(&_retiredRead) >= RETIRED_QUEUE_SIZE - NUM_CHANNELS)
+			break;
+
+		const Command &cmd = _commands[read % COMMAND_QUEUE_SIZE];
+
+		if (cmd.type == Command::kPlay) {
+			// The previous sound of the slot has been stopped already
+			if (_channels[cmd.index])
+				retireChannel(cmd.index);
+			_channels[cmd.index] = cmd.channel;
+			continue;
+		}
+
+		if (cmd.type == Command::kSoundTypeSettings) {
+			for (int i = 0; i != NUM_CHANNELS; ++i) {
+				if (_channels[i] && _channels[i]->getType() == cmd.index)
+					_channels[i]->notifyGlobalVolChange(cmd.value, cmd.handle != 0);
+			}
+			continue;
+		}
+
+		if (cmd.type == Command::kResetStats) {
+			memset(&_stats, 0, sizeof(_stats));
+			for (int i = 0; i != NUM_CHANNELS; ++i) {
+				if (_channels[i])
+					_channels[i]->resetStats();
+			}
+			continue;
+		}
+
+		// Ignore commands for sounds which have already terminated
+		Channel *chan = _channels[cmd.index];
+		if (!chan || chan->getHandle()._val != cmd.handle)
+			continue;
+
+		switch (cmd.type) {
+		case Command::kPause:
+			chan->pause(cmd.value != 0, cmd.time);
+			break;
+		case Command::kVolume:
+			chan->setVolume(cmd.value);
+			break;
+		case Command::kBalance:
+			chan->setBalance(cmd.value);
+			break;
+		case Command::kRate:
+			chan->setRate(cmd.value);
+			break;
+		case Command::kResetRate:
+			chan->resetRate();
+			break;
+		case Command::kLoop:
+			chan->loop();
+			break;
+		case Command::kResamplerQuality:
+			chan->setResamplerQuality((ResamplerQuality)cmd.value);
+			break;
+		default:
+			break;
+		}
+	}
+
+	Common::atomicStoreRelease(&_commandRead, read);
+}
+
+void MixerImpl::retireChannel(int index) {
+	_retiredChannels[_retiredWrite % RETIRED_QUEUE_SIZE] = _channels[index];
+	Common::atomicStoreRelease(&_retiredWrite, _retiredWrite + 1);
+	_channels[index] = nullptr;
+}
+
+void MixerImpl::deleteRetiredChannels() {
+	const uint32 write = Common::atomicLoadAcquire(&_retiredWrite);
+
+	while (_retiredRead != write) {
+		// Take the channel out first, in case its stream calls back into
+		// the mixer while being deleted
+		Channel *chan = _retiredChannels[_retiredRead % RETIRED_QUEUE_SIZE];
+		Common::atomicStoreRelease(&_retiredRead, _retiredRead + 1);
+		delete chan;
+	}
+}
+
+void MixerImpl::publishSnapshot() {
+	const uint32 sequence = _snapshotSequence;
+	Common::atomicExchange(&_snapshotSequence, sequence + 1);
+
+	_snapshotStats = _stats;
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		ChannelSnapshot &snapshot = _snapshotChannels[i];
+		if (_channels[i]) {
+			_channels[i]->getStats(snapshot.stats);
+			snapshot.stats.index = i;
+			_channels[i]->getTiming(snapshot.timing);
+		} else {
+			snapshot.stats.handle = SoundHandle();
+		}
+	}
+
+	Common::atomicStoreRelease(&_snapshotSequence, sequence + 2);
+}
+
+void MixerImpl::updateChannelStates() {
+	deleteRetiredChannels();
+	flushOverflowCommands();
+
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		ChannelState &state = _channelStates[i];
+		if (state.active && Common::atomicLoadAcquire(&_finishedHandles[i]) == state.handle)
+			state.active = false;
+	}
+}
+
+MixerImpl::ChannelState *MixerImpl::findChannelState(SoundHandle handle) {
+	updateChannelStates();
+
+	ChannelState &state = _channelStates[handle._val % NUM_CHANNELS];
+	if (!state.active || state.handle != handle._val)
+		return nullptr;
+
+	return &state;
+}
+
+void MixerImpl::stopChannel(int index) {
+	ChannelState &state = _channelStates[index];
+	state.active = false;
+
+	Common::atomicExchange(&_activeHandles[index], SoundHandle()._val);
+}
+
+void MixerImpl::waitForStoppedChannel(int index) {
+	// The audio thread checks for stop requests right before mixing a
+	// channel, so it only has to be waited for while it is mixing this one.
+	// Stopping is synchronous, since callers may free the data of the
+	// stopped streams right away.
+	if (Common::atomicLoadAcquire(&_mixingChannel) != (uint32)index)
+		return;
+
+	// When a stream stops a channel from within the audio thread, this
+	// returns right away, as the mutex is recursive
+	Common::StackLock lock(_streamMutex);
+}
+
+void MixerImpl::pauseChannel(int index, bool paused) {
+	queueCommand(Command::kPause, index, _channelStates[index].handle, paused);
+}
+
 void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
+	updateChannelStates();
+
 	int index = -1;
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] == nullptr) {
+		if (!_channelStates[i].active) {
 			index = i;
 			break;
 		}
@@ -242,8 +506,6 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 		return;
 	}
 
-	_channels[index] = chan;
-
 	SoundHandle chanHandle;
 	chanHandle._val = index + (_handleSeed * NUM_CHANNELS);
 
@@ -251,6 +513,22 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	_handleSeed++;
 	if (handle)
 		*handle = chanHandle;
+
+	ChannelState &state = _channelStates[index];
+	state.active = true;
+	state.handle = chanHandle._val;
+	state.id = chan->getId();
+	state.type = chan->getType();
+	state.permanent = chan->isPermanent();
+	state.volume = chan->getVolume();
+	state.balance = chan->getBalance();
+	state.rate = chan->getRate();
+	state.streamRate = state.rate;
+
+	// The previous sound of the slot is done, so the audio thread may
+	// retire it right away if it didn't already
+	Common::atomicStoreRelease(&_activeHandles[index], chanHandle._val);
+	queueCommand(Command::kPlay, index, chanHandle._val, 0, chan);
 }
 
 void MixerImpl::playStream(
@@ -261,7 +539,7 @@ void MixerImpl::playStream(
 			DisposeAfterUse::Flag autofreeStream,
 			bool permanent,
 			bool reverseStereo) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_queueMutex);
 
 	if (stream == nullptr) {
 		warning("stream is 0");
@@ -273,8 +551,9 @@ void MixerImpl::playStream(
 
 	// Prevent duplicate sounds
 	if (id != -1) {
+		updateChannelStates();
 		for (int i = 0; i != NUM_CHANNELS; i++)
-			if (_channels[i] != nullptr && _channels[i]->getId() == id) {
+			if (_channelStates[i].active && _channelStates[i].id == id) {
 				// Delete the stream if were asked to auto-dispose it.
 				// Note: This could cause trouble if the client code does not
 				// yet expect the stream to be gone. The primary example to
@@ -291,8 +570,10 @@ void MixerImpl::playStream(
 	reverseStereo = !reverseStereo;
 #endif
 
-	// Create the channel
-	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
+	// Create the channel. It is only handed over to the audio thread once
+	// it is fully set up.
+	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent, _resamplerQuality);
+	chan->notifyGlobalVolChange(_soundTypeSettings[type].volume, _soundTypeSettings[type].mute);
 	chan->setVolume(volume);
 	chan->setBalance(balance);
 	insertChannel(handle, chan);
@@ -301,16 +582,18 @@ void MixerImpl::playStream(
 int MixerImpl::mixCallback(byte *samples, uint len) {
 	assert(samples);
 
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_streamMutex);
+
+	const uint64 startTime = g_system->getMicros();
+
+	// Apply everything the API calls queued since the last callback
+	processCommands();
 
 	int16 *buf = (int16 *)samples;
 
 	// Since the mixer callback has been called, the mixer must be ready...
 	_mixerReady = true;
 
-	//  zero the buf
-	memset(buf, 0, len);
-
 	// we store 16-bit samples
 	if (_stereo) {
 		assert(len % 4 == 0);
@@ -320,64 +603,146 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 		len >>= 1;
 	}
 
+	// Channels are always accumulated as stereo frames, at 32 bits per
+	// sample, and only clamped once all of them have been mixed
+	if (len > _mixBufferLen) {
+		delete[] _mixBuffer;
+		delete[] _blockBuffer;
+		_mixBuffer = new int32[len * 2];
+		_blockBuffer = new int16[len * 2];
+		_mixBufferLen = len;
+	}
+
+	//  zero the accumulator
+	memset(_mixBuffer, 0, len * 2 * sizeof(int32));
+
 	// mix all channels
 	int res = 0, tmp;
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i]) {
-			if (_channels[i]->isFinished()) {
-				delete _channels[i];
-				_channels[i] = nullptr;
+			// Announce the channel before checking whether it was stopped,
+			// see waitForStoppedChannel()
+			Common::atomicExchange(&_mixingChannel, i);
+
+			const uint32 handle = _channels[i]->getHandle()._val;
+			if (Common::atomicLoadAcquire(&_activeHandles[i]) != handle) {
+				retireChannel(i);
+			} else if (_channels[i]->isFinished()) {
+				retireChannel(i);
+
+				// Let the API calls know the sound is gone
+				Common::atomicStoreRelease(&_finishedHandles[i], handle);
 			} else if (!_channels[i]->isPaused()) {
-				tmp = _channels[i]->mix(buf, len);
+				tmp = _channels[i]->mix(_mixBuffer, _blockBuffer, len);
 
 				if (tmp > res)
 					res = tmp;
 			}
+
+			Common::atomicExchange(&_mixingChannel, NUM_CHANNELS);
 		}
 
+	if (_stereo)
+		MixerKernels::clamp(buf, _mixBuffer, len * 2);
+	else
+		MixerKernels::clampMono(buf, _mixBuffer, len);
+
+	const uint32 mixTime = (uint32)(g_system->getMicros() - startTime);
+	_stats.callbacks++;
+	_stats.samplesRequested += len;
+	_stats.mixTime += mixTime;
+	if (mixTime > _stats.maxCallbackTime)
+		_stats.maxCallbackTime = mixTime;
+	// The backend needs the next buffer by the time this one has played
+	if ((uint64)mixTime * _sampleRate > (uint64)len * 1000000)
+		_stats.overrunCallbacks++;
+
+	publishSnapshot();
+
 	return res;
 }
 
+void MixerImpl::getStats(MixerStats &mixerStats, Common::Array<ChannelStats> &channelStats) {
+	// Copy the snapshot, retrying if it was updated in the meantime
+	uint32 sequence;
+	do {
+		sequence = Common::atomicLoadAcquire(&_snapshotSequence);
+		if (sequence & 1)
+			continue;
+
+		mixerStats = _snapshotStats;
+
+		channelStats.clear();
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_snapshotChannels[i].stats.handle._val != SoundHandle()._val)
+				channelStats.push_back(_snapshotChannels[i].stats);
+		}
+	} while ((sequence & 1) || Common::atomicFetchAdd(&_snapshotSequence, 0) != sequence);
+}
+
+void MixerImpl::resetStats() {
+	Common::StackLock lock(_queueMutex);
+	queueCommand(Command::kResetStats, 0, 0);
+}
+
 void MixerImpl::stopAll() {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = nullptr;
+	bool stopped[NUM_CHANNELS];
+	{
+		Common::StackLock lock(_queueMutex);
+		updateChannelStates();
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			stopped[i] = _channelStates[i].active && !_channelStates[i].permanent;
+			if (stopped[i])
+				stopChannel(i);
 		}
 	}
+
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		if (stopped[i])
+			waitForStoppedChannel(i);
+	}
 }
 
 void MixerImpl::stopID(int id) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = nullptr;
+	bool stopped[NUM_CHANNELS];
+	{
+		Common::StackLock lock(_queueMutex);
+		updateChannelStates();
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			stopped[i] = _channelStates[i].active && _channelStates[i].id == id;
+			if (stopped[i])
+				stopChannel(i);
 		}
 	}
+
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		if (stopped[i])
+			waitForStoppedChannel(i);
+	}
 }
 
 void MixerImpl::stopHandle(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
-	// Simply ignore stop requests for handles of sounds that already terminated
 	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
+	{
+		Common::StackLock lock(_queueMutex);
 
-	delete _channels[index];
-	_channels[index] = nullptr;
+		// Simply ignore stop requests for handles of sounds that already terminated
+		if (!findChannelState(handle))
+			return;
+
+		stopChannel(index);
+	}
+
+	waitForStoppedChannel(index);
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
+
+	Common::StackLock lock(_queueMutex);
 	_soundTypeSettings[type].mute = mute;
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	queueCommand(Command::kSoundTypeSettings, type, mute, _soundTypeSettings[type].volume);
 }
 
 bool MixerImpl::isSoundTypeMuted(SoundType type) const {
@@ -386,67 +751,95 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 }
 
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_queueMutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	ChannelState *state = findChannelState(handle);
+	if (!state)
 		return;
 
-	_channels[index]->setVolume(volume);
+	state->volume = volume;
+	queueCommand(Command::kVolume, handle._val % NUM_CHANNELS, handle._val, volume);
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Common::StackLock lock(_queueMutex);
+
+	ChannelState *state = findChannelState(handle);
+	if (!state)
 		return 0;
 
-	return _channels[index]->getVolume();
+	return state->volume;
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_queueMutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	ChannelState *state = findChannelState(handle);
+	if (!state)
 		return;
 
-	_channels[index]->setBalance(balance);
+	state->balance = balance;
+	queueCommand(Command::kBalance, handle._val % NUM_CHANNELS, handle._val, balance);
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Common::StackLock lock(_queueMutex);
+
+	ChannelState *state = findChannelState(handle);
+	if (!state)
 		return 0;
 
-	return _channels[index]->getBalance();
+	return state->balance;
 }
 
 void MixerImpl::setChannelRate(SoundHandle handle, uint32 rate) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_queueMutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	ChannelState *state = findChannelState(handle);
+	if (!state)
 		return;
 
-	_channels[index]->setRate(rate);
+	state->rate = rate;
+	queueCommand(Command::kRate, handle._val % NUM_CHANNELS, handle._val, rate);
 }
 
 uint32 MixerImpl::getChannelRate(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Common::StackLock lock(_queueMutex);
+
+	ChannelState *state = findChannelState(handle);
+	if (!state)
 		return 0;
-	
-	return _channels[index]->getRate();
+
+	return state->rate;
 }
 
 void MixerImpl::resetChannelRate(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_queueMutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	ChannelState *state = findChannelState(handle);
+	if (!state)
 		return;
-	
-	_channels[index]->resetRate();
+
+	state->rate = state->streamRate;
+	queueCommand(Command::kResetRate, handle._val % NUM_CHANNELS, handle._val);
+}
+
+void MixerImpl::setChannelResamplerQuality(SoundHandle handle, ResamplerQuality quality) {
+	Common::StackLock lock(_queueMutex);
+
+	if (!findChannelState(handle))
+		return;
+
+	queueCommand(Command::kResamplerQuality, handle._val % NUM_CHANNELS, handle._val, quality);
+}
+
+void MixerImpl::setResamplerQuality(ResamplerQuality quality) {
+	Common::StackLock lock(_queueMutex);
+	_resamplerQuality = quality;
+}
+
+Mixer::ResamplerQuality MixerImpl::getResamplerQuality() const {
+	return _resamplerQuality;
 }
 
 uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
@@ -454,91 +847,125 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 }
 
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
+	const ChannelSnapshot &snapshot = _snapshotChannels[handle._val % NUM_CHANNELS];
+
+	// Copy the snapshot, retrying if it was updated in the meantime
+	uint32 sequence;
+	bool found;
+	ChannelTiming timing;
+	do {
+		sequence = Common::atomicLoadAcquire(&_snapshotSequence);
+		if (sequence & 1)
+			continue;
+
+		found = (snapshot.stats.handle._val == handle._val);
+		timing = snapshot.timing;
+	} while ((sequence & 1) || Common::atomicFetchAdd(&_snapshotSequence, 0) != sequence);
+
+	Timestamp ts(0, _sampleRate);
+
+	// Sounds which haven't been mixed yet, or are gone already, have no
+	// elapsed time
+	if (!found || timing.mixerTimeStamp == 0)
+		return ts;
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return Timestamp(0, _sampleRate);
+	uint32 delta;
+	if (timing.paused)
+		delta = timing.pauseStartTime - timing.mixerTimeStamp;
+	else
+		delta = g_system->getMillis(true) - timing.mixerTimeStamp - timing.pauseTime;
+
+	// Convert the number of samples into a time duration.
+
+	ts = ts.addFrames(timing.samplesConsumed);
+	ts = ts.addMsecs(delta);
+
+	// In theory it would seem like a good idea to limit the approximation
+	// so that it never exceeds the theoretical upper bound set by
+	// _samplesDecoded. Meanwhile, back in the real world, doing so makes
+	// the Broken Sword cutscenes noticeably jerkier. I guess the mixer
+	// isn't invoked at the regular intervals that I first imagined.
 
-	return _channels[index]->getElapsedTime();
+	return ts;
 }
 
 void MixerImpl::loopChannel(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_queueMutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	if (!findChannelState(handle))
 		return;
 
-	_channels[index]->loop();
+	queueCommand(Command::kLoop, handle._val % NUM_CHANNELS, handle._val);
 }
 
 void MixerImpl::pauseAll(bool paused) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_queueMutex);
+	updateChannelStates();
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr) {
-			_channels[i]->pause(paused);
-		}
+		if (_channelStates[i].active)
+			pauseChannel(i, paused);
 	}
 }
 
 void MixerImpl::pauseID(int id, bool paused) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_queueMutex);
+	updateChannelStates();
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
-			_channels[i]->pause(paused);
+		if (_channelStates[i].active && _channelStates[i].id == id) {
+			pauseChannel(i, paused);
 			return;
 		}
 	}
 }
 
 void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_queueMutex);
 
 	// Simply ignore (un)pause requests for sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	if (!findChannelState(handle))
 		return;
 
-	_channels[index]->pause(paused);
+	pauseChannel(handle._val % NUM_CHANNELS, paused);
 }
 
 bool MixerImpl::isSoundIDActive(int id) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_queueMutex);
 
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
+	updateChannelStates();
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getId() == id)
+		if (_channelStates[i].active && _channelStates[i].id == id)
 			return true;
 	return false;
 }
 
 int MixerImpl::getSoundID(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-	const int index = handle._val % NUM_CHANNELS;
-	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
-		return _channels[index]->getId();
+	Common::StackLock lock(_queueMutex);
+
+	ChannelState *state = findChannelState(handle);
+	if (state)
+		return state->id;
 	return 0;
 }
 
 bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_queueMutex);
 
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
-	const int index = handle._val % NUM_CHANNELS;
-	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
+	return findChannelState(handle) != nullptr;
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_queueMutex);
+	updateChannelStates();
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getType() == type)
+		if (_channelStates[i].active && _channelStates[i].type == type)
 			return true;
 	return false;
 }
@@ -552,13 +979,10 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 	// TODO: Maybe we should do logarithmic (not linear) volume
 	// scaling? See also Player_V2::setMasterVolume
 
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_queueMutex);
 	_soundTypeSettings[type].volume = volume;
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	queueCommand(Command::kSoundTypeSettings, type, _soundTypeSettings[type].mute, volume);
 }
 
 int MixerImpl::getVolumeForSoundType(SoundType type) const {
@@ -573,16 +997,19 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 #pragma mark -
 
 Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
-				 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
+				 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, Mixer::ResamplerQuality quality)
 	: _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
-	  _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
-	  _pauseStartTime(0), _pauseTime(0), _converter(nullptr), _volL(0), _volR(0),
+	  _balance(0), _reverseStereo(reverseStereo), _resamplerQuality(quality), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
+	  _pauseStartTime(0), _pauseTime(0), _callbacks(0), _starvedCallbacks(0), _samplesProduced(0), _mixTime(0),
+	  _converter(nullptr), _volL(0), _volR(0),
+	  _typeVolume(Mixer::kMaxMixerVolume), _typeMuted(false),
 	  _stream(stream, autofreeStream) {
 	assert(mixer);
 	assert(stream);
 
 	// Get a rate converter instance
-	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), mixer->getOutputStereo(), reverseStereo);
+	// The converter always produces stereo blocks, see Channel::mix
+	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), true, reverseStereo, quality);
 }
 
 Channel::~Channel() {
@@ -625,6 +1052,18 @@ void Channel::resetRate() {
 	}
 }
 
+void Channel::setResamplerQuality(Mixer::ResamplerQuality quality) {
+	if (quality == _resamplerQuality)
+		return;
+
+	// Keep any rate that was set through setRate()
+	const st_rate_t rate = _converter->getInputRate();
+
+	delete _converter;
+	_converter = makeRateConverter(rate, _mixer->getOutputRate(), _stream->isStereo(), true, _reverseStereo, quality);
+	_resamplerQuality = quality;
+}
+
 void Channel::updateChannelVolumes() {
 	// From the channel balance/volume and the global volume, we compute
 	// the effective volume for the left and right channel. Note the
@@ -634,8 +1073,8 @@ void Channel::updateChannelVolumes() {
 	// volume is in the range 0 - kMaxMixerVolume.
 	// Hence, the vol_l/vol_r values will be in that range, too
 
-	if (!_mixer->isSoundTypeMuted(_type)) {
-		int vol = _mixer->getVolumeForSoundType(_type) * _volume;
+	if (!_typeMuted) {
+		int vol = _typeVolume * _volume;
 
 		if (_balance == 0) {
 			_volL = vol / Mixer::kMaxChannelVolume;
@@ -652,50 +1091,30 @@ void Channel::updateChannelVolumes() {
 	}
 }
 
-void Channel::pause(bool paused) {
+void Channel::pause(bool paused, uint32 time) {
 	//assert((paused && _pauseLevel >= 0) || (!paused && _pauseLevel));
 
 	if (paused) {
 		_pauseLevel++;
 
 		if (_pauseLevel == 1)
-			_pauseStartTime = g_system->getMillis(true);
+			_pauseStartTime = time;
 	} else if (_pauseLevel > 0) {
 		_pauseLevel--;
 
 		if (!_pauseLevel) {
-			_pauseTime = (g_system->getMillis(true) - _pauseStartTime);
+			_pauseTime = (time - _pauseStartTime);
 			_pauseStartTime = 0;
 		}
 	}
 }
 
-Timestamp Channel::getElapsedTime() {
-	const uint32 rate = _mixer->getOutputRate();
-	uint32 delta = 0;
-
-	Audio::Timestamp ts(0, rate);
-
-	if (_mixerTimeStamp == 0)
-		return ts;
-
-	if (isPaused())
-		delta = _pauseStartTime - _mixerTimeStamp;
-	else
-		delta = g_system->getMillis(true) - _mixerTimeStamp - _pauseTime;
-
-	// Convert the number of samples into a time duration.
-
-	ts = ts.addFrames(_samplesConsumed);
-	ts = ts.addMsecs(delta);
-
-	// In theory it would seem like a good idea to limit the approximation
-	// so that it never exceeds the theoretical upper bound set by
-	// _samplesDecoded. Meanwhile, back in the real world, doing so makes
-	// the Broken Sword cutscenes noticeably jerkier. I guess the mixer
-	// isn't invoked at the regular intervals that I first imagined.
-
-	return ts;
+void Channel::getTiming(MixerImpl::ChannelTiming &timing) const {
+	timing.samplesConsumed = _samplesConsumed;
+	timing.mixerTimeStamp = _mixerTimeStamp;
+	timing.pauseStartTime = _pauseStartTime;
+	timing.pauseTime = _pauseTime;
+	timing.paused = isPaused();
 }
 
 void Channel::loop() {
@@ -707,20 +1126,55 @@ void Channel::loop() {
 	}
 }
 
-int Channel::mix(int16 *data, uint len) {
+int Channel::mix(int32 *data, int16 *block, uint len) {
 	assert(_stream);
 	assert(_converter);
 
 	int res = 0;
 	if (!_stream->endOfData() || _converter->needsDraining()) {
+		const uint64 startTime = g_system->getMicros();
+
 		_samplesConsumed = _samplesDecoded;
 		_mixerTimeStamp = g_system->getMillis(true);
 		_pauseTime = 0;
-		res = _converter->convert(*_stream, data, len, _volL, _volR);
+		res = _converter->convertBlock(*_stream, block, len);
+		if (res > 0 && (_volL || _volR))
+			MixerKernels::accumulate(data, block, res, _volL, _volR);
 		_samplesDecoded += res;
+
+		_callbacks++;
+		_samplesProduced += res;
+		_mixTime += g_system->getMicros() - startTime;
+		// A stream which runs dry without having ended could not keep up
+		if ((uint)res < len && !_stream->endOfStream())
+			_starvedCallbacks++;
+	} else if (!_stream->endOfStream()) {
+		// Waiting for more data, e.g. an empty queuing stream
+		_callbacks++;
+		_starvedCallbacks++;
 	}
 
 	return res;
 }
 
+void Channel::getStats(Mixer::ChannelStats &stats) const {
+	stats.handle = _handle;
+	stats.index = -1;
+	stats.id = _id;
+	stats.type = _type;
+	stats.paused = isPaused();
+	stats.rate = _converter->getInputRate();
+	stats.callbacks = _callbacks;
+	stats.starvedCallbacks = _starvedCallbacks;
+	stats.samplesProduced = _samplesProduced;
+	stats.mixTime = _mixTime;
+}
+
+void Channel::resetStats() {
+	_callbacks = 0;
+	_starvedCallbacks = 0;
+	_samplesProduced = 0;
+	_mixTime = 0;
+}
+
 } // End of namespace Audio
@@ -22,6 +22,7 @@
 #ifndef AUDIO_MIXER_H
 #define AUDIO_MIXER_H
 
+#include "common/array.h"
 #include "common/mutex.h"
 #include "common/types.h"
 #include "common/noncopyable.h"
@@ -72,6 +73,35 @@ public:
 		kMaxMixerVolume = 256    /*!< Max global volume. */
 	};
 
+	/** Resampling methods used when a stream's rate differs from the output rate. */
+	enum ResamplerQuality {
+		kResamplerLinear = 0,   /*!< Linear interpolation. Fast, but aliases audibly. */
+		kResamplerPolyphase = 1 /*!< Windowed-sinc polyphase filter. */
+	};
+
+	/** Profiling counters of a single playing channel. */
+	struct ChannelStats {
+		SoundHandle handle;        /*!< Handle of the sound. */
+		int index;                 /*!< Slot the sound occupies in the mixer. */
+		int id;                    /*!< ID the sound was started with. */
+		SoundType type;            /*!< Type of the sound. */
+		bool paused;               /*!< Whether the sound is currently paused. */
+		uint32 rate;               /*!< Input rate of the sound, in Hz. */
+		uint32 callbacks;          /*!< Number of mix callbacks the sound took part in. */
+		uint32 starvedCallbacks;   /*!< Callbacks in which the stream delivered less data than requested without having ended. */
+		uint64 samplesProduced;    /*!< Output frames produced for the sound. */
+		uint64 mixTime;            /*!< Time spent decoding, converting and mixing the sound, in microseconds. */
+	};
+
+	/** Profiling counters of the mixer as a whole. */
+	struct MixerStats {
+		uint32 callbacks;          /*!< Number of mix callbacks. */
+		uint64 samplesRequested;   /*!< Output frames requested by the backend. */
+		uint64 mixTime;            /*!< Total time spent in the mix callback, in microseconds. */
+		uint32 maxCallbackTime;    /*!< Longest single mix callback, in microseconds. */
+		uint32 overrunCallbacks;   /*!< Callbacks which took longer than the audio they produced lasts, risking an underrun. */
+	};
+
 public:
 	Mixer() {}
 	virtual ~Mixer() {}
@@ -277,6 +307,32 @@ public:
 	*/
 	virtual void resetChannelRate(SoundHandle handle) = 0;
 
+	/**
+	 * Set the resampling method for the given handle.
+	 *
+	 * Switching the method discards any input the channel has buffered, so
+	 * this is best done right after starting the sound.
+	 *
+	 * @param handle 	The sound to affect.
+	 * @param quality	The new resampling method.
+	 */
+	virtual void setChannelResamplerQuality(SoundHandle handle, ResamplerQuality quality) = 0;
+
+	/**
+	 * Set the resampling method used for sounds started from now on.
+	 *
+	 * The initial value is taken from the "resampler" configuration key,
+	 * which can be either "linear" or "polyphase".
+	 *
+	 * @param quality	The new default resampling method.
+	 */
+	virtual void setResamplerQuality(ResamplerQuality quality) = 0;
+
+	/**
+	 * Get the resampling method used for newly started sounds.
+	 */
+	virtual ResamplerQuality getResamplerQuality() const = 0;
+
 	/**
 	 * Get an approximation of for how long the channel has been playing.
 	 */
@@ -345,6 +401,23 @@ public:
 	 * @return The number of samples processed at each audio callback.
 	 */
 	virtual uint getOutputBufSize() const = 0;
+
+	/**
+	 * Retrieve the profiling counters of the mixer and of all
+	 * currently playing sounds.
+	 *
+	 * The counters accumulate since the sound was started, respectively
+	 * since the mixer was created or resetStats() was last called.
+	 *
+	 * @param mixerStats     Receives the counters of the mixer as a whole.
+	 * @param channelStats   Receives one entry per playing sound.
+	 */
+	virtual void getStats(MixerStats &mixerStats, Common::Array<ChannelStats> &channelStats) = 0;
+
+	/**
+	 * Reset the profiling counters of the mixer and of all playing sounds.
+	 */
+	virtual void resetStats() = 0;
 };
 
 /** @} */
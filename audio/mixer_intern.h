@@ -23,6 +23,7 @@
 #define AUDIO_MIXER_INTERN_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
 #include "common/mutex.h"
 #include "audio/mixer.h"
 
@@ -61,13 +62,26 @@ private:
 		NUM_CHANNELS = 32
 	};
 
-	Common::Mutex _mutex;
+	/**
+	 * Held by the audio thread while mixing, and available to the engines
+	 * through mutex(), to synchronize their streams with the audio thread.
+	 * The mixer does not use it to guard its own state.
+	 */
+	Common::Mutex _streamMutex;
+
+	/**
+	 * Serializes the API calls, which only touch the command queue and the
+	 * channel states. The audio thread never takes it, unless code running
+	 * from the audio thread calls into the mixer.
+	 */
+	Common::Mutex _queueMutex;
 
 	const uint _sampleRate;
 	const bool _stereo;
 	const uint _outBufSize;
 	bool _mixerReady;
 	uint32 _handleSeed;
+	ResamplerQuality _resamplerQuality;
 
 	struct SoundTypeSettings {
 		SoundTypeSettings() : mute(false), volume(kMaxMixerVolume) {}
@@ -77,17 +91,153 @@ private:
 	};
 
 	SoundTypeSettings _soundTypeSettings[4];
+
+	/** The channels, only accessed by the audio thread. */
 	Channel *_channels[NUM_CHANNELS];
 
+	/**
+	 * A change requested through the API, which is applied by the audio
+	 * thread at the start of the next mixCallback().
+	 */
+	struct Command {
+		enum Type {
+			kPlay,
+			kPause,
+			kVolume,
+			kBalance,
+			kRate,
+			kResetRate,
+			kLoop,
+			kResamplerQuality,
+			kSoundTypeSettings,
+			kResetStats
+		};
+
+		Type type;
+		/** Channel index, or the sound type for kSoundTypeSettings. */
+		int index;
+		/** Handle of the channel, or the mute flag for kSoundTypeSettings. */
+		uint32 handle;
+		int value;
+		/** Time the command was issued at. */
+		uint32 time;
+		/** The new channel for kPlay. */
+		Channel *channel;
+	};
+
+	enum {
+		COMMAND_QUEUE_SIZE = 256
+	};
+
+	/**
+	 * Single producer/single consumer ring of commands. Producers are
+	 * serialized through _queueMutex, and commands are only consumed by
+	 * the audio thread.
+	 */
+	Command _commands[COMMAND_QUEUE_SIZE];
+	volatile uint32 _commandWrite;
+	volatile uint32 _commandRead;
+
+	/**
+	 * Commands which did not fit into the ring while the audio thread was
+	 * not running, in order. Protected by _queueMutex.
+	 */
+	Common::Array<Command> _overflowCommands;
+
+	/**
+	 * Handle of the sound the API calls consider active in each channel.
+	 * The audio thread checks it right before mixing a channel, and retires
+	 * any other channel, so a stopped stream is not read anymore.
+	 */
+	volatile uint32 _activeHandles[NUM_CHANNELS];
+
+	/** The channel the audio thread is mixing right now, or NUM_CHANNELS. */
+	volatile uint32 _mixingChannel;
+
+	enum {
+		RETIRED_QUEUE_SIZE = 2 * NUM_CHANNELS
+	};
+
+	/**
+	 * Channels removed by the audio thread, which are deleted by the next
+	 * API call, so streams are never destroyed on the audio thread. Single
+	 * producer/single consumer ring; the audio thread keeps room for one
+	 * channel per slot, see processCommands().
+	 */
+	Channel *_retiredChannels[RETIRED_QUEUE_SIZE];
+	volatile uint32 _retiredWrite;
+	volatile uint32 _retiredRead;
+
+	/**
+	 * The state of a channel as seen by the API calls, which is updated as
+	 * soon as the commands are queued. Protected by _queueMutex.
+	 */
+	struct ChannelState {
+		bool active;
+		uint32 handle;
+		int id;
+		SoundType type;
+		bool permanent;
+		byte volume;
+		int8 balance;
+		uint32 rate;
+		uint32 streamRate;
+	};
+
+	ChannelState _channelStates[NUM_CHANNELS];
+
+	/**
+	 * Handle of the last sound in each channel which ended on its own,
+	 * published by the audio thread so the channel states can catch up.
+	 */
+	volatile uint32 _finishedHandles[NUM_CHANNELS];
+
+	/** 32-bit stereo accumulator all channels are mixed into. */
+	int32 *_mixBuffer;
+	/** Scratch buffer holding the converted block of a single channel. */
+	int16 *_blockBuffer;
+	/** Capacity of the buffers above, in sample pairs. */
+	uint _mixBufferLen;
+
+	/** Profiling counters, only accessed by the audio thread. */
+	MixerStats _stats;
+
+public:
+	/** What getElapsedTime() needs to know about a channel. */
+	struct ChannelTiming {
+		uint32 samplesConsumed;
+		uint32 mixerTimeStamp;
+		uint32 pauseStartTime;
+		uint32 pauseTime;
+		bool paused;
+	};
+
+private:
+	struct ChannelSnapshot {
+		/** The handle is invalid for an unused channel. */
+		ChannelStats stats;
+		ChannelTiming timing;
+	};
+
+	/**
+	 * Copy of the channel statistics and timing, published by the audio
+	 * thread after every callback, so that getStats() and getElapsedTime()
+	 * don't have to wait for it. The sequence number is odd while the
+	 * snapshot is being written.
+	 */
+	volatile uint32 _snapshotSequence;
+	MixerStats _snapshotStats;
+	ChannelSnapshot _snapshotChannels[NUM_CHANNELS];
+
 
 public:
 
 	MixerImpl(uint sampleRate, bool stereo = true, uint outBufSize = 0);
 	~MixerImpl();
 
-	virtual bool isReady() const { Common::StackLock lock(_mutex); return _mixerReady; }
+	virtual bool isReady() const { return _mixerReady; }
 
-	virtual Common::Mutex &mutex() { return _mutex; }
+	virtual Common::Mutex &mutex() { return _streamMutex; }
 
 	virtual void playStream(
 		SoundType type,
@@ -122,6 +272,10 @@ public:
 	virtual uint32 getChannelRate(SoundHandle handle);
 	virtual void resetChannelRate(SoundHandle handle);
 
+	virtual void setChannelResamplerQuality(SoundHandle handle, ResamplerQuality quality);
+	virtual void setResamplerQuality(ResamplerQuality quality);
+	virtual ResamplerQuality getResamplerQuality() const;
+
 	virtual uint32 getSoundElapsedTime(SoundHandle handle);
 	virtual Timestamp getElapsedTime(SoundHandle handle);
 
@@ -136,9 +290,44 @@ public:
 	virtual bool getOutputStereo() const;
 	virtual uint getOutputBufSize() const;
 
+	virtual void getStats(MixerStats &mixerStats, Common::Array<ChannelStats> &channelStats);
+	virtual void resetStats();
+
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
 
+	/** Queue a command for the audio thread. Requires _queueMutex. */
+	void queueCommand(Command::Type type, int index, uint32 handle, int value = 0, Channel *channel = nullptr);
+	/** Move overflowed commands into the ring, as far as they fit. Requires _queueMutex. */
+	void flushOverflowCommands();
+	/** Apply the queued commands. Only called by the audio thread. */
+	void processCommands();
+	/** Hand a channel back for deletion. Only called by the audio thread. */
+	void retireChannel(int index);
+	/** Update the snapshot of the channels. Only called by the audio thread. */
+	void publishSnapshot();
+
+	/** Delete the channels the audio thread is done with. Requires _queueMutex. */
+	void deleteRetiredChannels();
+	/**
+	 * Mark channels which ended on their own as inactive, and delete the
+	 * channels the audio thread is done with. Requires _queueMutex.
+	 */
+	void updateChannelStates();
+	/** Get the state of an active channel, or nullptr. Requires _queueMutex. */
+	ChannelState *findChannelState(SoundHandle handle);
+	/**
+	 * Mark a channel as stopped, so the audio thread doesn't read its stream
+	 * anymore and removes it. Requires _queueMutex.
+	 */
+	void stopChannel(int index);
+	/**
+	 * Wait until the audio thread is not mixing a stopped channel anymore.
+	 * Must not be called with _queueMutex held.
+	 */
+	void waitForStoppedChannel(int index);
+	void pauseChannel(int index, bool paused);
+
 public:
 	/**
 	 * The mixer callback function, to be called at regular intervals by
@@ -0,0 +1,107 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#include "audio/mixer_kernels.h"
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace Audio {
+
+// Divide by Mixer::kMaxMixerVolume, rounding towards zero
+static FORCEINLINE __m256i avx2_scale(__m256i prod) {
+	__m256i bias = _mm256_and_si256(_mm256_srai_epi32(prod, 31), _mm256_set1_epi32(Mixer::kMaxMixerVolume - 1));
+	return _mm256_srai_epi32(_mm256_add_epi32(prod, bias), 8);
+}
+
+void MixerKernels::accumulateAVX2(int32 *dst, const st_sample_t *src, uint numFrames, st_volume_t volL, st_volume_t volR) {
+	const __m256i vol = _mm256_set_epi32(volR, volL, volR, volL, volR, volL, volR, volL);
+
+	// Four stereo frames per iteration, widened to 32 bits before multiplying
+	uint i = 0;
+	for (; i + 4 <= numFrames; i += 4) {
+		__m256i in = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)src));
+		__m256i out = _mm256_loadu_si256((const __m256i *)dst);
+		out = _mm256_add_epi32(out, avx2_scale(_mm256_mullo_epi32(in, vol)));
+		_mm256_storeu_si256((__m256i *)dst, out);
+
+		src += 8;
+		dst += 8;
+	}
+
+	for (; i < numFrames; i++) {
+		dst[0] += scaleSample(src[0], volL);
+		dst[1] += scaleSample(src[1], volR);
+		dst += 2;
+		src += 2;
+	}
+}
+
+void MixerKernels::clampAVX2(st_sample_t *dst, const int32 *src, uint numSamples) {
+	uint i = 0;
+	for (; i + 16 <= numSamples; i += 16) {
+		__m256i in0 = _mm256_loadu_si256((const __m256i *)src);
+		__m256i in1 = _mm256_loadu_si256((const __m256i *)(src + 8));
+		// The pack works per 128-bit lane, so restore the sample order afterwards
+		__m256i out = _mm256_permute4x64_epi64(_mm256_packs_epi32(in0, in1), _MM_SHUFFLE(3, 1, 2, 0));
+#ifdef OUTPUT_UNSIGNED_AUDIO
+		out = _mm256_xor_si256(out, _mm256_set1_epi16((short)0x8000));
+#endif
+		_mm256_storeu_si256((__m256i *)dst, out);
+
+		src += 16;
+		dst += 16;
+	}
+
+	for (; i < numSamples; i++)
+		*dst++ = clampSample(*src++);
+}
+
+int32 MixerKernels::convolveAVX2(const st_sample_t *samples, const int16 *coefs, uint taps) {
+	__m256i sum = _mm256_setzero_si256();
+	for (uint i = 0; i < taps; i += 16) {
+		__m256i in = _mm256_loadu_si256((const __m256i *)(samples + i));
+		__m256i coef = _mm256_loadu_si256((const __m256i *)(coefs + i));
+		sum = _mm256_add_epi32(sum, _mm256_madd_epi16(in, coef));
+	}
+
+	__m128i sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+	sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(sum128);
+}
+
+} // End of namespace Audio
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,115 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#include "audio/mixer_kernels.h"
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("neon"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+
+#endif // !defined(__aarch64__)
+
+namespace Audio {
+
+// Divide by Mixer::kMaxMixerVolume, rounding towards zero
+static inline int32x4_t neon_scale(int32x4_t prod) {
+	int32x4_t bias = vandq_s32(vshrq_n_s32(prod, 31), vdupq_n_s32(Mixer::kMaxMixerVolume - 1));
+	return vshrq_n_s32(vaddq_s32(prod, bias), 8);
+}
+
+void MixerKernels::accumulateNEON(int32 *dst, const st_sample_t *src, uint numFrames, st_volume_t volL, st_volume_t volR) {
+	const int16 volPattern[4] = { (int16)volL, (int16)volR, (int16)volL, (int16)volR };
+	const int16x4_t vol = vld1_s16(volPattern);
+
+	// Four stereo frames per iteration
+	uint i = 0;
+	for (; i + 4 <= numFrames; i += 4) {
+		int16x8_t in = vld1q_s16(src);
+		int32x4_t out0 = vld1q_s32(dst);
+		int32x4_t out1 = vld1q_s32(dst + 4);
+		out0 = vaddq_s32(out0, neon_scale(vmull_s16(vget_low_s16(in), vol)));
+		out1 = vaddq_s32(out1, neon_scale(vmull_s16(vget_high_s16(in), vol)));
+		vst1q_s32(dst, out0);
+		vst1q_s32(dst + 4, out1);
+
+		src += 8;
+		dst += 8;
+	}
+
+	for (; i < numFrames; i++) {
+		dst[0] += scaleSample(src[0], volL);
+		dst[1] += scaleSample(src[1], volR);
+		dst += 2;
+		src += 2;
+	}
+}
+
+void MixerKernels::clampNEON(st_sample_t *dst, const int32 *src, uint numSamples) {
+	uint i = 0;
+	for (; i + 8 <= numSamples; i += 8) {
+		int16x8_t out = vcombine_s16(vqmovn_s32(vld1q_s32(src)), vqmovn_s32(vld1q_s32(src + 4)));
+#ifdef OUTPUT_UNSIGNED_AUDIO
+		out = veorq_s16(out, vdupq_n_s16((int16)0x8000));
+#endif
+		vst1q_s16(dst, out);
+
+		src += 8;
+		dst += 8;
+	}
+
+	for (; i < numSamples; i++)
+		*dst++ = clampSample(*src++);
+}
+
+int32 MixerKernels::convolveNEON(const st_sample_t *samples, const int16 *coefs, uint taps) {
+	int32x4_t sum = vdupq_n_s32(0);
+	for (uint i = 0; i < taps; i += 8) {
+		int16x8_t in = vld1q_s16(samples + i);
+		int16x8_t coef = vld1q_s16(coefs + i);
+		sum = vmlal_s16(sum, vget_low_s16(in), vget_low_s16(coef));
+		sum = vmlal_s16(sum, vget_high_s16(in), vget_high_s16(coef));
+	}
+
+	int32x2_t sum64 = vadd_s32(vget_low_s32(sum), vget_high_s32(sum));
+	return vget_lane_s32(vpadd_s32(sum64, sum64), 0);
+}
+
+} // End of namespace Audio
+
+#if !defined(__aarch64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__aarch64__)
@@ -0,0 +1,119 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#include "audio/mixer_kernels.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace Audio {
+
+// Divide by Mixer::kMaxMixerVolume, rounding towards zero
+static FORCEINLINE __m128i sse2_scale(__m128i prod) {
+	__m128i bias = _mm_and_si128(_mm_srai_epi32(prod, 31), _mm_set1_epi32(Mixer::kMaxMixerVolume - 1));
+	return _mm_srai_epi32(_mm_add_epi32(prod, bias), 8);
+}
+
+void MixerKernels::accumulateSSE2(int32 *dst, const st_sample_t *src, uint numFrames, st_volume_t volL, st_volume_t volR) {
+	const __m128i vol = _mm_set_epi16(volR, volL, volR, volL, volR, volL, volR, volL);
+
+	// Four stereo frames per iteration
+	uint i = 0;
+	for (; i + 4 <= numFrames; i += 4) {
+		__m128i in = _mm_loadu_si128((const __m128i *)src);
+		__m128i lo = _mm_mullo_epi16(in, vol);
+		__m128i hi = _mm_mulhi_epi16(in, vol);
+
+		__m128i out0 = _mm_loadu_si128((const __m128i *)dst);
+		__m128i out1 = _mm_loadu_si128((const __m128i *)(dst + 4));
+		out0 = _mm_add_epi32(out0, sse2_scale(_mm_unpacklo_epi16(lo, hi)));
+		out1 = _mm_add_epi32(out1, sse2_scale(_mm_unpackhi_epi16(lo, hi)));
+		_mm_storeu_si128((__m128i *)dst, out0);
+		_mm_storeu_si128((__m128i *)(dst + 4), out1);
+
+		src += 8;
+		dst += 8;
+	}
+
+	for (; i < numFrames; i++) {
+		dst[0] += scaleSample(src[0], volL);
+		dst[1] += scaleSample(src[1], volR);
+		dst += 2;
+		src += 2;
+	}
+}
+
+void MixerKernels::clampSSE2(st_sample_t *dst, const int32 *src, uint numSamples) {
+	uint i = 0;
+	for (; i + 8 <= numSamples; i += 8) {
+		__m128i in0 = _mm_loadu_si128((const __m128i *)src);
+		__m128i in1 = _mm_loadu_si128((const __m128i *)(src + 4));
+		__m128i out = _mm_packs_epi32(in0, in1);
+#ifdef OUTPUT_UNSIGNED_AUDIO
+		out = _mm_xor_si128(out, _mm_set1_epi16((short)0x8000));
+#endif
+		_mm_storeu_si128((__m128i *)dst, out);
+
+		src += 8;
+		dst += 8;
+	}
+
+	for (; i < numSamples; i++)
+		*dst++ = clampSample(*src++);
+}
+
+int32 MixerKernels::convolveSSE2(const st_sample_t *samples, const int16 *coefs, uint taps) {
+	__m128i sum = _mm_setzero_si128();
+	for (uint i = 0; i < taps; i += 8) {
+		__m128i in = _mm_loadu_si128((const __m128i *)(samples + i));
+		__m128i coef = _mm_loadu_si128((const __m128i *)(coefs + i));
+		sum = _mm_add_epi32(sum, _mm_madd_epi16(in, coef));
+	}
+
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(sum);
+}
+
+} // End of namespace Audio
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
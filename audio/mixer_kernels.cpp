@@ -0,0 +1,108 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/system.h"
+
+#include "audio/mixer_kernels.h"
+
+namespace Audio {
+
+// Initialize these to nullptr; the actual functions are selected on first use
+MixerKernels::AccumulateFunc MixerKernels::accumulateFunc = nullptr;
+MixerKernels::ClampFunc MixerKernels::clampFunc = nullptr;
+MixerKernels::ConvolveFunc MixerKernels::convolveFunc = nullptr;
+
+void MixerKernels::selectFuncs() {
+	accumulateFunc = accumulateGeneric;
+	clampFunc = clampGeneric;
+	convolveFunc = convolveGeneric;
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+		accumulateFunc = accumulateNEON;
+		clampFunc = clampNEON;
+		convolveFunc = convolveNEON;
+	}
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		accumulateFunc = accumulateSSE2;
+		clampFunc = clampSSE2;
+		convolveFunc = convolveSSE2;
+	}
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+		accumulateFunc = accumulateAVX2;
+		clampFunc = clampAVX2;
+		convolveFunc = convolveAVX2;
+	}
+#endif
+}
+
+void MixerKernels::accumulate(int32 *dst, const st_sample_t *src, uint numFrames, st_volume_t volL, st_volume_t volR) {
+	if (!accumulateFunc)
+		selectFuncs();
+
+	accumulateFunc(dst, src, numFrames, volL, volR);
+}
+
+void MixerKernels::clamp(st_sample_t *dst, const int32 *src, uint numSamples) {
+	if (!clampFunc)
+		selectFuncs();
+
+	clampFunc(dst, src, numSamples);
+}
+
+int32 MixerKernels::convolve(const st_sample_t *samples, const int16 *coefs, uint taps) {
+	if (!convolveFunc)
+		selectFuncs();
+
+	return convolveFunc(samples, coefs, taps);
+}
+
+void MixerKernels::clampMono(st_sample_t *dst, const int32 *src, uint numFrames) {
+	for (uint i = 0; i < numFrames; i++)
+		dst[i] = clampSample((src[2 * i] + src[2 * i + 1]) / 2);
+}
+
+void MixerKernels::accumulateGeneric(int32 *dst, const st_sample_t *src, uint numFrames, st_volume_t volL, st_volume_t volR) {
+	for (uint i = 0; i < numFrames; i++) {
+		dst[0] += scaleSample(src[0], volL);
+		dst[1] += scaleSample(src[1], volR);
+		dst += 2;
+		src += 2;
+	}
+}
+
+void MixerKernels::clampGeneric(st_sample_t *dst, const int32 *src, uint numSamples) {
+	for (uint i = 0; i < numSamples; i++)
+		dst[i] = clampSample(src[i]);
+}
+
+int32 MixerKernels::convolveGeneric(const st_sample_t *samples, const int16 *coefs, uint taps) {
+	int32 sum = 0;
+	for (uint i = 0; i < taps; i++)
+		sum += samples[i] * coefs[i];
+	return sum;
+}
+
+} // End of namespace Audio
@@ -0,0 +1,160 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef AUDIO_MIXER_KERNELS_H
+#define AUDIO_MIXER_KERNELS_H
+
+#include "common/scummsys.h"
+#include "audio/mixer.h"
+#include "audio/rate.h"
+
+class MixerKernelsTestSuite;
+class MixerTestSuite;
+class PolyphaseRateConverterTestSuite;
+
+namespace Audio {
+
+/**
+ * @defgroup audio_mixer_kernels Mixer kernels
+ * @ingroup audio
+ *
+ * @brief Block kernels used by the default mixer implementation.
+ * @{
+ */
+
+/**
+ * Block kernels used by MixerImpl to mix all channels of a callback.
+ *
+ * Every channel is first converted into an unscaled block of stereo
+ * frames (see RateConverter::convertBlock). The channel volume is then
+ * applied to the whole block, which is summed into a 32-bit accumulator.
+ * Only once all channels have been accumulated is the result clamped
+ * down to 16-bit samples.
+ *
+ * The SIMD variants are selected at runtime, depending on the features
+ * reported by OSystem::hasFeature().
+ */
+class MixerKernels {
+public:
+	/**
+	 * Apply the volume to a block of stereo frames and add it to an accumulator.
+	 *
+	 * @param dst       Accumulator, holding 2 * @p numFrames values.
+	 * @param src       Interleaved stereo frames, holding 2 * @p numFrames samples.
+	 * @param numFrames Number of sample pairs to process.
+	 * @param volL      Volume for left channel, in the range 0 - Mixer::kMaxMixerVolume.
+	 * @param volR      Volume for right channel, in the range 0 - Mixer::kMaxMixerVolume.
+	 */
+	static void accumulate(int32 *dst, const st_sample_t *src, uint numFrames, st_volume_t volL, st_volume_t volR);
+
+	/**
+	 * Clamp an accumulator to 16-bit samples.
+	 *
+	 * @param dst        Output samples.
+	 * @param src        Accumulator.
+	 * @param numSamples Number of samples (not sample pairs) to process.
+	 */
+	static void clamp(st_sample_t *dst, const int32 *src, uint numSamples);
+
+	/**
+	 * Downmix a stereo accumulator to mono and clamp it to 16-bit samples.
+	 *
+	 * @param dst       Output samples, holding @p numFrames samples.
+	 * @param src       Accumulator, holding 2 * @p numFrames values.
+	 * @param numFrames Number of sample pairs to process.
+	 */
+	static void clampMono(st_sample_t *dst, const int32 *src, uint numFrames);
+
+	/**
+	 * Compute the dot product of a run of samples with a set of filter
+	 * coefficients, as used by the polyphase rate converter.
+	 *
+	 * @param samples Input samples.
+	 * @param coefs   Filter coefficients.
+	 * @param taps    Number of samples and coefficients, must be a multiple of 16.
+	 * @return The sum of the products, without any scaling.
+	 */
+	static int32 convolve(const st_sample_t *samples, const int16 *coefs, uint taps);
+
+private:
+	typedef void(*AccumulateFunc)(int32 *, const st_sample_t *, uint, st_volume_t, st_volume_t);
+	typedef void(*ClampFunc)(st_sample_t *, const int32 *, uint);
+	typedef int32(*ConvolveFunc)(const st_sample_t *, const int16 *, uint);
+
+	static void selectFuncs();
+
+	static void accumulateGeneric(int32 *dst, const st_sample_t *src, uint numFrames, st_volume_t volL, st_volume_t volR);
+	static void clampGeneric(st_sample_t *dst, const int32 *src, uint numSamples);
+	static int32 convolveGeneric(const st_sample_t *samples, const int16 *coefs, uint taps);
+#ifdef SCUMMVM_NEON
+	static void accumulateNEON(int32 *dst, const st_sample_t *src, uint numFrames, st_volume_t volL, st_volume_t volR);
+	static void clampNEON(st_sample_t *dst, const int32 *src, uint numSamples);
+	static int32 convolveNEON(const st_sample_t *samples, const int16 *coefs, uint taps);
+#endif
+#ifdef SCUMMVM_SSE2
+	static void accumulateSSE2(int32 *dst, const st_sample_t *src, uint numFrames, st_volume_t volL, st_volume_t volR);
+	static void clampSSE2(st_sample_t *dst, const int32 *src, uint numSamples);
+	static int32 convolveSSE2(const st_sample_t *samples, const int16 *coefs, uint taps);
+#endif
+#ifdef SCUMMVM_AVX2
+	static void accumulateAVX2(int32 *dst, const st_sample_t *src, uint numFrames, st_volume_t volL, st_volume_t volR);
+	static void clampAVX2(st_sample_t *dst, const int32 *src, uint numSamples);
+	static int32 convolveAVX2(const st_sample_t *samples, const int16 *coefs, uint taps);
+#endif
+
+	static AccumulateFunc accumulateFunc;
+	static ClampFunc clampFunc;
+	static ConvolveFunc convolveFunc;
+
+	friend class ::MixerKernelsTestSuite;
+	friend class ::MixerTestSuite;
+	friend class ::PolyphaseRateConverterTestSuite;
+};
+
+/**
+ * Scale a single sample by a mixer volume, rounding towards zero like
+ * the RateConverter does.
+ */
+static inline int32 scaleSample(int32 sample, st_volume_t vol) {
+	return (sample * (int32)vol) / Mixer::kMaxMixerVolume;
+}
+
+/**
+ * Clamp a single accumulated value to the output sample range.
+ */
+static inline st_sample_t clampSample(int32 val) {
+	if (val > ST_SAMPLE_MAX)
+		val = ST_SAMPLE_MAX;
+	else if (val < ST_SAMPLE_MIN)
+		val = ST_SAMPLE_MIN;
+
+#ifdef OUTPUT_UNSIGNED_AUDIO
+	return ((st_sample_t)val) ^ 0x8000;
+#else
+	return val;
+#endif
+}
+
+/** @} */
+} // End of namespace Audio
+
+#endif
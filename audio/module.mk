@@ -19,11 +19,13 @@ MODULE_OBJS := \
 	miles_adlib.o \
 	miles_midi.o \
 	mixer.o \
+	mixer_kernels.o \
 	mpu401.o \
 	mt32gm.o \
 	musicplugin.o \
 	null.o \
 	rate.o \
+	rate_polyphase.o \
 	timestamp.o \
 	decoders/3do.o \
 	decoders/aac.o \
@@ -112,5 +114,18 @@ MODULE_OBJS += \
 	rwopl3.o
 endif
 
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	mixer_kernels-neon.o
+endif
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	mixer_kernels-sse2.o
+endif
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	mixer_kernels-avx2.o
+endif
+
 # Include common rules
 include $(srcdir)/rules.mk
@@ -29,6 +29,7 @@
 
 #include "audio/audiostream.h"
 #include "audio/rate.h"
+#include "audio/rate_polyphase.h"
 #include "audio/mixer.h"
 #include "common/util.h"
 
@@ -76,15 +77,25 @@ private:
 	/** Current sample(s) in the input stream (left/right channel) */
 	st_sample_t _inCurL, _inCurR;
 
+	template<bool blockOut>
 	int copyConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
+	template<bool blockOut>
 	int simpleConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
+	template<bool blockOut>
 	int interpolateConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
 
+	template<bool blockOut>
+	int convertImpl(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
+
+	template<bool blockOut>
+	static inline void writeSample(st_sample_t *&outBuffer, st_sample_t inL, st_sample_t inR, st_volume_t volL, st_volume_t volR);
+
 public:
 	RateConverter_Impl(st_rate_t inputRate, st_rate_t outputRate);
 	virtual ~RateConverter_Impl() {}
 
 	int convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r) override;
+	int convertBlock(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples) override;
 
 	void setInputRate(st_rate_t inputRate) override { _inRate = inputRate; }
 	void setOutputRate(st_rate_t outputRate) override { _outRate = outputRate; }
@@ -96,11 +107,13 @@ public:
 };
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
+template<bool blockOut>
 int RateConverter_Impl<inStereo, outStereo, reverseStereo>::copyConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+	const int outStep = (blockOut || outStereo) ? 2 : 1;
 	st_sample_t *outStart, *outEnd;
 
 	outStart = outBuffer;
-	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
+	outEnd = outBuffer + numSamples * outStep;
 
 	while (outBuffer < outEnd) {
 		// Check if we have to refill the buffer
@@ -109,7 +122,7 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::copyConvert(AudioStr
 			_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
 
 			if (_bufferSize <= 0)
-				return (outBuffer - outStart) / (outStereo ? 2 : 1);
+				return (outBuffer - outStart) / outStep;
 		}
 
 		// Mix the data into the output buffer
@@ -118,38 +131,23 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::copyConvert(AudioStr
 		inR = (inStereo ? *_bufferPos++ : inL);
 		_bufferSize -= (inStereo ? 2 : 1);
 
-		st_sample_t outL, outR;
-		outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-		outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
-
-		if (outStereo) {
-			// Output left channel
-			clampedAdd(outBuffer[reverseStereo    ], outL);
-
-			// Output right channel
-			clampedAdd(outBuffer[reverseStereo ^ 1], outR);
-
-			outBuffer += 2;
-		} else {
-			// Output mono channel
-			clampedAdd(outBuffer[0], (outL + outR) / 2);
-
-			outBuffer += 1;
-		}
+		writeSample<blockOut>(outBuffer, inL, inR, volL, volR);
 	}
 
-	return (outBuffer - outStart) / (outStereo ? 2 : 1);
+	return (outBuffer - outStart) / outStep;
 }
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
+template<bool blockOut>
 int RateConverter_Impl<inStereo, outStereo, reverseStereo>::simpleConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
 	// How much to increment _outPos by
 	frac_t outPos_inc = _inRate / _outRate;
 
+	const int outStep = (blockOut || outStereo) ? 2 : 1;
 	st_sample_t *outStart, *outEnd;
 
 	outStart = outBuffer;
-	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
+	outEnd = outBuffer + numSamples * outStep;
 
 	while (outBuffer < outEnd) {
 		// Read enough input samples so that _outPos >= 0
@@ -160,7 +158,7 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::simpleConvert(AudioS
 				_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
 
 				if (_bufferSize <= 0)
-					return (outBuffer - outStart) / (outStereo ? 2 : 1);
+					return (outBuffer - outStart) / outStep;
 			}
 
 			_bufferSize -= (inStereo ? 2 : 1);
@@ -178,36 +176,21 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::simpleConvert(AudioS
 		// Increment output position
 		_outPos += outPos_inc;
 
-		st_sample_t outL, outR;
-		outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-		outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
-
-		if (outStereo) {
-			// output left channel
-			clampedAdd(outBuffer[reverseStereo    ], outL);
-
-			// output right channel
-			clampedAdd(outBuffer[reverseStereo ^ 1], outR);
-
-			outBuffer += 2;
-		} else {
-			// output mono channel
-			clampedAdd(outBuffer[0], (outL + outR) / 2);
-
-			outBuffer += 1;
-		}
+		writeSample<blockOut>(outBuffer, inL, inR, volL, volR);
 	}
-	return (outBuffer - outStart) / (outStereo ? 2 : 1);
+	return (outBuffer - outStart) / outStep;
 }
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
+template<bool blockOut>
 int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
 	// How much to increment _outPosFrac by
 	frac_t outPos_inc = (_inRate << FRAC_BITS_LOW) / _outRate;
 
+	const int outStep = (blockOut || outStereo) ? 2 : 1;
 	st_sample_t *outStart, *outEnd;
 	outStart = outBuffer;
-	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
+	outEnd = outBuffer + numSamples * outStep;
 
 	while (outBuffer < outEnd) {
 		// Read enough input samples so that _outPosFrac < 0
@@ -218,7 +201,7 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(A
 				_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
 
 				if (_bufferSize <= 0)
-					return (outBuffer - outStart) / (outStereo ? 2 : 1);
+					return (outBuffer - outStart) / outStep;
 			}
 
 			_bufferSize -= (inStereo ? 2 : 1);
@@ -243,30 +226,46 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(A
 						(st_sample_t)(_inLastR + (((_inCurR - _inLastR) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
 						inL);
 
-			st_sample_t outL, outR;
-			outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-			outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
+			writeSample<blockOut>(outBuffer, inL, inR, volL, volR);
 
-			if (outStereo) {
-				// Output left channel
-				clampedAdd(outBuffer[reverseStereo    ], outL);
+			// Increment output position
+			_outPosFrac += outPos_inc;
+		}
+	}
+	return (outBuffer - outStart) / outStep;
+}
 
-				// Output right channel
-				clampedAdd(outBuffer[reverseStereo ^ 1], outR);
+template<bool inStereo, bool outStereo, bool reverseStereo>
+template<bool blockOut>
+inline void RateConverter_Impl<inStereo, outStereo, reverseStereo>::writeSample(st_sample_t *&outBuffer, st_sample_t inL, st_sample_t inR, st_volume_t volL, st_volume_t volR) {
+	if (blockOut) {
+		// Block output is always an unscaled stereo frame which overwrites
+		// the buffer. Volume and clamping are applied later by the mixer.
+		outBuffer[reverseStereo    ] = inL;
+		outBuffer[reverseStereo ^ 1] = inR;
+
+		outBuffer += 2;
+		return;
+	}
 
-				outBuffer += 2;
-			} else {
-				// Output mono channel
-				clampedAdd(outBuffer[0], (outL + outR) / 2);
+	st_sample_t outL, outR;
+	outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
+	outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
 
-				outBuffer += 1;
-			}
+	if (outStereo) {
+		// Output left channel
+		clampedAdd(outBuffer[reverseStereo    ], outL);
 
-			// Increment output position
-			_outPosFrac += outPos_inc;
-		}
+		// Output right channel
+		clampedAdd(outBuffer[reverseStereo ^ 1], outR);
+
+		outBuffer += 2;
+	} else {
+		// Output mono channel
+		clampedAdd(outBuffer[0], (outL + outR) / 2);
+
+		outBuffer += 1;
 	}
-	return (outBuffer - outStart) / (outStereo ? 2 : 1);
 }
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
@@ -283,21 +282,35 @@ RateConverter_Impl<inStereo, outStereo, reverseStereo>::RateConverter_Impl(st_ra
 	_bufferPos(nullptr) {}
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
-int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+template<bool blockOut>
+int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convertImpl(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
 	assert(input.isStereo() == inStereo);
 
 	if (_inRate == _outRate) {
-		return copyConvert(input, outBuffer, numSamples, volL, volR);
+		return copyConvert<blockOut>(input, outBuffer, numSamples, volL, volR);
 	} else {
 		if ((_inRate % _outRate) == 0 && (_inRate < 65536)) {
-			return simpleConvert(input, outBuffer, numSamples, volL, volR);
+			return simpleConvert<blockOut>(input, outBuffer, numSamples, volL, volR);
 		} else {
-			return interpolateConvert(input, outBuffer, numSamples, volL, volR);
+			return interpolateConvert<blockOut>(input, outBuffer, numSamples, volL, volR);
 		}
 	}
 }
 
-RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo) {
+template<bool inStereo, bool outStereo, bool reverseStereo>
+int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+	return convertImpl<false>(input, outBuffer, numSamples, volL, volR);
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convertBlock(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples) {
+	return convertImpl<true>(input, outBuffer, numSamples, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+}
+
+RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo, Mixer::ResamplerQuality quality) {
+	if (quality == Mixer::kResamplerPolyphase && inRate != outRate)
+		return makePolyphaseRateConverter(inRate, outRate, inStereo, outStereo, reverseStereo);
+
 	if (inStereo) {
 		if (outStereo) {
 			if (reverseStereo)
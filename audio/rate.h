@@ -23,6 +23,7 @@
 #define AUDIO_RATE_H
 
 #include "common/frac.h"
+#include "audio/mixer.h"
 
 namespace Audio {
 /**
@@ -90,6 +91,23 @@ public:
 	 */
 	virtual int convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r) = 0;
 
+	/**
+	 * Convert the provided AudioStream to the target sample rate, without
+	 * applying any volume and without mixing.
+	 *
+	 * The output is always written as interleaved stereo frames, regardless
+	 * of the output channel count the converter was created with, and
+	 * overwrites the contents of @p outBuffer. This is meant for block-based
+	 * mixing, where volume is applied to the whole block at once.
+	 *
+	 * @param input			The AudioStream to read data from.
+	 * @param outBuffer		The buffer that the resampled audio will be written to. Must have size of at least 2 * @p numSamples.
+	 * @param numSamples	The desired number of sample pairs to be written into the buffer.
+	 *
+	 * @return Number of sample pairs written into the buffer.
+	 */
+	virtual int convertBlock(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples) = 0;
+
 	virtual void setInputRate(st_rate_t inputRate) = 0;
 	virtual void setOutputRate(st_rate_t outputRate) = 0;
 
@@ -104,7 +122,16 @@ public:
 	virtual bool needsDraining() const = 0;
 };
 
-RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo);
+/**
+ * Create a rate converter.
+ *
+ * With kResamplerPolyphase, a windowed-sinc polyphase filter is used for
+ * streams that need resampling. Its filter banks are shared by all
+ * converters using the same rates. Streams already at the output rate
+ * always get the plain copy converter.
+ */
+RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo,
+								 Mixer::ResamplerQuality quality = Mixer::kResamplerLinear);
 
 /** @} */
 } // End of namespace Audio
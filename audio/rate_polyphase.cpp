@@ -0,0 +1,470 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/util.h"
+
+#include "audio/audiostream.h"
+#include "audio/mixer.h"
+#include "audio/mixer_kernels.h"
+#include "audio/rate_polyphase.h"
+
+namespace Common {
+DECLARE_SINGLETON(Audio::PolyphaseFilterCache);
+}
+
+namespace Audio {
+
+enum {
+	COEF_BITS = 14,
+	COEF_ONE = (1 << COEF_BITS)
+};
+
+static uint32 greatestCommonDivisor(uint32 a, uint32 b) {
+	while (b) {
+		uint32 t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+PolyphaseFilter::PolyphaseFilter(st_rate_t inputRate, st_rate_t outputRate) :
+	inRate(inputRate), outRate(outputRate), coefs(nullptr), refCount(0) {
+	assert(inputRate > 0 && outputRate > 0);
+
+	const uint32 gcd = greatestCommonDivisor(inRate, outRate);
+	if (outRate / gcd <= kMaxPhases) {
+		phases = outRate / gcd;
+		denominator = phases;
+		phaseDivisor = 1;
+		increment = inRate / gcd;
+	} else {
+		phases = kInexactPhases;
+		denominator = 1 << 16;
+		phaseDivisor = denominator / phases;
+		increment = (uint32)(((uint64)inRate << 16) / outRate);
+	}
+
+	// When downsampling, the cutoff has to move below the output Nyquist
+	// frequency, and the filter has to grow accordingly to keep its quality
+	double cutoff = 0.95;
+	taps = kBaseTaps;
+	if (outRate < inRate) {
+		cutoff *= (double)outRate / inRate;
+		taps = (uint)ceil(kBaseTaps * (double)inRate / outRate);
+		taps = MIN<uint>((taps + 15) & ~15, kMaxTaps);
+	}
+
+	coefs = new int16[phases * taps];
+
+	const int center = taps / 2 - 1;
+	const double halfWidth = taps / 2.0;
+	double *window = new double[taps];
+
+	for (uint phase = 0; phase < phases; phase++) {
+		const double offset = (double)phase / phases;
+		double sum = 0.0;
+
+		for (uint i = 0; i < taps; i++) {
+			// Distance between the input sample and the output position
+			const double x = (double)((int)i - center) - offset;
+			const double sincX = cutoff * x * M_PI;
+			const double sinc = (x == 0.0) ? cutoff : cutoff * sin(sincX) / sincX;
+			// Blackman window
+			const double w = 0.42 + 0.5 * cos(M_PI * x / halfWidth) + 0.08 * cos(2.0 * M_PI * x / halfWidth);
+
+			window[i] = (fabs(x) >= halfWidth) ? 0.0 : sinc * w;
+			sum += window[i];
+		}
+
+		// Normalize every phase to unity gain, and put any rounding error
+		// into the largest tap so the sum is exact
+		int16 *phaseCoefs = coefs + phase * taps;
+		int total = 0;
+		uint largest = 0;
+		for (uint i = 0; i < taps; i++) {
+			phaseCoefs[i] = (int16)floor(window[i] / sum * COEF_ONE + 0.5);
+			total += phaseCoefs[i];
+			if (ABS(phaseCoefs[i]) > ABS(phaseCoefs[largest]))
+				largest = i;
+		}
+		phaseCoefs[largest] += COEF_ONE - total;
+	}
+
+	delete[] window;
+}
+
+PolyphaseFilter::~PolyphaseFilter() {
+	delete[] coefs;
+}
+
+struct PolyphaseFilterCache::BuildTask {
+	PolyphaseFilterCache *cache;
+	st_rate_t inRate, outRate;
+
+	void operator()() const {
+		cache->addFilter(new PolyphaseFilter(inRate, outRate));
+	}
+};
+
+PolyphaseFilterCache::PolyphaseFilterCache() : _builder(new Common::ThreadPool(1)) {
+}
+
+PolyphaseFilterCache::~PolyphaseFilterCache() {
+	// Wait for the filter banks still being computed
+	delete _builder;
+
+	for (uint i = 0; i < _filters.size(); i++)
+		delete _filters[i];
+}
+
+const PolyphaseFilter *PolyphaseFilterCache::acquire(st_rate_t inRate, st_rate_t outRate) {
+	{
+		Common::StackLock lock(_mutex);
+
+		for (uint i = 0; i < _filters.size(); i++) {
+			if (_filters[i]->inRate == inRate && _filters[i]->outRate == outRate) {
+				_filters[i]->refCount++;
+				return _filters[i];
+			}
+		}
+
+		for (uint i = 0; i < _pending.size(); i++) {
+			if (_pending[i].inRate == inRate && _pending[i].outRate == outRate)
+				return nullptr;
+		}
+
+		RatePair rates = { inRate, outRate };
+		_pending.push_back(rates);
+	}
+
+	BuildTask task = { this, inRate, outRate };
+	_builder->submit(task);
+
+	// Without worker threads, the filter bank is there already
+	if (!_builder->getThreadCount())
+		return acquire(inRate, outRate);
+	return nullptr;
+}
+
+void PolyphaseFilterCache::addFilter(PolyphaseFilter *filter) {
+	Common::StackLock lock(_mutex);
+
+	for (uint i = 0; i < _pending.size(); i++) {
+		if (_pending[i].inRate == filter->inRate && _pending[i].outRate == filter->outRate) {
+			_pending.remove_at(i);
+			break;
+		}
+	}
+
+	// Drop the oldest unused filter banks before adding a new one
+	uint unused = 0;
+	for (uint i = 0; i < _filters.size(); i++) {
+		if (_filters[i]->refCount == 0)
+			unused++;
+	}
+	for (uint i = 0; i < _filters.size() && unused >= kMaxUnusedFilters; ) {
+		if (_filters[i]->refCount == 0) {
+			delete _filters[i];
+			_filters.remove_at(i);
+			unused--;
+		} else {
+			i++;
+		}
+	}
+
+	_filters.push_back(filter);
+}
+
+void PolyphaseFilterCache::release(const PolyphaseFilter *filter) {
+	if (!filter)
+		return;
+
+	Common::StackLock lock(_mutex);
+
+	for (uint i = 0; i < _filters.size(); i++) {
+		if (_filters[i] == filter) {
+			assert(_filters[i]->refCount > 0);
+			_filters[i]->refCount--;
+			return;
+		}
+	}
+}
+
+/**
+ * Rate converter based on a windowed-sinc polyphase filter bank.
+ *
+ * The input is kept deinterleaved, so both channels can be convolved
+ * with the same (SIMD) kernel. Until the filter bank for the current rates
+ * has been computed, the history is interpolated linearly instead.
+ */
+template<bool inStereo, bool outStereo, bool reverseStereo>
+class RateConverter_Polyphase : public RateConverter {
+private:
+	enum {
+		/** Input frames read from the stream at once */
+		kChunkSize = 256,
+		kHistorySize = PolyphaseFilter::kMaxTaps + kChunkSize,
+		/** Denominator of the position fraction while interpolating linearly */
+		kLinearDenominator = 1 << 16
+	};
+
+	/** Input and output rates */
+	st_rate_t _inRate, _outRate;
+
+	/** The filter bank for the current rates, nullptr while it is computed */
+	const PolyphaseFilter *_filter;
+
+	/** Deinterleaved input history (left/right channel) */
+	st_sample_t _histL[kHistorySize], _histR[kHistorySize];
+
+	/** Interleaved buffer the stream is read into */
+	st_sample_t _readBuffer[kChunkSize * 2];
+
+	/** Index of the first input frame used for the next output frame */
+	uint _histPos;
+
+	/** Number of input frames in the history */
+	uint _histSize;
+
+	/** Fractional part of the output position, in units of 1 / _denominator */
+	uint32 _frac;
+	uint32 _denominator;
+
+	/** Whether silence has been appended to the history at the end of the stream */
+	bool _flushed;
+
+	/** Number of history frames each output frame is computed from */
+	uint getTaps() const { return _filter ? _filter->taps : (uint)PolyphaseFilter::kBaseTaps; }
+
+	void updateFilter();
+	bool fillHistory(AudioStream &input);
+
+	template<bool blockOut>
+	int convertImpl(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR);
+
+public:
+	RateConverter_Polyphase(st_rate_t inputRate, st_rate_t outputRate);
+	~RateConverter_Polyphase();
+
+	int convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) override {
+		return convertImpl<false>(input, outBuffer, numSamples, volL, volR);
+	}
+
+	int convertBlock(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples) override {
+		return convertImpl<true>(input, outBuffer, numSamples, Mixer::kMaxMixerVolume, Mixer::kMaxMixerVolume);
+	}
+
+	void setInputRate(st_rate_t inputRate) override { _inRate = inputRate; }
+	void setOutputRate(st_rate_t outputRate) override { _outRate = outputRate; }
+
+	st_rate_t getInputRate() const override { return _inRate; }
+	st_rate_t getOutputRate() const override { return _outRate; }
+
+	bool needsDraining() const override { return !_flushed || _histSize >= _histPos + getTaps(); }
+};
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+RateConverter_Polyphase<inStereo, outStereo, reverseStereo>::RateConverter_Polyphase(st_rate_t inputRate, st_rate_t outputRate) :
+	_inRate(inputRate),
+	_outRate(outputRate),
+	_filter(nullptr),
+	_histPos(0),
+	_histSize(0),
+	_frac(0),
+	_denominator(kLinearDenominator),
+	_flushed(false) {
+	updateFilter();
+
+	// Start with silence before the first input frame, so the first output
+	// frame is centered on it
+	_histSize = getTaps() / 2 - 1;
+	memset(_histL, 0, sizeof(_histL));
+	memset(_histR, 0, sizeof(_histR));
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+RateConverter_Polyphase<inStereo, outStereo, reverseStereo>::~RateConverter_Polyphase() {
+	PolyphaseFilterCache::instance().release(_filter);
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+void RateConverter_Polyphase<inStereo, outStereo, reverseStereo>::updateFilter() {
+	if (_filter && _filter->inRate == _inRate && _filter->outRate == _outRate)
+		return;
+
+	// This is called on the audio thread, so it never waits for a filter
+	// bank to be computed
+	const PolyphaseFilter *filter = PolyphaseFilterCache::instance().acquire(_inRate, _outRate);
+	PolyphaseFilterCache::instance().release(_filter);
+
+	// Keep the output position when the filter bank changes, so rate
+	// changes in the middle of a stream do not cause a jump
+	const uint32 denominator = filter ? filter->denominator : (uint32)kLinearDenominator;
+	_frac = (uint32)(((uint64)_frac * denominator) / _denominator);
+	_denominator = denominator;
+	_filter = filter;
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+bool RateConverter_Polyphase<inStereo, outStereo, reverseStereo>::fillHistory(AudioStream &input) {
+	// Move the frames still needed to the start of the history. When
+	// downsampling, the position may already be past the end of it, in
+	// which case the frames in between are skipped.
+	if (_histPos >= _histSize) {
+		_histPos -= _histSize;
+		_histSize = 0;
+	} else if (_histPos > 0) {
+		const uint remaining = _histSize - _histPos;
+		memmove(_histL, _histL + _histPos, remaining * sizeof(st_sample_t));
+		if (inStereo)
+			memmove(_histR, _histR + _histPos, remaining * sizeof(st_sample_t));
+		_histSize = remaining;
+		_histPos = 0;
+	}
+
+	const uint space = MIN<uint>(kHistorySize - _histSize, kChunkSize);
+	const int read = input.readBuffer(_readBuffer, space * (inStereo ? 2 : 1));
+	if (read <= 0) {
+		// The last input frames are only output once the frames after them
+		// are in the history, so flush them out with silence at the end of
+		// the stream
+		if (_flushed || !input.endOfStream())
+			return false;
+
+		const uint padding = getTaps() / 2;
+		assert(_histSize + padding <= kHistorySize);
+		memset(_histL + _histSize, 0, padding * sizeof(st_sample_t));
+		if (inStereo)
+			memset(_histR + _histSize, 0, padding * sizeof(st_sample_t));
+		_histSize += padding;
+		_flushed = true;
+		return true;
+	}
+
+	// The stream may continue after the end, e.g. when it has been rewound
+	_flushed = false;
+
+	const st_sample_t *in = _readBuffer;
+	if (inStereo) {
+		for (int i = 0; i < read / 2; i++) {
+			_histL[_histSize] = *in++;
+			_histR[_histSize] = *in++;
+			_histSize++;
+		}
+	} else {
+		memcpy(_histL + _histSize, in, read * sizeof(st_sample_t));
+		_histSize += read;
+	}
+
+	return true;
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+template<bool blockOut>
+int RateConverter_Polyphase<inStereo, outStereo, reverseStereo>::convertImpl(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+	assert(input.isStereo() == inStereo);
+
+	updateFilter();
+
+	const uint taps = getTaps();
+	const uint32 denominator = _denominator;
+	const uint32 increment = _filter ? _filter->increment : (uint32)(((uint64)_inRate << 16) / _outRate);
+	const uint32 stepInt = increment / denominator;
+	const uint32 stepFrac = increment % denominator;
+
+	const int outStep = (blockOut || outStereo) ? 2 : 1;
+	st_sample_t *outStart = outBuffer;
+	st_sample_t *outEnd = outBuffer + numSamples * outStep;
+
+	while (outBuffer < outEnd) {
+		// Make sure all the taps for the next output frame are available
+		while (_histPos + taps > _histSize) {
+			if (!fillHistory(input))
+				return (outBuffer - outStart) / outStep;
+		}
+
+		st_sample_t inL, inR;
+		if (_filter) {
+			const int16 *coefs = _filter->getCoefs(_frac);
+			const int32 accL = MixerKernels::convolve(_histL + _histPos, coefs, taps);
+			const int32 accR = inStereo ? MixerKernels::convolve(_histR + _histPos, coefs, taps) : accL;
+
+			inL = (st_sample_t)CLIP<int32>((accL + (COEF_ONE >> 1)) >> COEF_BITS, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+			inR = inStereo ? (st_sample_t)CLIP<int32>((accR + (COEF_ONE >> 1)) >> COEF_BITS, ST_SAMPLE_MIN, ST_SAMPLE_MAX) : inL;
+		} else {
+			// Interpolate between the frame the filter would be centered
+			// on and the next one
+			const uint center = _histPos + taps / 2 - 1;
+			inL = (st_sample_t)(_histL[center] + (((int64)(_histL[center + 1] - _histL[center]) * _frac) >> 16));
+			inR = inStereo ? (st_sample_t)(_histR[center] + (((int64)(_histR[center + 1] - _histR[center]) * _frac) >> 16)) : inL;
+		}
+
+		if (blockOut) {
+			outBuffer[reverseStereo    ] = inL;
+			outBuffer[reverseStereo ^ 1] = inR;
+			outBuffer += 2;
+		} else {
+			st_sample_t outL, outR;
+			outL = (inL * (int)volL) / Mixer::kMaxMixerVolume;
+			outR = (inR * (int)volR) / Mixer::kMaxMixerVolume;
+
+			if (outStereo) {
+				clampedAdd(outBuffer[reverseStereo    ], outL);
+				clampedAdd(outBuffer[reverseStereo ^ 1], outR);
+				outBuffer += 2;
+			} else {
+				clampedAdd(outBuffer[0], (outL + outR) / 2);
+				outBuffer += 1;
+			}
+		}
+
+		// Advance the output position
+		_histPos += stepInt;
+		_frac += stepFrac;
+		if (_frac >= denominator) {
+			_frac -= denominator;
+			_histPos++;
+		}
+	}
+
+	return (outBuffer - outStart) / outStep;
+}
+
+RateConverter *makePolyphaseRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo) {
+	if (inStereo) {
+		if (outStereo) {
+			if (reverseStereo)
+				return new RateConverter_Polyphase<true, true, true>(inRate, outRate);
+			else
+				return new RateConverter_Polyphase<true, true, false>(inRate, outRate);
+		} else
+			return new RateConverter_Polyphase<true, false, false>(inRate, outRate);
+	} else {
+		if (outStereo) {
+			return new RateConverter_Polyphase<false, true, false>(inRate, outRate);
+		} else
+			return new RateConverter_Polyphase<false, false, false>(inRate, outRate);
+	}
+}
+
+} // End of namespace Audio
@@ -0,0 +1,143 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef AUDIO_RATE_POLYPHASE_H
+#define AUDIO_RATE_POLYPHASE_H
+
+#include "common/array.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
+#include "common/threadpool.h"
+
+#include "audio/rate.h"
+
+namespace Audio {
+
+/**
+ * @defgroup audio_rate_polyphase Polyphase rate conversion
+ * @ingroup audio
+ *
+ * @brief Windowed-sinc polyphase filters used by the high quality rate converter.
+ * @{
+ */
+
+/**
+ * Precomputed windowed-sinc filter bank for one input/output rate pair.
+ *
+ * The output position is tracked as an integer input position plus a
+ * fraction in the range 0 - denominator. For rate pairs with a small
+ * enough reduced ratio, the fraction is exact and every phase has its own
+ * set of coefficients. Otherwise the fraction is kept in 16.16 fixed point
+ * and rounded down to one of kInexactPhases phases.
+ */
+struct PolyphaseFilter {
+	enum {
+		kBaseTaps = 16,      /*!< Taps per phase when upsampling, must be a multiple of 16. */
+		kMaxTaps = 64,       /*!< Upper bound for the taps per phase when downsampling. */
+		kMaxPhases = 512,    /*!< Upper bound for the number of phases with an exact fraction. */
+		kInexactPhases = 256 /*!< Number of phases when the fraction is not exact. */
+	};
+
+	st_rate_t inRate, outRate;
+
+	/** Number of taps per phase, always a multiple of 16. */
+	uint taps;
+	/** Number of phases in the filter bank. */
+	uint phases;
+
+	/** Denominator of the position fraction. */
+	uint32 denominator;
+	/** Amount to divide the position fraction by to get the phase. */
+	uint32 phaseDivisor;
+	/** Input samples to advance per output sample, in units of 1 / denominator. */
+	uint32 increment;
+
+	/** Coefficients in 2.14 fixed point, phases * taps entries. */
+	int16 *coefs;
+
+	/** Number of converters using this filter bank. */
+	int refCount;
+
+	PolyphaseFilter(st_rate_t inputRate, st_rate_t outputRate);
+	~PolyphaseFilter();
+
+	const int16 *getCoefs(uint32 frac) const { return coefs + (frac / phaseDivisor) * taps; }
+};
+
+/**
+ * Cache of the polyphase filter banks, shared by all converters.
+ *
+ * Computing a filter bank is expensive, so channels converting between the
+ * same rates share one, and new ones are computed on a worker thread instead
+ * of the audio thread. Banks no converter uses anymore are kept around, up
+ * to kMaxUnusedFilters of them, since sounds with the same rates tend to be
+ * played again soon.
+ */
+class PolyphaseFilterCache : public Common::Singleton<PolyphaseFilterCache> {
+public:
+	enum {
+		kMaxUnusedFilters = 8
+	};
+
+	/**
+	 * Get the filter bank for a rate pair. If it doesn't exist yet, it is
+	 * computed in the background and nullptr is returned; ask again later.
+	 * Without worker threads, it is computed right away instead.
+	 *
+	 * A filter bank must be returned through release() once it is not used
+	 * anymore.
+	 */
+	const PolyphaseFilter *acquire(st_rate_t inRate, st_rate_t outRate);
+
+	/**
+	 * Give back a filter bank obtained through acquire().
+	 */
+	void release(const PolyphaseFilter *filter);
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+	PolyphaseFilterCache();
+	~PolyphaseFilterCache();
+
+	struct BuildTask;
+	friend struct BuildTask;
+
+	/** Add a filter bank computed by a BuildTask. */
+	void addFilter(PolyphaseFilter *filter);
+
+	struct RatePair {
+		st_rate_t inRate, outRate;
+	};
+
+	Common::Mutex _mutex;
+	Common::Array<PolyphaseFilter *> _filters;
+	/** Rate pairs whose filter banks are being computed */
+	Common::Array<RatePair> _pending;
+	Common::ThreadPool *_builder;
+};
+
+RateConverter *makePolyphaseRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo);
+
+/** @} */
+} // End of namespace Audio
+
+#endif
@@ -172,6 +172,14 @@ public:
 	 */
 	virtual bool isWritable() const = 0;
 
+	/**
+	 * Retrieves the size and the last modification time of the file referred
+	 * by this node. The modification time is an opaque value which is only
+	 * meaningful when compared to an earlier value for the same node.
+	 *
+	 * @return bool true if the information is available, false otherwise.
+	 */
+	virtual bool getFileStats(int64 &size, int64 &modificationTime) const;
 
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
@@ -33,6 +33,7 @@
 #include "common/textconsole.h"
 #include "common/translation.h"
 #include "common/algorithm.h"
+#include "common/debug-channels.h"
 #include "common/file.h"
 #include "common/zip-set.h"
 #include "gui/debugger.h"
@@ -86,6 +87,10 @@ OpenGLGraphicsManager::OpenGLGraphicsManager()
 #endif
 #ifdef USE_SCALERS
 	  , _scalerPlugins(ScalerMan.getPlugins())
+#endif
+	  , _uploadStatsStartTime(0), _uploadStatsFrames(0), _uploadStatsAreas(0), _uploadStatsBytes(0), _uploadStatsMaxFrameBytes(0)
+#ifdef USE_OSD
+	  , _uploadStatsSurface(nullptr)
 #endif
 	{
 	memset(_gamePalette, 0, sizeof(_gamePalette));
@@ -100,6 +105,7 @@ OpenGLGraphicsManager::~OpenGLGraphicsManager() {
 #ifdef USE_OSD
 	delete _osdMessageSurface;
 	delete _osdIconSurface;
+	delete _uploadStatsSurface;
 #endif
 #if !USE_FORCED_GLES
 	ShaderManager::destroy();
@@ -678,6 +684,8 @@ void OpenGLGraphicsManager::updateScreen() {
 	}
 	_overlay->updateGLTexture();
 
+	updateUploadStats();
+
 #if !USE_FORCED_GLES
 	if (_libretroPipeline) {
 		_libretroPipeline->beginScaling();
@@ -790,6 +798,13 @@ void OpenGLGraphicsManager::updateScreen() {
 		_pipeline->drawTexture(_osdIconSurface->getGLTexture(),
 		                       dstX, dstY, _osdIconSurface->getWidth(), _osdIconSurface->getHeight());
 	}
+
+	if (_uploadStatsSurface) {
+		_targetBuffer->enableBlend(Framebuffer::kBlendModeTraditionalTransparency);
+		_pipeline->drawTexture(_uploadStatsSurface->getGLTexture(),
+		                       kUploadStatsLeftMargin, kUploadStatsTopMargin,
+		                       _uploadStatsSurface->getWidth(), _uploadStatsSurface->getHeight());
+	}
 #endif
 
 	_cursorNeedsRedraw = false;
@@ -1216,6 +1231,59 @@ void OpenGLGraphicsManager::osdMessageUpdateSurface() {
 }
 #endif
 
+void OpenGLGraphicsManager::updateUploadStats() {
+	const TextureUploadStats &stats = GLTexture::getUploadStats();
+
+	_uploadStatsFrames++;
+	_uploadStatsAreas += stats.uploads;
+	_uploadStatsBytes += stats.bytes;
+	_uploadStatsMaxFrameBytes = MAX(_uploadStatsMaxFrameBytes, stats.bytes);
+
+	GLTexture::resetUploadStats();
+
+	const uint32 now = g_system->getMillis(false);
+	if (now - _uploadStatsStartTime < kUploadStatsInterval) {
+		return;
+	}
+
+	if (DebugMan.isDebugChannelEnabled(kDebugLevelOpenGLStats)) {
+		const Common::String text = Common::String::format("Uploads: %u KB/frame (max %u KB), %u areas/frame, %u frames/s",
+		                                                   _uploadStatsBytes / _uploadStatsFrames / 1024,
+		                                                   _uploadStatsMaxFrameBytes / 1024,
+		                                                   _uploadStatsAreas / _uploadStatsFrames,
+		                                                   _uploadStatsFrames * 1000 / (now - _uploadStatsStartTime));
+		debugC(1, kDebugLevelOpenGLStats, "OpenGL: %s", text.c_str());
+
+#ifdef USE_OSD
+		const Graphics::Font *font = getFontOSD();
+		const int margin = 4;
+
+		delete _uploadStatsSurface;
+		_uploadStatsSurface = createSurface(_defaultFormatAlpha);
+		assert(_uploadStatsSurface);
+
+		_uploadStatsSurface->allocate(font->getStringWidth(text) + 2 * margin, font->getFontHeight() + 2 * margin);
+
+		Graphics::Surface *dst = _uploadStatsSurface->getSurface();
+		dst->fillRect(Common::Rect(dst->w, dst->h), dst->format.ARGBToColor(160, 40, 40, 40));
+		font->drawString(dst, text, margin, margin, dst->w - 2 * margin, dst->format.RGBToColor(255, 255, 255));
+
+		_uploadStatsSurface->updateGLTexture();
+#endif
+	} else {
+#ifdef USE_OSD
+		delete _uploadStatsSurface;
+		_uploadStatsSurface = nullptr;
+#endif
+	}
+
+	_uploadStatsStartTime = now;
+	_uploadStatsFrames = 0;
+	_uploadStatsAreas = 0;
+	_uploadStatsBytes = 0;
+	_uploadStatsMaxFrameBytes = 0;
+}
+
 void OpenGLGraphicsManager::displayActivityIconOnOSD(const Graphics::Surface *icon) {
 #ifdef USE_OSD
 	if (_osdIconSurface) {
@@ -1416,6 +1484,10 @@ void OpenGLGraphicsManager::notifyContextCreate(ContextType type,
 	if (_osdIconSurface) {
 		_osdIconSurface->recreate();
 	}
+
+	if (_uploadStatsSurface) {
+		_uploadStatsSurface->recreate();
+	}
 #endif
 }
 
@@ -1444,8 +1516,14 @@ void OpenGLGraphicsManager::notifyContextDestroy() {
 	if (_osdIconSurface) {
 		_osdIconSurface->destroy();
 	}
+
+	if (_uploadStatsSurface) {
+		_uploadStatsSurface->destroy();
+	}
 #endif
 
+	GLTexture::destroyPixelBuffers();
+
 #if !USE_FORCED_GLES
 	if (OpenGLContext.shadersSupported) {
 		ShaderMan.notifyDestroy();
@@ -515,6 +515,51 @@ private:
 		kOSDIconRightMargin = 10
 	};
 #endif
+
+	//
+	// Texture upload statistics
+	//
+
+	/**
+	 * Gather the texture upload statistics of the current frame.
+	 *
+	 * When the "openglstats" debug channel is enabled, the statistics are
+	 * logged and shown in the upper left corner once per second.
+	 */
+	void updateUploadStats();
+
+	/**
+	 * When gathering the current statistics has started.
+	 */
+	uint32 _uploadStatsStartTime;
+
+	/**
+	 * The number of frames, areas and bytes uploaded since then.
+	 */
+	uint32 _uploadStatsFrames;
+	uint32 _uploadStatsAreas;
+	uint32 _uploadStatsBytes;
+
+	/**
+	 * The largest number of bytes uploaded in a single frame since then.
+	 */
+	uint32 _uploadStatsMaxFrameBytes;
+
+	enum {
+		kUploadStatsInterval = 1000
+	};
+
+#ifdef USE_OSD
+	/**
+	 * The upload statistics overlay's contents.
+	 */
+	Surface *_uploadStatsSurface;
+
+	enum {
+		kUploadStatsTopMargin = 10,
+		kUploadStatsLeftMargin = 10
+	};
+#endif
 };
 
 } // End of namespace OpenGL
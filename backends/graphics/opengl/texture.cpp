@@ -200,25 +200,129 @@ void GLTexture::updateArea(const Common::Rect &area, const Graphics::Surface &sr
 	bind();
 
 	// Update the actual texture.
-	// Although we have the area of the texture buffer we want to update we
-	// cannot take advantage of the left/right boundaries here because it is
-	// not possible to specify a pitch to glTexSubImage2D. To be precise, with
-	// plain OpenGL we could set GL_UNPACK_ROW_LENGTH to achieve this. However,
-	// OpenGL ES 1.0 does not support GL_UNPACK_ROW_LENGTH. Thus, we are left
-	// with the following options:
+	// It is not possible to specify a pitch to glTexSubImage2D, thus we
+	// cannot upload only the given area from the texture buffer directly.
+	// Depending on what the context supports we do the following:
 	//
-	// 1) (As we do right now) Simply always update the whole texture lines of
-	//    rect changed. This is simplest to implement. In case performance is
-	//    really an issue we can think of switching to another method.
+	// 1) Copy the area tightly packed into a pixel buffer object, and upload
+	//    from there. The driver can then transfer the data asynchronously.
 	//
-	// 2) Copy the dirty rect to a temporary buffer and upload that by using
-	//    glTexSubImage2D. This is what the Android backend does. It is more
-	//    complicated though.
+	// 2) Set GL_UNPACK_ROW_LENGTH to the pitch of the texture buffer, which
+	//    allows uploading only the area.
 	//
-	// 3) Use glTexSubImage2D per line changed. This is what the old OpenGL
-	//    graphics manager did but it is much slower! Thus, we do not use it.
-	GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, area.top, src.w, area.height(),
-	                       _glFormat, _glType, src.getBasePtr(0, area.top)));
+	// 3) OpenGL ES 1.0 does not support GL_UNPACK_ROW_LENGTH, so we simply
+	//    update the whole texture lines the area covers. Using
+	//    glTexSubImage2D per line changed is much slower.
+	const uint bytesPerPixel = src.format.bytesPerPixel;
+
+	if (OpenGLContext.pixelBufferObjectSupported && updateAreaPixelBuffer(area, src)) {
+		_uploadStats.pboUploads++;
+		_uploadStats.bytes += area.width() * area.height() * bytesPerPixel;
+	} else if (OpenGLContext.unpackSubImageSupported) {
+		GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, src.pitch / bytesPerPixel));
+		GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, area.left, area.top, area.width(), area.height(),
+		                        _glFormat, _glType, src.getBasePtr(area.left, area.top)));
+		GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+
+		_uploadStats.bytes += area.width() * area.height() * bytesPerPixel;
+	} else {
+		GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, area.top, src.w, area.height(),
+		                        _glFormat, _glType, src.getBasePtr(0, area.top)));
+
+		_uploadStats.bytes += area.height() * src.pitch;
+	}
+
+	_uploadStats.uploads++;
+}
+
+#ifdef USE_GLAD
+namespace {
+
+enum {
+	kPixelBufferCount = 3
+};
+
+// Ring of pixel buffer objects used to stream texture data. Each upload maps
+// the next buffer with its previous contents invalidated, so the driver can
+// hand out fresh storage instead of waiting for the GPU to finish reading the
+// data of an earlier upload.
+GLuint pixelBuffers[kPixelBufferCount];
+uint pixelBufferSizes[kPixelBufferCount];
+uint nextPixelBuffer = 0;
+
+} // End of anonymous namespace
+#endif
+
+bool GLTexture::updateAreaPixelBuffer(const Common::Rect &area, const Graphics::Surface &src) {
+#ifdef USE_GLAD
+	const uint rowSize = area.width() * src.format.bytesPerPixel;
+	const uint size = rowSize * area.height();
+
+	const uint index = nextPixelBuffer;
+	nextPixelBuffer = (nextPixelBuffer + 1) % kPixelBufferCount;
+
+	if (!pixelBuffers[index]) {
+		GL_CALL(glGenBuffers(1, &pixelBuffers[index]));
+		pixelBufferSizes[index] = 0;
+	}
+
+	GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffers[index]));
+
+	if (pixelBufferSizes[index] < size) {
+		GL_CALL(glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW));
+		pixelBufferSizes[index] = size;
+	}
+
+	byte *dst;
+	GL_ASSIGN(dst, (byte *)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+	if (!dst) {
+		GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+		return false;
+	}
+
+	const byte *srcRow = (const byte *)src.getBasePtr(area.left, area.top);
+	for (int y = area.top; y < area.bottom; ++y) {
+		memcpy(dst, srcRow, rowSize);
+		dst += rowSize;
+		srcRow += src.pitch;
+	}
+
+	bool uploaded;
+	GL_ASSIGN(uploaded, glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE);
+
+	// When the unmapping fails the buffer contents got corrupted, for
+	// example by a mode switch, and the caller has to upload the data itself.
+	if (uploaded) {
+		GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, area.left, area.top, area.width(), area.height(),
+		                        _glFormat, _glType, nullptr));
+	}
+
+	GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+	return uploaded;
+#else
+	return false;
+#endif
+}
+
+TextureUploadStats GLTexture::_uploadStats = { 0, 0, 0 };
+
+void GLTexture::resetUploadStats() {
+	_uploadStats.uploads = 0;
+	_uploadStats.pboUploads = 0;
+	_uploadStats.bytes = 0;
+}
+
+void GLTexture::destroyPixelBuffers() {
+#ifdef USE_GLAD
+	for (uint i = 0; i < kPixelBufferCount; ++i) {
+		if (pixelBuffers[i]) {
+			GL_CALL_SAFE(glDeleteBuffers, (1, &pixelBuffers[i]));
+			pixelBuffers[i] = 0;
+			pixelBufferSizes[i] = 0;
+		}
+	}
+	nextPixelBuffer = 0;
+#endif
 }
 
 //
@@ -226,7 +330,7 @@ void GLTexture::updateArea(const Common::Rect &area, const Graphics::Surface &sr
 //
 
 Surface::Surface()
-	: _allDirty(false), _dirtyArea() {
+	: _allDirty(false), _dirtyRects() {
 }
 
 void Surface::copyRectToTexture(uint x, uint y, uint w, uint h, const void *srcPtr, uint srcPitch) {
@@ -266,23 +370,65 @@ void Surface::fill(const Common::Rect &r, uint32 color) {
 	addDirtyArea(r);
 }
 
+static uint rectArea(const Common::Rect &r) {
+	return r.width() * r.height();
+}
+
 void Surface::addDirtyArea(const Common::Rect &r) {
-	// *sigh* Common::Rect::extend behaves unexpected whenever one of the two
-	// parameters is an empty rect. Thus, we check whether the current dirty
-	// area is valid. In case it is not we simply use the parameters as new
-	// dirty area. Otherwise, we simply call extend.
-	if (_dirtyArea.isEmpty()) {
-		_dirtyArea = r;
-	} else {
-		_dirtyArea.extend(r);
+	// Everything is uploaded anyway.
+	if (_allDirty || r.isEmpty()) {
+		return;
+	}
+
+	// Merge the new area with every dirty rectangle it overlaps, which keeps
+	// the rectangles disjoint, and with every one it is close to, i.e. when
+	// the bounding box of both does not cover much more than the rectangles
+	// themselves. Every merge can make the grown area eligible for merging
+	// with rectangles checked before, thus the scan restarts.
+	Common::Rect area = r;
+	for (uint i = 0; i < _dirtyRects.size();) {
+		Common::Rect merged = area;
+		merged.extend(_dirtyRects[i]);
+
+		if (area.intersects(_dirtyRects[i])
+		    || rectArea(merged) * 4 <= (rectArea(area) + rectArea(_dirtyRects[i])) * 5) {
+			area = merged;
+			_dirtyRects.remove_at(i);
+			i = 0;
+		} else {
+			++i;
+		}
+	}
+
+	if (_dirtyRects.size() < kMaxDirtyRects) {
+		_dirtyRects.push_back(area);
+		return;
 	}
+
+	// Too many rectangles, merge the area into the one it grows the least.
+	uint best = 0;
+	uint bestGrowth = 0xFFFFFFFF;
+	for (uint i = 0; i < _dirtyRects.size(); ++i) {
+		Common::Rect merged = _dirtyRects[i];
+		merged.extend(area);
+
+		const uint growth = rectArea(merged) - rectArea(_dirtyRects[i]);
+		if (growth < bestGrowth) {
+			best = i;
+			bestGrowth = growth;
+		}
+	}
+
+	area.extend(_dirtyRects[best]);
+	_dirtyRects.remove_at(best);
+	addDirtyArea(area);
 }
 
-Common::Rect Surface::getDirtyArea() const {
+Common::Array<Common::Rect> Surface::getDirtyRects() const {
 	if (_allDirty) {
-		return Common::Rect(getWidth(), getHeight());
+		return Common::Array<Common::Rect>(1, Common::Rect(getWidth(), getHeight()));
 	} else {
-		return _dirtyArea;
+		return _dirtyRects;
 	}
 }
 
@@ -343,12 +489,16 @@ void Texture::updateGLTexture() {
 		return;
 	}
 
-	Common::Rect dirtyArea = getDirtyArea();
+	const Common::Array<Common::Rect> dirtyRects = getDirtyRects();
+	for (uint i = 0; i < dirtyRects.size(); ++i) {
+		uploadArea(dirtyRects[i]);
+	}
 
-	updateGLTexture(dirtyArea);
+	// We should have handled everything, thus not dirty anymore.
+	clearDirty();
 }
 
-void Texture::updateGLTexture(Common::Rect &dirtyArea) {
+void Texture::uploadArea(Common::Rect dirtyArea) {
 	// In case we use linear filtering we might need to duplicate the last
 	// pixel row/column to avoid glitches with filtering.
 	if (_glTexture.isLinearFilteringEnabled()) {
@@ -379,9 +529,6 @@ void Texture::updateGLTexture(Common::Rect &dirtyArea) {
 	}
 
 	_glTexture.updateArea(dirtyArea, _textureData);
-
-	// We should have handled everything, thus not dirty anymore.
-	clearDirty();
 }
 
 FakeTexture::FakeTexture(GLenum glIntFormat, GLenum glFormat, GLenum glType, const Graphics::PixelFormat &format, const Graphics::PixelFormat &fakeFormat)
@@ -461,17 +608,22 @@ void FakeTexture::updateGLTexture() {
 	}
 
 	// Convert color space.
-	Graphics::Surface *outSurf = Texture::getSurface();
+	const Common::Array<Common::Rect> dirtyRects = getDirtyRects();
+	for (uint i = 0; i < dirtyRects.size(); ++i) {
+		convertArea(dirtyRects[i]);
+	}
 
-	const Common::Rect dirtyArea = getDirtyArea();
+	// Do generic handling of updating the texture.
+	Texture::updateGLTexture();
+}
+
+void FakeTexture::convertArea(const Common::Rect &dirtyArea) {
+	Graphics::Surface *outSurf = Texture::getSurface();
 
 	byte *dst = (byte *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
 	const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
 
 	applyPaletteAndMask(dst, src, outSurf->pitch, _rgbData.pitch, _rgbData.w, dirtyArea, outSurf->format, _rgbData.format);
-
-	// Do generic handling of updating the texture.
-	Texture::updateGLTexture();
 }
 
 void FakeTexture::applyPaletteAndMask(byte *dst, const byte *src, uint dstPitch, uint srcPitch, uint srcWidth, const Common::Rect &dirtyArea, const Graphics::PixelFormat &dstFormat, const Graphics::PixelFormat &srcFormat) const {
@@ -512,16 +664,10 @@ TextureRGB555::TextureRGB555()
 	: FakeTexture(GL_RGB, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0), Graphics::PixelFormat(2, 5, 5, 5, 0, 10, 5, 0, 0)) {
 }
 
-void TextureRGB555::updateGLTexture() {
-	if (!isDirty()) {
-		return;
-	}
-
+void TextureRGB555::convertArea(const Common::Rect &dirtyArea) {
 	// Convert color space.
 	Graphics::Surface *outSurf = Texture::getSurface();
 
-	const Common::Rect dirtyArea = getDirtyArea();
-
 	uint16 *dst = (uint16 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
 	const uint dstAdd = outSurf->pitch - 2 * dirtyArea.width();
 
@@ -540,9 +686,6 @@ void TextureRGB555::updateGLTexture() {
 		src = (const uint16 *)((const byte *)src + srcAdd);
 		dst = (uint16 *)((byte *)dst + dstAdd);
 	}
-
-	// Do generic handling of updating the texture.
-	Texture::updateGLTexture();
 }
 
 TextureRGBA8888Swap::TextureRGBA8888Swap()
@@ -554,16 +697,10 @@ TextureRGBA8888Swap::TextureRGBA8888Swap()
 	  {
 }
 
-void TextureRGBA8888Swap::updateGLTexture() {
-	if (!isDirty()) {
-		return;
-	}
-
+void TextureRGBA8888Swap::convertArea(const Common::Rect &dirtyArea) {
 	// Convert color space.
 	Graphics::Surface *outSurf = Texture::getSurface();
 
-	const Common::Rect dirtyArea = getDirtyArea();
-
 	uint32 *dst = (uint32 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
 	const uint dstAdd = outSurf->pitch - 4 * dirtyArea.width();
 
@@ -580,9 +717,6 @@ void TextureRGBA8888Swap::updateGLTexture() {
 		src = (const uint32 *)((const byte *)src + srcAdd);
 		dst = (uint32 *)((byte *)dst + dstAdd);
 	}
-
-	// Do generic handling of updating the texture.
-	Texture::updateGLTexture();
 }
 
 #ifdef USE_SCALERS
@@ -626,49 +760,63 @@ void ScaledTexture::updateGLTexture() {
 		return;
 	}
 
-	// Convert color space.
-	Graphics::Surface *outSurf = Texture::getSurface();
+	Common::Array<Common::Rect> dirtyRects = getDirtyRects();
 
-	Common::Rect dirtyArea = getDirtyArea();
+	// Convert color space. This is done for all areas before scaling, as
+	// the scalers might read pixels from around the area they scale.
+	for (uint i = 0; i < dirtyRects.size(); ++i) {
+		Common::Rect &dirtyArea = dirtyRects[i];
 
-	// Extend the dirty region for scalers
-	// that "smear" the screen, e.g. 2xSAI
-	dirtyArea.grow(_extraPixels);
-	dirtyArea.clip(Common::Rect(0, 0, _rgbData.w, _rgbData.h));
+		// Extend the dirty region for scalers
+		// that "smear" the screen, e.g. 2xSAI
+		dirtyArea.grow(_extraPixels);
+		dirtyArea.clip(Common::Rect(0, 0, _rgbData.w, _rgbData.h));
 
-	const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
-	uint srcPitch = _rgbData.pitch;
-	byte *dst;
-	uint dstPitch;
+		if (_convData) {
+			const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
+			byte *dst = (byte *)_convData->getBasePtr(dirtyArea.left + _extraPixels, dirtyArea.top + _extraPixels);
 
-	if (_convData) {
-		dst = (byte *)_convData->getBasePtr(dirtyArea.left + _extraPixels, dirtyArea.top + _extraPixels);
-		dstPitch = _convData->pitch;
+			applyPaletteAndMask(dst, src, _convData->pitch, _rgbData.pitch, _rgbData.w, dirtyArea, _convData->format, _rgbData.format);
+		}
+	}
 
-		applyPaletteAndMask(dst, src, dstPitch, srcPitch, _rgbData.w, dirtyArea, _convData->format, _rgbData.format);
+	Graphics::Surface *outSurf = Texture::getSurface();
 
-		src = dst;
-		srcPitch = dstPitch;
-	}
+	for (uint i = 0; i < dirtyRects.size(); ++i) {
+		Common::Rect &dirtyArea = dirtyRects[i];
 
-	dst = (byte *)outSurf->getBasePtr(dirtyArea.left * _scaleFactor, dirtyArea.top * _scaleFactor);
-	dstPitch = outSurf->pitch;
+		const byte *src;
+		uint srcPitch;
 
-	if (_scaler && (uint)dirtyArea.height() >= _extraPixels) {
-		_scaler->scale(src, srcPitch, dst, dstPitch, dirtyArea.width(), dirtyArea.height(), dirtyArea.left, dirtyArea.top);
-	} else {
-		Graphics::scaleBlit(dst, src, dstPitch, srcPitch,
-		                    dirtyArea.width() * _scaleFactor, dirtyArea.height() * _scaleFactor,
-		                    dirtyArea.width(), dirtyArea.height(), outSurf->format);
-	}
+		if (_convData) {
+			src = (const byte *)_convData->getBasePtr(dirtyArea.left + _extraPixels, dirtyArea.top + _extraPixels);
+			srcPitch = _convData->pitch;
+		} else {
+			src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
+			srcPitch = _rgbData.pitch;
+		}
 
-	dirtyArea.left   *= _scaleFactor;
-	dirtyArea.right  *= _scaleFactor;
-	dirtyArea.top    *= _scaleFactor;
-	dirtyArea.bottom *= _scaleFactor;
+		byte *dst = (byte *)outSurf->getBasePtr(dirtyArea.left * _scaleFactor, dirtyArea.top * _scaleFactor);
+		const uint dstPitch = outSurf->pitch;
 
-	// Do generic handling of updating the texture.
-	Texture::updateGLTexture(dirtyArea);
+		if (_scaler && (uint)dirtyArea.height() >= _extraPixels) {
+			_scaler->scale(src, srcPitch, dst, dstPitch, dirtyArea.width(), dirtyArea.height(), dirtyArea.left, dirtyArea.top);
+		} else {
+			Graphics::scaleBlit(dst, src, dstPitch, srcPitch,
+			                    dirtyArea.width() * _scaleFactor, dirtyArea.height() * _scaleFactor,
+			                    dirtyArea.width(), dirtyArea.height(), outSurf->format);
+		}
+
+		dirtyArea.left   *= _scaleFactor;
+		dirtyArea.right  *= _scaleFactor;
+		dirtyArea.top    *= _scaleFactor;
+		dirtyArea.bottom *= _scaleFactor;
+
+		// Do generic handling of updating the texture.
+		uploadArea(dirtyArea);
+	}
+
+	clearDirty();
 }
 
 void ScaledTexture::setScaler(uint scalerIndex, int scaleFactor) {
@@ -828,7 +976,10 @@ void TextureCLUT8GPU::updateGLTexture() {
 
 	// Update CLUT8 texture if necessary.
 	if (Surface::isDirty()) {
-		_clut8Texture.updateArea(getDirtyArea(), _clut8Data);
+		const Common::Array<Common::Rect> dirtyRects = getDirtyRects();
+		for (uint i = 0; i < dirtyRects.size(); ++i) {
+			_clut8Texture.updateArea(dirtyRects[i], _clut8Data);
+		}
 		clearDirty();
 	}
 
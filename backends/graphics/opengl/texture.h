@@ -28,12 +28,22 @@
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
 
+#include "common/array.h"
 #include "common/rect.h"
 
 class Scaler;
 
 namespace OpenGL {
 
+/**
+ * Statistics about the texture data uploaded by GLTexture::updateArea.
+ */
+struct TextureUploadStats {
+	uint32 uploads;    ///< Number of areas uploaded.
+	uint32 pboUploads; ///< Number of areas uploaded through a pixel buffer object.
+	uint32 bytes;      ///< Number of bytes uploaded.
+};
+
 enum WrapMode {
 	kWrapModeBorder,
 	kWrapModeEdge,
@@ -114,6 +124,24 @@ public:
 	 */
 	void updateArea(const Common::Rect &area, const Graphics::Surface &src);
 
+	/**
+	 * Query the statistics of all texture uploads since the last call to
+	 * resetUploadStats.
+	 */
+	static const TextureUploadStats &getUploadStats() { return _uploadStats; }
+
+	/**
+	 * Reset the texture upload statistics.
+	 */
+	static void resetUploadStats();
+
+	/**
+	 * Release the pixel buffer objects used for uploading texture data.
+	 *
+	 * This needs to be called before the context is destroyed.
+	 */
+	static void destroyPixelBuffers();
+
 	/**
 	 * Query the GL texture's width.
 	 */
@@ -158,6 +186,15 @@ private:
 	GLint _glFilter;
 
 	GLuint _glTexture;
+
+	/**
+	 * Upload the area through the next pixel buffer object of the ring.
+	 *
+	 * @return Whether the area was uploaded.
+	 */
+	bool updateAreaPixelBuffer(const Common::Rect &area, const Graphics::Surface &src);
+
+	static TextureUploadStats _uploadStats;
 };
 
 /**
@@ -224,7 +261,7 @@ public:
 	void fill(const Common::Rect &r, uint32 color);
 
 	void flagDirty() { _allDirty = true; }
-	virtual bool isDirty() const { return _allDirty || !_dirtyArea.isEmpty(); }
+	virtual bool isDirty() const { return _allDirty || !_dirtyRects.empty(); }
 
 	virtual uint getWidth() const = 0;
 	virtual uint getHeight() const = 0;
@@ -264,13 +301,25 @@ public:
 	 */
 	virtual const GLTexture &getGLTexture() const = 0;
 protected:
-	void clearDirty() { _allDirty = false; _dirtyArea = Common::Rect(); }
+	void clearDirty() { _allDirty = false; _dirtyRects.clear(); }
 
 	void addDirtyArea(const Common::Rect &r);
-	Common::Rect getDirtyArea() const;
+
+	/**
+	 * @return The disjoint list of rectangles which need to be uploaded.
+	 */
+	Common::Array<Common::Rect> getDirtyRects() const;
 private:
+	enum {
+		/**
+		 * Maximum number of dirty rectangles tracked. Further rectangles are
+		 * merged with the one they grow the least.
+		 */
+		kMaxDirtyRects = 8
+	};
+
 	bool _allDirty;
-	Common::Rect _dirtyArea;
+	Common::Array<Common::Rect> _dirtyRects;
 };
 
 /**
@@ -314,7 +363,12 @@ public:
 protected:
 	const Graphics::PixelFormat _format;
 
-	void updateGLTexture(Common::Rect &dirtyArea);
+	/**
+	 * Upload an area of the texture data to the GL texture.
+	 *
+	 * This does not clear the dirty state of the surface.
+	 */
+	void uploadArea(Common::Rect dirtyArea);
 
 private:
 	GLTexture _glTexture;
@@ -343,6 +397,11 @@ public:
 
 	void updateGLTexture() override;
 protected:
+	/**
+	 * Convert an area of the user data to the texture data.
+	 */
+	virtual void convertArea(const Common::Rect &dirtyArea);
+
 	void applyPaletteAndMask(byte *dst, const byte *src, uint dstPitch, uint srcPitch, uint srcWidth, const Common::Rect &dirtyArea, const Graphics::PixelFormat &dstFormat, const Graphics::PixelFormat &srcFormat) const;
 
 	Graphics::Surface _rgbData;
@@ -356,7 +415,8 @@ public:
 	TextureRGB555();
 	~TextureRGB555() override {}
 
-	void updateGLTexture() override;
+protected:
+	void convertArea(const Common::Rect &dirtyArea) override;
 };
 
 class TextureRGBA8888Swap : public FakeTexture {
@@ -364,7 +424,8 @@ public:
 	TextureRGBA8888Swap();
 	~TextureRGBA8888Swap() override {}
 
-	void updateGLTexture() override;
+protected:
+	void convertArea(const Common::Rect &dirtyArea) override;
 };
 
 #ifdef USE_SCALERS
@@ -192,6 +192,7 @@ MODULE_OBJS += \
 	mixer/sdl/sdl-mixer.o \
 	mixer/null/null-mixer.o \
 	mutex/sdl/sdl-mutex.o \
+	thread/sdl/sdl-thread.o \
 	timer/sdl/sdl-timer.o
 
 ifndef RISCOS
@@ -311,7 +312,8 @@ MODULE_OBJS += \
 	graphics3d/opengl/surfacerenderer.o \
 	graphics3d/opengl/texture.o \
 	graphics3d/opengl/tiledsurface.o \
-	mutex/pthread/pthread-mutex.o
+	mutex/pthread/pthread-mutex.o \
+	thread/pthread/pthread-thread.o
 endif
 
 ifdef AMIGAOS
@@ -402,6 +404,7 @@ endif
 ifdef IPHONE
 MODULE_OBJS += \
 	mutex/pthread/pthread-mutex.o \
+	thread/pthread/pthread-thread.o \
 	graphics/ios/ios-graphics.o \
 	graphics/ios/renderbuffer.o \
 	graphics3d/ios/ios-graphics3d.o \
@@ -29,6 +29,8 @@
  * pthreads mutex implementation
  */
 class PthreadMutexInternal final : public Common::MutexInternal {
+	friend class PthreadConditionVariableInternal;
+
 public:
 	PthreadMutexInternal();
 	~PthreadMutexInternal() override;
@@ -78,3 +80,51 @@ bool PthreadMutexInternal::unlock() {
 Common::MutexInternal *createPthreadMutexInternal() {
 	return new PthreadMutexInternal();
 }
+
+/**
+ * pthreads condition variable, to be used with pthreads mutexes
+ */
+class PthreadConditionVariableInternal final : public Common::ConditionVariableInternal {
+public:
+	PthreadConditionVariableInternal();
+	~PthreadConditionVariableInternal() override;
+
+	bool wait(Common::MutexInternal *mutex) override;
+	bool signal() override;
+	bool broadcast() override;
+
+private:
+	pthread_cond_t _cond;
+};
+
+PthreadConditionVariableInternal::PthreadConditionVariableInternal() {
+	if (pthread_cond_init(&_cond, nullptr) != 0)
+		warning("pthread_cond_init() failed");
+}
+
+PthreadConditionVariableInternal::~PthreadConditionVariableInternal() {
+	if (pthread_cond_destroy(&_cond) != 0)
+		warning("pthread_cond_destroy() failed");
+}
+
+bool PthreadConditionVariableInternal::wait(Common::MutexInternal *mutex) {
+	// The mutex is recursive, which works as long as it is locked only once
+	if (pthread_cond_wait(&_cond, &static_cast<PthreadMutexInternal *>(mutex)->_mutex) != 0) {
+		warning("pthread_cond_wait() failed");
+		return false;
+	} else {
+		return true;
+	}
+}
+
+bool PthreadConditionVariableInternal::signal() {
+	return pthread_cond_signal(&_cond) == 0;
+}
+
+bool PthreadConditionVariableInternal::broadcast() {
+	return pthread_cond_broadcast(&_cond) == 0;
+}
+
+Common::ConditionVariableInternal *createPthreadConditionVariableInternal() {
+	return new PthreadConditionVariableInternal();
+}
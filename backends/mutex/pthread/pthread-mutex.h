@@ -25,5 +25,6 @@
 #include "common/mutex.h"
 
 Common::MutexInternal *createPthreadMutexInternal();
+Common::ConditionVariableInternal *createPthreadConditionVariableInternal();
 
 #endif
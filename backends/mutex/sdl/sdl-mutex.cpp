@@ -30,6 +30,8 @@
  * SDL mutex manager
  */
 class SdlMutexInternal final : public Common::MutexInternal {
+	friend class SdlConditionVariableInternal;
+
 public:
 	SdlMutexInternal() { _mutex = SDL_CreateMutex(); }
 	~SdlMutexInternal() override { SDL_DestroyMutex(_mutex); }
@@ -45,4 +47,26 @@ Common::MutexInternal *createSdlMutexInternal() {
 	return new SdlMutexInternal();
 }
 
+/**
+ * SDL condition variable, to be used with SDL mutexes
+ */
+class SdlConditionVariableInternal final : public Common::ConditionVariableInternal {
+public:
+	SdlConditionVariableInternal() { _cond = SDL_CreateCond(); }
+	~SdlConditionVariableInternal() override { SDL_DestroyCond(_cond); }
+
+	bool wait(Common::MutexInternal *mutex) override {
+		return (SDL_CondWait(_cond, static_cast<SdlMutexInternal *>(mutex)->_mutex) == 0);
+	}
+	bool signal() override { return (SDL_CondSignal(_cond) == 0); }
+	bool broadcast() override { return (SDL_CondBroadcast(_cond) == 0); }
+
+private:
+	SDL_cond *_cond;
+};
+
+Common::ConditionVariableInternal *createSdlConditionVariableInternal() {
+	return new SdlConditionVariableInternal();
+}
+
 #endif
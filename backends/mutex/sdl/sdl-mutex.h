@@ -25,5 +25,6 @@
 #include "common/mutex.h"
 
 Common::MutexInternal *createSdlMutexInternal();
+Common::ConditionVariableInternal *createSdlConditionVariableInternal();
 
 #endif
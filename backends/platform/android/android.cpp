@@ -67,6 +67,7 @@
 #include "backends/audiocd/default/default-audiocd.h"
 #include "backends/events/default/default-events.h"
 #include "backends/mutex/pthread/pthread-mutex.h"
+#include "backends/thread/pthread/pthread-thread.h"
 #include "backends/saves/default/default-saves.h"
 #include "backends/timer/default/default-timer.h"
 
@@ -835,6 +836,18 @@ Common::MutexInternal *OSystem_Android::createMutex() {
 	return createPthreadMutexInternal();
 }
 
+Common::ThreadInternal *OSystem_Android::createThread(Common::ThreadProc proc, void *param) {
+	return createPthreadThreadInternal(proc, param);
+}
+
+Common::ConditionVariableInternal *OSystem_Android::createConditionVariable() {
+	return createPthreadConditionVariableInternal();
+}
+
+uint OSystem_Android::getCpuCount() {
+	return getPthreadCpuCount();
+}
+
 void OSystem_Android::quit() {
 	ENTER();
 
@@ -243,6 +243,9 @@ public:
 	uint32 getMillis(bool skipRecord = false) override;
 	void delayMillis(uint msecs) override;
 	Common::MutexInternal *createMutex() override;
+	Common::ThreadInternal *createThread(Common::ThreadProc proc, void *param) override;
+	Common::ConditionVariableInternal *createConditionVariable() override;
+	uint getCpuCount() override;
 
 	void quit() override;
 
@@ -51,6 +51,11 @@ typedef void (*sighandler_t)(int);
 #include "backends/mutex/null/null-mutex.h"
 #include "base/main.h"
 
+#if defined(NULL_DRIVER_USE_FOR_TEST) && defined(POSIX)
+#include "backends/mutex/pthread/pthread-mutex.h"
+#include "backends/thread/pthread/pthread-thread.h"
+#endif
+
 #ifndef NULL_DRIVER_USE_FOR_TEST
 #include "backends/saves/default/default-saves.h"
 #include "backends/timer/default/default-timer.h"
@@ -85,7 +90,13 @@ public:
 	virtual bool pollEvent(Common::Event &event);
 
 	virtual Common::MutexInternal *createMutex();
+#if defined(NULL_DRIVER_USE_FOR_TEST) && defined(POSIX)
+	virtual Common::ThreadInternal *createThread(Common::ThreadProc proc, void *param);
+	virtual Common::ConditionVariableInternal *createConditionVariable();
+	virtual uint getCpuCount();
+#endif
 	virtual uint32 getMillis(bool skipRecord = false);
+	virtual uint64 getMicros();
 	virtual void delayMillis(uint msecs);
 	virtual void getTimeAndDate(TimeDate &td, bool skipRecord = false) const;
 
@@ -95,6 +106,21 @@ public:
 
 	virtual void addSysArchivesToSearchSet(Common::SearchSet &s, int priority);
 
+#ifdef NULL_DRIVER_USE_FOR_TEST
+	/**
+	 * Whether real threads, condition variables and mutexes are created,
+	 * for tests which need concurrency. Only supported on POSIX.
+	 */
+	bool _threaded;
+
+	/**
+	 * Whether time only passes through delayMillis(), for tests which need
+	 * to be independent of the load of the machine.
+	 */
+	bool _manualClock;
+	uint64 _manualMicros;
+#endif
+
 private:
 #ifdef POSIX
 	timeval _startTime;
@@ -105,6 +131,11 @@ private:
 };
 
 OSystem_NULL::OSystem_NULL(bool silenceLogs) :
+#ifdef NULL_DRIVER_USE_FOR_TEST
+	_threaded(false),
+	_manualClock(false),
+	_manualMicros(0),
+#endif
 	_silenceLogs(silenceLogs) {
 	#if defined(__amigaos4__)
 		_fsFactory = new AmigaOSFilesystemFactory();
@@ -187,10 +218,32 @@ bool OSystem_NULL::pollEvent(Common::Event &event) {
 }
 
 Common::MutexInternal *OSystem_NULL::createMutex() {
+#if defined(NULL_DRIVER_USE_FOR_TEST) && defined(POSIX)
+	if (_threaded)
+		return createPthreadMutexInternal();
+#endif
 	return new NullMutexInternal();
 }
 
+#if defined(NULL_DRIVER_USE_FOR_TEST) && defined(POSIX)
+Common::ThreadInternal *OSystem_NULL::createThread(Common::ThreadProc proc, void *param) {
+	return _threaded ? createPthreadThreadInternal(proc, param) : nullptr;
+}
+
+Common::ConditionVariableInternal *OSystem_NULL::createConditionVariable() {
+	return _threaded ? createPthreadConditionVariableInternal() : nullptr;
+}
+
+uint OSystem_NULL::getCpuCount() {
+	return _threaded ? getPthreadCpuCount() : 1;
+}
+#endif
+
 uint32 OSystem_NULL::getMillis(bool skipRecord) {
+#ifdef NULL_DRIVER_USE_FOR_TEST
+	if (_manualClock)
+		return (uint32)(_manualMicros / 1000);
+#endif
 #ifdef POSIX
 	timeval curTime;
 
@@ -205,7 +258,30 @@ uint32 OSystem_NULL::getMillis(bool skipRecord) {
 #endif
 }
 
+uint64 OSystem_NULL::getMicros() {
+#ifdef NULL_DRIVER_USE_FOR_TEST
+	if (_manualClock)
+		return _manualMicros;
+#endif
+#ifdef POSIX
+	timeval curTime;
+
+	gettimeofday(&curTime, 0);
+
+	return (uint64)(curTime.tv_sec - _startTime.tv_sec) * 1000000 +
+			(curTime.tv_usec - _startTime.tv_usec);
+#else
+	return (uint64)getMillis(true) * 1000;
+#endif
+}
+
 void OSystem_NULL::delayMillis(uint msecs) {
+#ifdef NULL_DRIVER_USE_FOR_TEST
+	if (_manualClock) {
+		_manualMicros += (uint64)msecs * 1000;
+		return;
+	}
+#endif
 #ifdef POSIX
 	usleep(msecs * 1000);
 #elif defined(WIN32)
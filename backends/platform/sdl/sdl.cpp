@@ -46,6 +46,7 @@
 #include "backends/events/sdl/legacy-sdl-events.h"
 #include "backends/keymapper/hardware-input.h"
 #include "backends/mutex/sdl/sdl-mutex.h"
+#include "backends/thread/sdl/sdl-thread.h"
 #include "backends/timer/sdl/sdl-timer.h"
 #include "backends/graphics/surfacesdl/surfacesdl-graphics.h"
 #ifdef USE_OPENGL
@@ -88,6 +89,9 @@ OSystem_SDL::OSystem_SDL()
 #endif
 	_inited(false),
 	_initedSDL(false),
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	_performanceCounterStart(0),
+#endif
 #ifdef USE_SDL_NET
 	_initedSDLnet(false),
 #endif
@@ -515,6 +519,12 @@ void OSystem_SDL::initSDL() {
 		if (SDL_Init(sdlFlags) == -1)
 			error("Could not initialize SDL: %s", SDL_GetError());
 
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+		// The performance counter has an arbitrary zero point, align it
+		// with SDL_GetTicks() for getMicros()
+		_performanceCounterStart = SDL_GetPerformanceCounter() - (uint64)SDL_GetTicks() * SDL_GetPerformanceFrequency() / 1000;
+#endif
+
 		_initedSDL = true;
 	}
 
@@ -724,6 +734,18 @@ Common::MutexInternal *OSystem_SDL::createMutex() {
 	return createSdlMutexInternal();
 }
 
+Common::ThreadInternal *OSystem_SDL::createThread(Common::ThreadProc proc, void *param) {
+	return createSdlThreadInternal(proc, param);
+}
+
+Common::ConditionVariableInternal *OSystem_SDL::createConditionVariable() {
+	return createSdlConditionVariableInternal();
+}
+
+uint OSystem_SDL::getCpuCount() {
+	return getSdlCpuCount();
+}
+
 uint32 OSystem_SDL::getMillis(bool skipRecord) {
 	uint32 millis = SDL_GetTicks();
 
@@ -734,6 +756,16 @@ uint32 OSystem_SDL::getMillis(bool skipRecord) {
 	return millis;
 }
 
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+uint64 OSystem_SDL::getMicros() {
+	static const Uint64 frequency = SDL_GetPerformanceFrequency();
+	const Uint64 counter = SDL_GetPerformanceCounter() - _performanceCounterStart;
+
+	// Split the conversion to avoid overflowing the multiplication
+	return (counter / frequency) * 1000000 + ((counter % frequency) * 1000000) / frequency;
+}
+#endif
+
 void OSystem_SDL::delayMillis(uint msecs) {
 #ifdef ENABLE_EVENTRECORDER
 	if (!g_eventRec.processDelayMillis())
@@ -83,7 +83,13 @@ public:
 	void setWindowCaption(const Common::U32String &caption) override;
 	void addSysArchivesToSearchSet(Common::SearchSet &s, int priority = 0) override;
 	Common::MutexInternal *createMutex() override;
+	Common::ThreadInternal *createThread(Common::ThreadProc proc, void *param) override;
+	Common::ConditionVariableInternal *createConditionVariable() override;
+	uint getCpuCount() override;
 	uint32 getMillis(bool skipRecord = false) override;
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	uint64 getMicros() override;
+#endif
 	void delayMillis(uint msecs) override;
 	void getTimeAndDate(TimeDate &td, bool skipRecord = false) const override;
 	MixerManager *getMixerManager() override;
@@ -107,6 +113,10 @@ public:
 protected:
 	bool _inited;
 	bool _initedSDL;
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	/** Performance counter value at the time SDL_GetTicks() started counting */
+	uint64 _performanceCounterStart;
+#endif
 #ifdef USE_SDL_NET
 	bool _initedSDLnet;
 #endif
@@ -0,0 +1,91 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+#define FORBIDDEN_SYMBOL_EXCEPTION_unistd_h
+
+#include "backends/thread/pthread/pthread-thread.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+/**
+ * pthreads worker thread
+ */
+class PthreadThreadInternal final : public Common::ThreadInternal {
+public:
+	PthreadThreadInternal(Common::ThreadProc proc, void *param) : _proc(proc), _param(param), _running(false) {}
+	~PthreadThreadInternal() override { join(); }
+
+	bool start();
+	bool join() override;
+
+private:
+	static void *threadProc(void *param);
+
+	Common::ThreadProc _proc;
+	void *_param;
+	pthread_t _thread;
+	bool _running;
+};
+
+bool PthreadThreadInternal::start() {
+	_running = (pthread_create(&_thread, nullptr, &PthreadThreadInternal::threadProc, this) == 0);
+	return _running;
+}
+
+bool PthreadThreadInternal::join() {
+	if (!_running)
+		return true;
+
+	_running = false;
+	if (pthread_join(_thread, nullptr) != 0) {
+		warning("pthread_join() failed");
+		return false;
+	} else {
+		return true;
+	}
+}
+
+void *PthreadThreadInternal::threadProc(void *param) {
+	PthreadThreadInternal *thread = static_cast<PthreadThreadInternal *>(param);
+	thread->_proc(thread->_param);
+	return nullptr;
+}
+
+Common::ThreadInternal *createPthreadThreadInternal(Common::ThreadProc proc, void *param) {
+	PthreadThreadInternal *thread = new PthreadThreadInternal(proc, param);
+	if (!thread->start()) {
+		warning("pthread_create() failed");
+		delete thread;
+		return nullptr;
+	}
+	return thread;
+}
+
+uint getPthreadCpuCount() {
+#ifdef _SC_NPROCESSORS_ONLN
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (uint)count : 1;
+#else
+	return 1;
+#endif
+}
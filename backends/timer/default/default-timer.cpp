@@ -21,6 +21,8 @@
 
 #include "common/scummsys.h"
 #include "backends/timer/default/default-timer.h"
+#include "common/algorithm.h"
+#include "common/debug.h"
 #include "common/util.h"
 #include "common/system.h"
 
@@ -32,51 +34,82 @@ struct TimerSlot {
 
 	uint32 nextFireTime;	// in milliseconds
 	uint32 nextFireTimeMicro;	// microseconds part of nextFire
+	uint32 sequence;	// keeps timers due at the same time in insertion order
 
-	TimerSlot *next;
+	Common::TimerManager::TimerStats stats;
 
-	TimerSlot() : callback(nullptr), refCon(nullptr), interval(0), nextFireTime(0), nextFireTimeMicro(0), next(nullptr) {}
+	TimerSlot() : callback(nullptr), refCon(nullptr), interval(0), nextFireTime(0), nextFireTimeMicro(0), sequence(0), stats() {}
 };
 
-void insertPrioQueue(TimerSlot *head, TimerSlot *newSlot) {
-	// The head points to a fake anchor TimerSlot; this common
-	// trick allows us to get rid of many special cases.
-
-	const uint32 nextFireTime = newSlot->nextFireTime;
-	TimerSlot *slot = head;
-	newSlot->next = nullptr;
-
-	// Insert the new slot into the sorted list of already scheduled
-	// timers in such a way that the list stays sorted...
-	while (true) {
-		assert(slot);
-		if (slot->next == nullptr || nextFireTime < slot->next->nextFireTime) {
-			newSlot->next = slot->next;
-			slot->next = newSlot;
-			return;
-		}
-		slot = slot->next;
-	}
+static bool firesBefore(const TimerSlot *a, const TimerSlot *b) {
+	if (a->nextFireTime != b->nextFireTime)
+		return a->nextFireTime < b->nextFireTime;
+	return (int32)(a->sequence - b->sequence) < 0;
 }
 
 
 DefaultTimerManager::DefaultTimerManager() :
-	_timerCallbackNext(0),
-	_head(nullptr) {
-
-	_head = new TimerSlot();
+	_runningSlot(nullptr),
+	_nextSequence(0),
+	_timerCallbackNext(0) {
 }
 
 DefaultTimerManager::~DefaultTimerManager() {
 	Common::StackLock lock(_mutex);
 
-	TimerSlot *slot = _head;
-	while (slot) {
-		TimerSlot *next = slot->next;
-		delete slot;
-		slot = next;
+	for (uint i = 0; i < _queue.size(); ++i)
+		delete _queue[i];
+	_queue.clear();
+}
+
+void DefaultTimerManager::pushSlot(TimerSlot *slot) {
+	slot->sequence = _nextSequence++;
+	_queue.push_back(slot);
+	siftUp(_queue.size() - 1);
+}
+
+void DefaultTimerManager::removeSlot(uint index) {
+	_queue[index] = _queue.back();
+	_queue.pop_back();
+
+	if (index < _queue.size()) {
+		siftUp(index);
+		siftDown(index);
 	}
-	_head = nullptr;
+}
+
+void DefaultTimerManager::siftUp(uint index) {
+	TimerSlot *slot = _queue[index];
+
+	while (index > 0) {
+		const uint parent = (index - 1) / 2;
+		if (!firesBefore(slot, _queue[parent]))
+			break;
+
+		_queue[index] = _queue[parent];
+		index = parent;
+	}
+
+	_queue[index] = slot;
+}
+
+void DefaultTimerManager::siftDown(uint index) {
+	TimerSlot *slot = _queue[index];
+	const uint size = _queue.size();
+
+	while (2 * index + 1 < size) {
+		uint child = 2 * index + 1;
+		if (child + 1 < size && firesBefore(_queue[child + 1], _queue[child]))
+			child++;
+
+		if (!firesBefore(_queue[child], slot))
+			break;
+
+		_queue[index] = _queue[child];
+		index = child;
+	}
+
+	_queue[index] = slot;
 }
 
 void DefaultTimerManager::handler() {
@@ -84,18 +117,13 @@ void DefaultTimerManager::handler() {
 
 	uint32 curTime = g_system->getMillis(true);
 
-	// On slow systems this could still be run after destructor
-	if (!_head)
-		return;
-
 	// Repeat as long as there is a TimerSlot that is scheduled to fire.
-	TimerSlot *slot = _head->next;
-	while (slot && slot->nextFireTime < curTime) {
-		// Remove the slot from the priority queue
-		_head->next = slot->next;
+	while (!_queue.empty() && _queue[0]->nextFireTime < curTime) {
+		TimerSlot *slot = _queue[0];
+		const uint64 scheduledTime = (uint64)slot->nextFireTime * 1000 + slot->nextFireTimeMicro;
 
-		// Update the fire time and reinsert the TimerSlot into the priority
-		// queue.
+		// Update the fire time and move the TimerSlot to its new place in
+		// the priority queue.
 		assert(slot->interval > 0);
 		slot->nextFireTime += (slot->interval / 1000);
 		slot->nextFireTimeMicro += (slot->interval % 1000);
@@ -103,14 +131,46 @@ void DefaultTimerManager::handler() {
 			slot->nextFireTime += slot->nextFireTimeMicro / 1000;
 			slot->nextFireTimeMicro %= 1000;
 		}
-		insertPrioQueue(_head, slot);
+		slot->sequence = _nextSequence++;
+		siftDown(0);
 
-		// Invoke the timer callback
+		// Invoke the timer callback. The schedule is based on getMillis(),
+		// which getMicros() need not share its zero point with, so the
+		// delay is measured with the former and the callback with the latter.
 		assert(slot->callback);
+		_runningSlot = slot;
+		const uint64 startTime = (uint64)g_system->getMillis(true) * 1000;
+		const uint64 callbackStart = g_system->getMicros();
 		slot->callback(slot->refCon);
+		const uint32 callbackTime = (uint32)(g_system->getMicros() - callbackStart);
 
-		// Look at the next scheduled timer
-		slot = _head->next;
+		// The callback may have removed its own timer
+		if (_runningSlot == slot)
+			recordCall(slot, scheduledTime, startTime, callbackTime);
+		_runningSlot = nullptr;
+	}
+}
+
+void DefaultTimerManager::recordCall(TimerSlot *slot, uint64 scheduledTime, uint64 startTime, uint32 callbackTime) {
+	TimerStats &stats = slot->stats;
+	const uint32 jitter = (startTime > scheduledTime) ? (uint32)(startTime - scheduledTime) : 0;
+
+	stats.calls++;
+	stats.callbackTime += callbackTime;
+	stats.maxCallbackTime = MAX(stats.maxCallbackTime, callbackTime);
+	stats.jitter += jitter;
+	stats.maxJitter = MAX(stats.maxJitter, jitter);
+
+	// Timers only fire once the millisecond they are due in has passed, so
+	// the deadline is only missed if the following invocation is overdue too
+	if (slot->nextFireTime < startTime / 1000) {
+		stats.missedDeadlines++;
+		debugC(1, kDebugLevelTimerStats, "Timer '%s' started %u us late, missing its %u us interval", slot->id.c_str(), jitter, slot->interval);
+	}
+
+	if (callbackTime > slot->interval) {
+		stats.overruns++;
+		debugC(1, kDebugLevelTimerStats, "Timer '%s' ran for %u us, overrunning its %u us interval", slot->id.c_str(), callbackTime, slot->interval);
 	}
 }
 
@@ -149,9 +209,8 @@ bool DefaultTimerManager::installTimerProc(TimerProc callback, int32 interval, v
 	slot->interval = interval;
 	slot->nextFireTime = g_system->getMillis() + interval / 1000;
 	slot->nextFireTimeMicro = interval % 1000;
-	slot->next = nullptr;
 
-	insertPrioQueue(_head, slot);
+	pushSlot(slot);
 
 	return true;
 }
@@ -159,15 +218,18 @@ bool DefaultTimerManager::installTimerProc(TimerProc callback, int32 interval, v
 void DefaultTimerManager::removeTimerProc(TimerProc callback) {
 	Common::StackLock lock(_mutex);
 
-	TimerSlot *slot = _head;
+	// Removing a slot reorders the queue, thus start over after each one.
+	for (uint i = 0; i < _queue.size();) {
+		TimerSlot *slot = _queue[i];
+		if (slot->callback == callback) {
+			if (slot == _runningSlot)
+				_runningSlot = nullptr;
 
-	while (slot->next) {
-		if (slot->next->callback == callback) {
-			TimerSlot *next = slot->next->next;
-			delete slot->next;
-			slot->next = next;
+			removeSlot(i);
+			delete slot;
+			i = 0;
 		} else {
-			slot = slot->next;
+			++i;
 		}
 	}
 
@@ -188,3 +250,24 @@ void DefaultTimerManager::removeTimerProc(TimerProc callback) {
 			_callbacks.erase(i);
 	}
 }
+
+void DefaultTimerManager::getStats(Common::Array<TimerStats> &stats) {
+	Common::StackLock lock(_mutex);
+
+	Common::Array<TimerSlot *> slots(_queue);
+	Common::sort(slots.begin(), slots.end(), firesBefore);
+
+	stats.clear();
+	for (uint i = 0; i < slots.size(); ++i) {
+		stats.push_back(slots[i]->stats);
+		stats.back().id = slots[i]->id;
+		stats.back().interval = slots[i]->interval;
+	}
+}
+
+void DefaultTimerManager::resetStats() {
+	Common::StackLock lock(_mutex);
+
+	for (uint i = 0; i < _queue.size(); ++i)
+		_queue[i]->stats = TimerStats();
+}
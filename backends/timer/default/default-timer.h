@@ -22,6 +22,7 @@
 #ifndef BACKENDS_TIMER_DEFAULT_H
 #define BACKENDS_TIMER_DEFAULT_H
 
+#include "common/array.h"
 #include "common/str.h"
 #include "common/hash-str.h"
 #include "common/timer.h"
@@ -34,16 +35,45 @@ private:
 	typedef Common::HashMap<Common::String, TimerProc, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> TimerSlotMap;
 
 	Common::Mutex _mutex;
-	TimerSlot *_head;
 	TimerSlotMap _callbacks;
 
+	/**
+	 * The installed timers, as a binary min-heap ordered by the time of
+	 * their next invocation.
+	 */
+	Common::Array<TimerSlot *> _queue;
+
+	/**
+	 * The timer whose callback is currently running. This is reset when
+	 * the callback removes its own timer.
+	 */
+	TimerSlot *_runningSlot;
+
+	/** Counter used to keep timers due at the same time in insertion order. */
+	uint32 _nextSequence;
+
 	uint32 _timerCallbackNext;
 
+	void pushSlot(TimerSlot *slot);
+	void removeSlot(uint index);
+	void siftUp(uint index);
+	void siftDown(uint index);
+
+	/**
+	 * Update the profiling counters of a timer after its callback ran, and
+	 * after the timer has been rescheduled. The scheduled and start times
+	 * are based on getMillis(), in microseconds. The callback time is
+	 * measured with getMicros().
+	 */
+	void recordCall(TimerSlot *slot, uint64 scheduledTime, uint64 startTime, uint32 callbackTime);
+
 public:
 	DefaultTimerManager();
 	virtual ~DefaultTimerManager();
 	virtual bool installTimerProc(TimerProc proc, int32 interval, void *refCon, const Common::String &id);
 	virtual void removeTimerProc(TimerProc proc);
+	virtual void getStats(Common::Array<TimerStats> &stats);
+	virtual void resetStats();
 
 	/**
 	 * Timer callback, to be invoked at regular time intervals by the backend.
@@ -313,6 +313,8 @@ void registerDefaults() {
 	ConfMan.registerDefault("speech_mute", false);
 	ConfMan.registerDefault("mute", false);
 
+	ConfMan.registerDefault("resampler", "linear");
+
 	ConfMan.registerDefault("multi_midi", false);
 	ConfMan.registerDefault("native_mt32", false);
 	ConfMan.registerDefault("dump_midi", false);
@@ -326,6 +328,8 @@ void registerDefaults() {
 
 	ConfMan.registerDefault("cdrom", 0);
 
+	ConfMan.registerDefault("enable_detection_cache", true);
+	ConfMan.registerDefault("enable_icon_cache", true);
 	ConfMan.registerDefault("enable_unsupported_game_warning", true);
 
 #ifdef USE_FLUIDSYNTH
@@ -342,6 +346,7 @@ void registerDefaults() {
 	ConfMan.registerDefault("save_slot", -1);
 	ConfMan.registerDefault("autosave_period", 5 * 60); // By default, trigger autosave every 5 minutes
 	ConfMan.registerDefault("engine_speed", 60); // FPS limit for 3D games
+	ConfMan.registerDefault("archive_cache_size", 16 * 1024); // In kilobytes
 
 #if defined(ENABLE_SCUMM) || defined(ENABLE_SWORD2)
 	ConfMan.registerDefault("object_labels", true);
@@ -56,6 +56,7 @@
 #include "gui/gui-manager.h"
 #include "gui/error.h"
 #include "gui/message.h"
+#include "gui/saveload-dialog.h"
 
 #include "audio/mididrv.h"
 #include "audio/musicplugin.h"  /* for music manager */
@@ -253,6 +254,9 @@ static Common::Error runGame(const Plugin *enginePlugin, OSystem &system, const
 		system.setWindowCaption(caption.decode());
 	}
 
+	// Apply the game specific budget for cached archive contents
+	Common::MemcachingCaseInsensitiveArchive::setCacheBudget(ConfMan.getInt("archive_cache_size") * 1024);
+
 	//
 	// Setup various paths in the SearchManager
 	//
@@ -891,6 +895,7 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 #endif
 #endif
 	PluginManager::destroy();
+	GUI::SaveMetaInfoLoader::destroy();
 	GUI::GuiManager::destroy();
 	Common::ConfigManager::destroy();
 	Common::DebugManager::destroy();
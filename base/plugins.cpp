@@ -692,24 +692,31 @@ DetectionResults EngineManager::detectGames(const Common::FSList &fslist, uint32
 	// Iterate over all known games and for each check if it might be
 	// the game in the presented directory.
 	for (iter = plugins.begin(); iter != plugins.end(); ++iter) {
-		MetaEngineDetection &metaEngine = (*iter)->get<MetaEngineDetection>();
-		// set the debug flags
-		DebugMan.addAllDebugChannels(metaEngine.getDebugChannels());
-		DetectedGames engineCandidates = metaEngine.detectGames(fslist, skipADFlags, skipIncomplete);
-
-		for (uint i = 0; i < engineCandidates.size(); i++) {
-			engineCandidates[i].path = fslist.begin()->getParent().getPath();
-			engineCandidates[i].shortPath = fslist.begin()->getParent().getDisplayName();
-			candidates.push_back(engineCandidates[i]);
-		}
+		DetectedGames engineCandidates = detectGames(*iter, fslist, skipADFlags, skipIncomplete);
+		candidates.push_back(engineCandidates);
 	}
 
 	// Close all archives that were opened during detection
 	ADCacheMan.clearArchives();
+	ADCacheMan.savePersistentCache();
 
 	return DetectionResults(candidates);
 }
 
+DetectedGames EngineManager::detectGames(const Plugin *plugin, const Common::FSList &fslist, uint32 skipADFlags, bool skipIncomplete) {
+	MetaEngineDetection &metaEngine = plugin->get<MetaEngineDetection>();
+	// set the debug flags
+	DebugMan.addAllDebugChannels(metaEngine.getDebugChannels());
+	DetectedGames engineCandidates = metaEngine.detectGames(fslist, skipADFlags, skipIncomplete);
+
+	for (uint i = 0; i < engineCandidates.size(); i++) {
+		engineCandidates[i].path = fslist.begin()->getParent().getPath();
+		engineCandidates[i].shortPath = fslist.begin()->getParent().getDisplayName();
+	}
+
+	return engineCandidates;
+}
+
 const PluginList &EngineManager::getPlugins(const PluginType fetchPluginType) const {
 	return PluginManager::instance().getPlugins(fetchPluginType);
 }
@@ -20,8 +20,13 @@
  */
 
 #include "common/archive.h"
+#include "common/config-manager.h"
 #include "common/file.h"
 #include "common/fs.h"
+#include "common/hash-ptr.h"
+#include "common/list.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
 #include "common/system.h"
 #include "common/textconsole.h"
 #include "common/memstream.h"
@@ -30,6 +35,160 @@
 
 namespace Common {
 
+/**
+ * Keeps the most recently used contents of all memcaching archives
+ * strongly referenced, so they survive their streams being closed.
+ * The least recently used contents are dropped once the total size
+ * exceeds the budget.
+ *
+ * Reference counts are not atomic, so contents are only ever released
+ * by the thread using their archive. Evicted contents of other archives
+ * are released by the next touch() of their archive.
+ */
+class ArchiveContentsCache : public Singleton<ArchiveContentsCache> {
+public:
+	enum {
+		kDefaultBudget = 16 * 1024 * 1024
+	};
+
+	/**
+	 * Mark the given contents as just used, adding them to the cache if
+	 * needed.
+	 */
+	void touch(const MemcachingCaseInsensitiveArchive *owner, const SharedPtr<byte> &contents, uint32 size);
+
+	/**
+	 * Drop all contents of an archive which is being destroyed, including
+	 * evicted ones which haven't been released yet.
+	 */
+	void removeArchive(const MemcachingCaseInsensitiveArchive *owner);
+
+	void setBudget(uint32 budget);
+
+private:
+	friend class Singleton<SingletonBaseType>;
+	ArchiveContentsCache();
+
+	struct Entry {
+		const MemcachingCaseInsensitiveArchive *owner;
+		SharedPtr<byte> contents;
+		uint32 size;
+		bool evicted; // Waiting to be released by the thread using the owner
+	};
+	typedef List<Entry> EntryList;
+
+	/** Evict until the budget is met, releasing the contents of @p caller right away. */
+	void evict(const MemcachingCaseInsensitiveArchive *caller);
+	/** Release the evicted contents of an archive. */
+	void releaseEvicted(const MemcachingCaseInsensitiveArchive *owner);
+
+	Mutex _mutex;
+	EntryList _entries; // Most recently used first, evicted ones at the end
+	HashMap<const byte *, EntryList::iterator> _index; // Entries which are not evicted
+	uint32 _size;
+	uint32 _budget;
+	uint32 _evictedCount;
+};
+
+ArchiveContentsCache::ArchiveContentsCache() : _size(0), _budget(kDefaultBudget), _evictedCount(0) {
+	if (ConfMan.hasKey("archive_cache_size"))
+		_budget = ConfMan.getInt("archive_cache_size") * 1024;
+}
+
+void ArchiveContentsCache::touch(const MemcachingCaseInsensitiveArchive *owner, const SharedPtr<byte> &contents, uint32 size) {
+	StackLock lock(_mutex);
+
+	releaseEvicted(owner);
+
+	HashMap<const byte *, EntryList::iterator>::iterator i = _index.find(contents.get());
+	if (i != _index.end()) {
+		// Move to the front
+		_entries.push_front(*i->_value);
+		_entries.erase(i->_value);
+		i->_value = _entries.begin();
+		return;
+	}
+
+	// Don't let a single huge file flush everything else
+	if (size > _budget / 2)
+		return;
+
+	Entry entry;
+	entry.owner = owner;
+	entry.contents = contents;
+	entry.size = size;
+	entry.evicted = false;
+	_entries.push_front(entry);
+	_index[contents.get()] = _entries.begin();
+	_size += size;
+
+	debugC(2, kDebugLevelArchiveCache, "ArchiveContentsCache: Added %u bytes, %u of %u bytes used", size, _size, _budget);
+
+	evict(owner);
+}
+
+void ArchiveContentsCache::removeArchive(const MemcachingCaseInsensitiveArchive *owner) {
+	StackLock lock(_mutex);
+
+	for (EntryList::iterator i = _entries.begin(); i != _entries.end(); ) {
+		if (i->owner != owner) {
+			++i;
+		} else if (i->evicted) {
+			_evictedCount--;
+			i = _entries.erase(i);
+		} else {
+			_size -= i->size;
+			_index.erase(i->contents.get());
+			i = _entries.erase(i);
+		}
+	}
+}
+
+void ArchiveContentsCache::setBudget(uint32 budget) {
+	StackLock lock(_mutex);
+
+	_budget = budget;
+	evict(nullptr);
+}
+
+void ArchiveContentsCache::evict(const MemcachingCaseInsensitiveArchive *caller) {
+	uint32 evicted = 0;
+	EntryList::iterator i = _entries.end();
+	while (_size > _budget && i != _entries.begin()) {
+		--i;
+		if (i->evicted)
+			continue;
+
+		_size -= i->size;
+		evicted += i->size;
+		_index.erase(i->contents.get());
+
+		if (i->owner == caller) {
+			i = _entries.erase(i);
+		} else {
+			i->evicted = true;
+			_evictedCount++;
+		}
+	}
+
+	if (evicted)
+		debugC(1, kDebugLevelArchiveCache, "ArchiveContentsCache: Evicted %u bytes, %u of %u bytes used", evicted, _size, _budget);
+}
+
+void ArchiveContentsCache::releaseEvicted(const MemcachingCaseInsensitiveArchive *owner) {
+	if (!_evictedCount)
+		return;
+
+	for (EntryList::iterator i = _entries.begin(); i != _entries.end(); ) {
+		if (i->evicted && i->owner == owner) {
+			_evictedCount--;
+			i = _entries.erase(i);
+		} else {
+			++i;
+		}
+	}
+}
+
 ArchiveMember::~ArchiveMember() {
 }
 
@@ -176,6 +335,15 @@ char Archive::getPathSeparator() const {
 	return '/';
 }
 
+MemcachingCaseInsensitiveArchive::~MemcachingCaseInsensitiveArchive() {
+	if (ArchiveContentsCache::hasInstance())
+		ArchiveContentsCache::instance().removeArchive(this);
+}
+
+void MemcachingCaseInsensitiveArchive::setCacheBudget(uint32 budget) {
+	ArchiveContentsCache::instance().setBudget(budget);
+}
+
 SeekableReadStream *MemcachingCaseInsensitiveArchive::createReadStreamForMember(const Path &path) const {
 	return createReadStreamForMemberImpl(path, false, Common::AltStreamType::Invalid);
 }
@@ -227,12 +395,15 @@ SeekableReadStream *MemcachingCaseInsensitiveArchive::createReadStreamForMemberI
 	if (entry->isFileMissing())
 		return nullptr;
 
+	debugC(3, kDebugLevelArchiveCache, "ArchiveContentsCache: %s '%s'", isNew ? "Read" : "Reused", cacheKey.path.toString().c_str());
+
 	// Now we have a valid contents reference. Make stream for it.
 	Common::MemoryReadStream *memStream = new Common::MemoryReadStream(entry->getContents(), entry->getSize());
 
-	// If the entry was just created and it's too big for strong caching,
-	// mark the copy in cache as weak
-	if (isNew && entry->getSize() > _maxStronglyCachedSize) {
+	// If the entry is too big for strong caching, mark the copy in cache
+	// as weak, and leave it to the global cache whether to keep it around
+	if (entry->getSize() > _maxStronglyCachedSize) {
+		ArchiveContentsCache::instance().touch(this, entry->getContents(), entry->getSize());
 		entry->makeWeak();
 	}
 
@@ -575,5 +746,6 @@ void SearchManager::clear() {
 }
 
 DECLARE_SINGLETON(SearchManager);
+DECLARE_SINGLETON(ArchiveContentsCache);
 
 } // namespace Common
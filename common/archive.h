@@ -269,6 +269,7 @@ private:
 class MemcachingCaseInsensitiveArchive : public Archive {
 public:
 	MemcachingCaseInsensitiveArchive(uint32 maxStronglyCachedSize = 512) : _maxStronglyCachedSize(maxStronglyCachedSize) {}
+	~MemcachingCaseInsensitiveArchive();
 	SeekableReadStream *createReadStreamForMember(const Path &path) const;
 	SeekableReadStream *createReadStreamForMemberAltStream(const Path &path, Common::AltStreamType altStreamType) const;
 
@@ -279,6 +280,16 @@ public:
 	virtual SharedArchiveContents readContentsForPath(const Path &translatedPath) const = 0;
 	virtual SharedArchiveContents readContentsForPathAltStream(const Path &translatedPath, AltStreamType altStreamType) const;
 
+	/**
+	 * Set how many bytes of recently used contents, which are too big to
+	 * be cached permanently, are kept in memory across all memcaching
+	 * archives once their streams have been closed.
+	 *
+	 * The initial value is taken from the "archive_cache_size"
+	 * configuration key, in kilobytes.
+	 */
+	static void setCacheBudget(uint32 budget);
+
 private:
 	struct CacheKey {
 		CacheKey();
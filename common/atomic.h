@@ -0,0 +1,153 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef COMMON_ATOMIC_H
+#define COMMON_ATOMIC_H
+
+#include "common/scummsys.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+// See common/intrinsics.h for why setjmp and longjmp need this
+#undef setjmp
+#undef longjmp
+#include <intrin.h>
+#ifndef FORBIDDEN_SYMBOL_EXCEPTION_setjmp
+#undef setjmp
+#define setjmp(a)	FORBIDDEN_SYMBOL_REPLACEMENT
+#endif
+#ifndef FORBIDDEN_SYMBOL_EXCEPTION_longjmp
+#undef longjmp
+#define longjmp(a,b)	FORBIDDEN_SYMBOL_REPLACEMENT
+#endif
+#endif
+
+namespace Common {
+
+/**
+ * @defgroup common_atomic Atomic operations
+ * @ingroup common
+ *
+ * @brief Minimal atomic operations for sharing data between threads without a mutex.
+ * @{
+ */
+
+/**
+ * Read a 32-bit value written by another thread through atomicStoreRelease().
+ * Any memory writes the other thread made before that store are visible
+ * after this load.
+ */
+inline uint32 atomicLoadAcquire(const volatile uint32 *ptr) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#elif defined(_MSC_VER)
+	uint32 val = *ptr;
+#if defined(_M_ARM) || defined(_M_ARM64)
+	__dmb(_ARM64_BARRIER_ISH);
+#else
+	_ReadWriteBarrier();
+#endif
+	return val;
+#else
+	// Assume a single core without reordering
+	return *ptr;
+#endif
+}
+
+/**
+ * Write a 32-bit value which is read by another thread through
+ * atomicLoadAcquire(). Any memory writes made before this store are
+ * visible to the other thread once it has loaded the value.
+ */
+inline void atomicStoreRelease(volatile uint32 *ptr, uint32 val) {
+#if defined(__GNUC__) || defined(__clang__)
+	__atomic_store_n(ptr, val, __ATOMIC_RELEASE);
+#elif defined(_MSC_VER)
+#if defined(_M_ARM) || defined(_M_ARM64)
+	__dmb(_ARM64_BARRIER_ISH);
+#else
+	_ReadWriteBarrier();
+#endif
+	*ptr = val;
+#else
+	// Assume a single core without reordering
+	*ptr = val;
+#endif
+}
+
+/**
+ * Add a value to a 32-bit value shared with other threads and return the
+ * previous value. Acts as a full memory barrier.
+ */
+inline uint32 atomicFetchAdd(volatile uint32 *ptr, uint32 val) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __atomic_fetch_add(ptr, val, __ATOMIC_SEQ_CST);
+#elif defined(_MSC_VER)
+	return (uint32)_InterlockedExchangeAdd((volatile long *)ptr, (long)val);
+#else
+	// Assume a single core without reordering
+	uint32 old = *ptr;
+	*ptr = old + val;
+	return old;
+#endif
+}
+
+/**
+ * Replace a 32-bit value shared with other threads and return the previous
+ * value. Acts as a full memory barrier.
+ */
+inline uint32 atomicExchange(volatile uint32 *ptr, uint32 val) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __atomic_exchange_n(ptr, val, __ATOMIC_SEQ_CST);
+#elif defined(_MSC_VER)
+	return (uint32)_InterlockedExchange((volatile long *)ptr, (long)val);
+#else
+	// Assume a single core without reordering
+	uint32 old = *ptr;
+	*ptr = val;
+	return old;
+#endif
+}
+
+/**
+ * Replace a 32-bit value shared with other threads by @p desired if it is
+ * equal to @p expected. Returns true if the value was replaced. Acts as a
+ * full memory barrier.
+ */
+inline bool atomicCompareExchange(volatile uint32 *ptr, uint32 expected, uint32 desired) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __atomic_compare_exchange_n(ptr, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#elif defined(_MSC_VER)
+	return (uint32)_InterlockedCompareExchange((volatile long *)ptr, (long)desired, (long)expected) == expected;
+#else
+	// Assume a single core without reordering
+	if (*ptr != expected)
+		return false;
+	*ptr = desired;
+	return true;
+#endif
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
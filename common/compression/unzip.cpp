@@ -92,9 +92,15 @@ typedef Byte Bytef;
 #endif
 
 #include "common/fs.h"
+#include "common/array.h"
+#include "common/atomic.h"
+#include "common/bufferedstream.h"
 #include "common/compression/deflate.h"
 #include "common/compression/unzip.h"
 #include "common/memstream.h"
+#include "common/mutex.h"
+#include "common/ptr.h"
+#include "common/substream.h"
 
 #include "common/hashmap.h"
 #include "common/hash-str.h"
@@ -237,6 +243,15 @@ Common::SharedArchiveContents unzOpenCurrentFile(unzFile file
   If there is no error, the return value is UNZ_OK.
 */
 
+Common::SeekableReadStream *unzOpenCurrentFileStream(unzFile file);
+/*
+  Open the current file in the zipfile as a stream reading directly from the
+  zipfile, instead of decompressing it into memory as a whole.
+  Every access to the zipfile from the stream is guarded by the given mutex.
+  The stream must not outlive the zipfile.
+  Return NULL if there is an error.
+*/
+
 int unzCloseCurrentFile(unzFile file);
 /*
   Close the file in zip opened with unzOpenCurrentFile
@@ -284,6 +299,18 @@ int unzGetLocalExtrafield(unzFile file, voidp buf, unsigned len);
 #define UNZ_MAXFILENAMEINZIP (256)
 #endif
 
+/* members larger than this are streamed from the zipfile instead of being
+   decompressed into memory as a whole */
+#ifndef UNZ_STREAMING_THRESHOLD
+#define UNZ_STREAMING_THRESHOLD (4 * 1024 * 1024)
+#endif
+
+/* distance between two inflate checkpoints of a streamed member, in
+   uncompressed bytes */
+#ifndef UNZ_CHECKPOINT_SPACING
+#define UNZ_CHECKPOINT_SPACING (1024 * 1024)
+#endif
+
 #define SIZECENTRALDIRITEM (0x2e)
 #define SIZEZIPLOCALHEADER (0x1e)
 
@@ -321,10 +348,55 @@ typedef struct {
 typedef Common::HashMap<Common::Path, cached_file_in_zip, Common::Path::IgnoreCase_Hash,
 	Common::Path::IgnoreCase_EqualTo> ZipHash;
 
+namespace Common {
+
+/**
+ * The zipfile stream and the mutex guarding it. Streamed members hold a
+ * reference, so they stay readable after the archive has been deleted.
+ */
+class ZipSharedStream {
+public:
+	ZipSharedStream(SeekableReadStream *stream) : _stream(stream), _refCount(1) {}
+
+	void incRef() { atomicFetchAdd(&_refCount, 1); }
+	void decRef() {
+		if (atomicFetchAdd(&_refCount, (uint32)-1) == 1)
+			delete this;
+	}
+
+	SeekableReadStream *getStream() const { return _stream.get(); }
+	Mutex &getMutex() { return _mutex; }
+
+private:
+	ScopedPtr<SeekableReadStream> _stream;
+	Mutex _mutex;
+	volatile uint32 _refCount;
+};
+
+/**
+ * A part of the zipfile stream, which keeps the zipfile stream alive for
+ * as long as it is used.
+ */
+class ZipMemberReadStream : public SafeMutexedSeekableSubReadStream {
+public:
+	ZipMemberReadStream(ZipSharedStream *shared, uint32 begin, uint32 end)
+		: SafeMutexedSeekableSubReadStream(shared->getStream(), begin, end, DisposeAfterUse::NO, shared->getMutex()),
+		  _shared(shared) {
+		_shared->incRef();
+	}
+	~ZipMemberReadStream() override { _shared->decRef(); }
+
+private:
+	ZipSharedStream *_shared;
+};
+
+} // End of namespace Common
+
 /* unz_s contain internal information about the zipfile
 */
 typedef struct {
 	Common::SeekableReadStream *_stream;				/* io structore of the zipfile */
+	Common::ZipSharedStream *_shared;	/* owner of _stream, shared with streamed members */
 	unz_global_info gi;				/* public global information */
 	uLong byte_before_the_zipfile;	/* byte before the zipfile, (>0 for sfx)*/
 	uLong num_file;					/* number of the current file in the zipfile*/
@@ -515,6 +587,7 @@ unzFile unzOpen(Common::SeekableReadStream *stream, bool flattenTree) {
 		return nullptr;
 	}
 
+	us->_shared = new Common::ZipSharedStream(stream);
 	us->byte_before_the_zipfile = central_pos -
 		                    (us->offset_central_dir + us->size_central_dir);
 	us->central_pos = central_pos;
@@ -600,7 +673,7 @@ int unzClose(unzFile file) {
 		return UNZ_PARAMERROR;
 	s = (unz_s *)file;
 
-	delete s->_stream;
+	s->_shared->decRef();
 	delete s;
 	return UNZ_OK;
 }
@@ -1018,6 +1091,328 @@ Common::SharedArchiveContents unzOpenCurrentFile (unzFile file
 	return Common::SharedArchiveContents(uncompressedBuffer, s->cur_file_info.uncompressed_size);
 }
 
+#ifdef USE_ZLIB
+namespace Common {
+
+/**
+ * Streams a deflated member of a zip file, inflating it on demand.
+ *
+ * The decompressor state is saved every UNZ_CHECKPOINT_SPACING bytes of
+ * output, so a backward seek only has to inflate from the closest checkpoint
+ * instead of from the start of the member. The last 32KB of output are kept
+ * around, so short backward seeks don't need to inflate anything. The CRC
+ * is checked once every byte of the member has been inflated.
+ */
+class ZipInflateReadStream : public SeekableReadStream {
+public:
+	ZipInflateReadStream(SeekableReadStream *input, uint32 size, uint32 crc);
+	~ZipInflateReadStream();
+
+	bool err() const override { return _err; }
+	void clearErr() override { _eos = false; }
+	bool eos() const override { return _eos; }
+
+	uint32 read(void *dataPtr, uint32 dataSize) override;
+
+	int64 pos() const override { return _pos; }
+	int64 size() const override { return _size; }
+	bool seek(int64 offset, int whence = SEEK_SET) override;
+
+private:
+	enum {
+		kWindowSize = 32768 // 1 << MAX_WBITS
+	};
+
+	struct Checkpoint {
+		uint32 outPos; // position in the uncompressed data
+		uint32 inPos;  // position of the next unused byte in the compressed data
+		int bits;      // number of bits of the byte before inPos still to be used
+		byte *window;  // the kWindowSize bytes of output before outPos
+	};
+
+	bool inflateMore();
+	void addCheckpoint();
+	bool restoreCheckpoint(const Checkpoint *checkpoint);
+
+	ScopedPtr<SeekableReadStream> _input;
+	z_stream _zStream;
+	bool _err;
+	bool _eos;
+	bool _streamEnd;
+
+	uint32 _size;
+	uint32 _pos;    // position of the reader
+	uint32 _outPos; // amount of data inflated into _window
+	uint32 _inPos;  // amount of data read from _input
+
+	byte _inBuf[UNZ_BUFSIZE];
+	byte _window[kWindowSize];
+	Array<Checkpoint> _checkpoints;
+
+	uint32 _crcExpected;
+	uint32 _crc;
+	uint32 _crcPos;
+};
+
+ZipInflateReadStream::ZipInflateReadStream(SeekableReadStream *input, uint32 size, uint32 crc)
+	: _input(input), _zStream(), _err(false), _eos(false), _streamEnd(false),
+	  _size(size), _pos(0), _outPos(0), _inPos(0),
+	  _crcExpected(crc), _crc(crc32(0, nullptr, 0)), _crcPos(0) {
+	assert(input);
+
+	// Negative MAX_WBITS tells zlib there's no zlib header
+	if (inflateInit2(&_zStream, -MAX_WBITS) != Z_OK)
+		_err = true;
+
+	_zStream.next_in = _inBuf;
+	_zStream.avail_in = 0;
+}
+
+ZipInflateReadStream::~ZipInflateReadStream() {
+	inflateEnd(&_zStream);
+
+	for (uint i = 0; i < _checkpoints.size(); i++)
+		delete[] _checkpoints[i].window;
+}
+
+bool ZipInflateReadStream::inflateMore() {
+	if (_err || _streamEnd)
+		return false;
+
+	// Inflate up to the end of the circular window
+	const uint32 start = _outPos % kWindowSize;
+	_zStream.next_out = _window + start;
+	_zStream.avail_out = kWindowSize - start;
+
+	while (_zStream.avail_out) {
+		if (_zStream.avail_in == 0) {
+			_zStream.next_in = _inBuf;
+			_zStream.avail_in = _input->read(_inBuf, UNZ_BUFSIZE);
+			_inPos += _zStream.avail_in;
+			if (_zStream.avail_in == 0) {
+				warning("ZipInflateReadStream: Unexpected end of compressed data");
+				_err = true;
+				break;
+			}
+		}
+
+		byte *out = _zStream.next_out;
+		// Z_BLOCK returns at the end of every deflate block, where the
+		// decompressor state is small enough to save
+		const int zErr = inflate(&_zStream, Z_BLOCK);
+		const uint32 produced = _zStream.next_out - out;
+
+		// Only add data which hasn't been checksummed yet, since inflating
+		// may resume from a checkpoint before _crcPos
+		if (_crcPos >= _outPos && _crcPos < _outPos + produced) {
+			const uint32 skip = _crcPos - _outPos;
+			_crc = crc32(_crc, out + skip, produced - skip);
+			_crcPos = _outPos + produced;
+			if (_crcPos == _size && _crc != _crcExpected) {
+				warning("CRC32 mismatch: %08x, %08x", _crc, _crcExpected);
+				_err = true;
+			}
+		}
+		_outPos += produced;
+
+		if (zErr == Z_STREAM_END) {
+			_streamEnd = true;
+			break;
+		} else if (zErr != Z_OK) {
+			warning("ZipInflateReadStream: Error %d while inflating", zErr);
+			_err = true;
+			break;
+		}
+
+		// At the end of a block which isn't the last one
+		if ((_zStream.data_type & 128) && !(_zStream.data_type & 64))
+			addCheckpoint();
+
+		// Hand out what we have rather than filling the whole window
+		if (produced)
+			break;
+	}
+
+	return _zStream.avail_out != kWindowSize - start;
+}
+
+void ZipInflateReadStream::addCheckpoint() {
+	const uint32 lastPos = _checkpoints.empty() ? 0 : _checkpoints.back().outPos;
+	if (_outPos < kWindowSize || _outPos < lastPos + UNZ_CHECKPOINT_SPACING || _outPos >= _size)
+		return;
+
+	Checkpoint checkpoint;
+	checkpoint.outPos = _outPos;
+	checkpoint.inPos = _inPos - _zStream.avail_in;
+	checkpoint.bits = _zStream.data_type & 7;
+
+	// Store the window in order, oldest byte first
+	const uint32 split = _outPos % kWindowSize;
+	checkpoint.window = new byte[kWindowSize];
+	memcpy(checkpoint.window, _window + split, kWindowSize - split);
+	memcpy(checkpoint.window + kWindowSize - split, _window, split);
+
+	_checkpoints.push_back(checkpoint);
+}
+
+bool ZipInflateReadStream::restoreCheckpoint(const Checkpoint *checkpoint) {
+	if (inflateReset(&_zStream) != Z_OK) {
+		_err = true;
+		return false;
+	}
+
+	_zStream.next_in = _inBuf;
+	_zStream.avail_in = 0;
+	_streamEnd = false;
+
+	if (!checkpoint) {
+		// Start over
+		_input->seek(0);
+		_inPos = 0;
+		_outPos = 0;
+		return true;
+	}
+
+	// A block may start in the middle of a byte, in which case the
+	// remaining bits of that byte have to be fed to zlib first
+	_inPos = checkpoint->inPos - (checkpoint->bits ? 1 : 0);
+	_input->seek(_inPos);
+	if (checkpoint->bits) {
+		const byte lastByte = _input->readByte();
+		_inPos++;
+		inflatePrime(&_zStream, checkpoint->bits, lastByte >> (8 - checkpoint->bits));
+	}
+
+	if (_input->err() || inflateSetDictionary(&_zStream, checkpoint->window, kWindowSize) != Z_OK) {
+		_err = true;
+		return false;
+	}
+
+	// Restore the window as well, so short backward seeks stay cheap
+	const uint32 split = checkpoint->outPos % kWindowSize;
+	memcpy(_window + split, checkpoint->window, kWindowSize - split);
+	memcpy(_window, checkpoint->window + kWindowSize - split, split);
+
+	_outPos = checkpoint->outPos;
+	return true;
+}
+
+uint32 ZipInflateReadStream::read(void *dataPtr, uint32 dataSize) {
+	byte *dst = (byte *)dataPtr;
+	uint32 total = 0;
+
+	while (total < dataSize && _pos < _size) {
+		if (_pos == _outPos && !inflateMore())
+			break;
+
+		const uint32 start = _pos % kWindowSize;
+		const uint32 count = MIN(MIN(dataSize - total, _outPos - _pos), (uint32)kWindowSize - start);
+		memcpy(dst + total, _window + start, count);
+		_pos += count;
+		total += count;
+	}
+
+	if (total < dataSize)
+		_eos = true;
+
+	return total;
+}
+
+bool ZipInflateReadStream::seek(int64 offset, int whence) {
+	int64 newPos;
+	switch (whence) {
+	case SEEK_END:
+		newPos = _size + offset;
+		break;
+	case SEEK_CUR:
+		newPos = _pos + offset;
+		break;
+	case SEEK_SET:
+	default:
+		newPos = offset;
+		break;
+	}
+
+	if (newPos < 0 || newPos > _size)
+		return false;
+
+	_eos = false;
+
+	const uint32 target = (uint32)newPos;
+	const uint32 windowStart = _outPos > kWindowSize ? _outPos - kWindowSize : 0;
+	if (target >= windowStart && target <= _outPos) {
+		// Still in the window
+		_pos = target;
+		return true;
+	}
+
+	// Find the closest checkpoint before the target
+	const Checkpoint *checkpoint = nullptr;
+	for (uint i = 0; i < _checkpoints.size() && _checkpoints[i].outPos <= target; i++)
+		checkpoint = &_checkpoints[i];
+
+	if (target < _outPos || (checkpoint && checkpoint->outPos > _outPos)) {
+		if (!restoreCheckpoint(checkpoint))
+			return false;
+	}
+
+	// Skip ahead, the data ends up in the window
+	while (_outPos < target) {
+		if (!inflateMore()) {
+			_pos = _outPos;
+			return false;
+		}
+	}
+
+	_pos = target;
+	return true;
+}
+
+} // End of namespace Common
+#endif
+
+/*
+  Open the current file in the zipfile as a stream.
+*/
+Common::SeekableReadStream *unzOpenCurrentFileStream(unzFile file) {
+	uInt iSizeVar;
+	unz_s *s;
+	uLong offset_local_extrafield;  /* offset of the local extra field */
+	uInt  size_local_extrafield;    /* size of the local extra field */
+
+	if (file == nullptr)
+		return nullptr;
+	s = (unz_s *)file;
+	if (!s->current_file_ok)
+		return nullptr;
+
+	if (unzlocal_CheckCurrentFileCoherencyHeader(s, &iSizeVar,
+				&offset_local_extrafield, &size_local_extrafield) != UNZ_OK)
+		return nullptr;
+
+	const uint32 dataOffset = s->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + iSizeVar;
+	Common::SeekableReadStream *input = new Common::ZipMemberReadStream(s->_shared,
+			dataOffset, dataOffset + s->cur_file_info.compressed_size);
+
+	switch (s->cur_file_info.compression_method) {
+	case 0: // Store
+		// Add buffering, since every read of the substream locks and seeks
+		return Common::wrapBufferedSeekableReadStream(input, 4096, DisposeAfterUse::YES);
+	case Z_DEFLATED:
+#ifdef USE_ZLIB
+		return new Common::ZipInflateReadStream(input, s->cur_file_info.uncompressed_size, s->cur_file_info.crc);
+#else
+		// GZio has no checkpoints, so backward seeks restart from the beginning
+		return Common::wrapDeflateReadStream(input, DisposeAfterUse::YES, s->cur_file_info.uncompressed_size);
+#endif
+	default:
+		warning("Unknown compression algoritthm %d", (int)s->cur_file_info.compression_method);
+		delete input;
+		return nullptr;
+	}
+}
+
+
 
 namespace Common {
 
@@ -1043,6 +1438,8 @@ public:
 	Common::Path translatePath(const Common::Path &path) const override {
 		return _flattenTree ? path.getLastComponent() : path;
 	}
+
+	bool getMemberChecksum(const Path &path, uint32 &size, uint32 &crc) const;
 };
 
 /*
@@ -1106,9 +1503,36 @@ const ArchiveMemberPtr ZipArchive::getMember(const Path &path) const {
 	return ArchiveMemberPtr(new GenericArchiveMember(path, *this));
 }
 
+bool ZipArchive::getMemberChecksum(const Path &path, uint32 &size, uint32 &crc) const {
+	// The central directory has been read when opening the archive, so
+	// this doesn't touch the zipfile stream
+	const unz_s *const archive = (const unz_s *)_zipFile;
+	ZipHash::const_iterator i = archive->_hash.find(translatePath(path));
+	if (i == archive->_hash.end())
+		return false;
+
+	size = i->_value.cur_file_info.uncompressed_size;
+	crc = i->_value.cur_file_info.crc;
+	return true;
+}
+
 Common::SharedArchiveContents ZipArchive::readContentsForPath(const Common::Path &path) const {
+	// The zipfile stream is shared with streamed members
+	Common::StackLock lock(((unz_s *)_zipFile)->_shared->getMutex());
+
 	if (unzLocateFile(_zipFile, path, 2) != UNZ_OK)
 		return Common::SharedArchiveContents();
+
+	// Large members are streamed instead of being held in memory
+	unz_file_info fi;
+	if (unzGetCurrentFileInfo(_zipFile, &fi, nullptr, 0, nullptr, 0, nullptr, 0) == UNZ_OK &&
+	    fi.uncompressed_size > UNZ_STREAMING_THRESHOLD) {
+		Common::SeekableReadStream *stream = unzOpenCurrentFileStream(_zipFile);
+		if (!stream)
+			return Common::SharedArchiveContents();
+		return Common::SharedArchiveContents::bypass(stream);
+	}
+
 #ifndef USE_ZLIB
 	return unzOpenCurrentFile(_zipFile, _crc);
 #else
@@ -1116,6 +1540,14 @@ Common::SharedArchiveContents ZipArchive::readContentsForPath(const Common::Path
 #endif
 }
 
+bool getZipMemberChecksum(const Archive &archive, const Path &path, uint32 &size, uint32 &crc) {
+	const ZipArchive *zipArchive = dynamic_cast<const ZipArchive *>(&archive);
+	if (!zipArchive)
+		return false;
+
+	return zipArchive->getMemberChecksum(path, size, crc);
+}
+
 Archive *makeZipArchive(const Path &name, bool flattenTree) {
 	return makeZipArchive(SearchMan.createReadStreamForMember(name), flattenTree);
 }
@@ -65,6 +65,15 @@ Archive *makeZipArchive(const FSNode &node, bool flattenTree = false);
  */
 Archive *makeZipArchive(SeekableReadStream *stream, bool flattenTree = false);
 
+/**
+ * Get the uncompressed size and the CRC32 of a member of a ZIP archive, as
+ * recorded in the central directory, without decompressing the member.
+ *
+ * Returns false if the archive was not created by makeZipArchive, or has no
+ * such member.
+ */
+bool getZipMemberChecksum(const Archive &archive, const Path &path, uint32 &size, uint32 &crc);
+
 /** @} */
 
 } // End of namespace Common
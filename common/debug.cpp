@@ -36,6 +36,9 @@ const DebugChannelDef gDebugChannels[] = {
 	{ kDebugGlobalDetection, "detection", "debug messages for advancedDetector" },
 	{ kDebugLevelMainGUI,    "maingui",   "debug messages for GUI" },
 	{ kDebugLevelMacGUI,     "macgui",    "debug messages for MacGUI" },
+	{ kDebugLevelArchiveCache, "archivecache", "debug messages for the archive contents cache" },
+	{ kDebugLevelOpenGLStats, "openglstats", "texture upload statistics of the OpenGL graphics backend" },
+	{ kDebugLevelTimerStats, "timerstats", "timer callbacks overrunning their interval or missing deadlines" },
 	DEBUG_CHANNEL_END
 };
 namespace Common {
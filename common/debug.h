@@ -163,6 +163,9 @@ enum GlobalDebugLevels {
 	kDebugLevelEventRec,
 	kDebugLevelMainGUI,
 	kDebugLevelMacGUI,
+	kDebugLevelArchiveCache,
+	kDebugLevelOpenGLStats,
+	kDebugLevelTimerStats,
 };
 
 /** @} */
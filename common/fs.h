@@ -252,6 +252,18 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Retrieve the size and the last modification time of the file referred
+	 * by this node, without opening it.
+	 *
+	 * The modification time is an opaque value. It is only meaningful when
+	 * compared to an earlier value obtained for the same node.
+	 *
+	 * @return True if the information is available, false otherwise (for example
+	 *         if the node does not exist or the backend cannot provide it).
+	 */
+	bool getFileStats(int64 &size, int64 &modificationTime) const;
+
 	/**
 	 * Create a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
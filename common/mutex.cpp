@@ -46,6 +46,31 @@ bool Mutex::unlock() {
 #pragma mark -
 
 
+ConditionVariable::ConditionVariable() {
+	assert(g_system);
+	_cond = g_system->createConditionVariable();
+}
+
+ConditionVariable::~ConditionVariable() {
+	delete _cond;
+}
+
+bool ConditionVariable::wait(Mutex &mutex) {
+	return !_cond || _cond->wait(mutex._mutex);
+}
+
+bool ConditionVariable::signal() {
+	return !_cond || _cond->signal();
+}
+
+bool ConditionVariable::broadcast() {
+	return !_cond || _cond->broadcast();
+}
+
+
+#pragma mark -
+
+
 StackLock::StackLock(MutexInternal *mutex, const char *mutexName)
 	: _mutex(mutex), _mutexName(mutexName) {
 	lock();
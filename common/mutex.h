@@ -45,6 +45,15 @@ public:
 	virtual bool unlock() = 0;
 };
 
+class ConditionVariableInternal {
+public:
+	virtual ~ConditionVariableInternal() {}
+
+	virtual bool wait(MutexInternal *mutex) = 0;
+	virtual bool signal() = 0;
+	virtual bool broadcast() = 0;
+};
+
 /**
  * Auxiliary class to (un)lock a mutex on the stack.
  */
@@ -66,6 +75,7 @@ public:
  */
 class Mutex {
 	friend class StackLock;
+	friend class ConditionVariable;
 
 	MutexInternal *_mutex;
 
@@ -77,6 +87,34 @@ public:
 	bool unlock();
 };
 
+/**
+ * Wrapper class around the OSystem condition variable functions.
+ *
+ * Backends without thread support do not provide condition variables. As
+ * no other thread can change the condition there, waiting returns at once.
+ */
+class ConditionVariable {
+	ConditionVariableInternal *_cond;
+
+public:
+	ConditionVariable();
+	~ConditionVariable();
+
+	/**
+	 * Unlock the mutex, wait until the condition variable is signalled and
+	 * lock the mutex again. The mutex must be locked exactly once by the
+	 * calling thread. Spurious wakeups are possible, so the condition must
+	 * be checked again after returning.
+	 */
+	bool wait(Mutex &mutex);
+
+	/** Wake up one of the threads waiting on the condition variable. */
+	bool signal();
+
+	/** Wake up all threads waiting on the condition variable. */
+	bool broadcast();
+};
+
 /** @} */
 
 } // End of namespace Common
@@ -276,6 +276,21 @@ public:
 	 * @return true if the file exists. false otherwise.
 	 */
 	virtual bool exists(const String &name) = 0;
+
+	/**
+	 * Retrieve the size and the last modification time of a save file,
+	 * without opening it.
+	 *
+	 * The modification time is an opaque value. It is only meaningful when
+	 * compared to an earlier value obtained for the same save file.
+	 *
+	 * @param name              Name of the save file.
+	 * @param size              Receives the size of the file.
+	 * @param modificationTime  Receives the modification time of the file.
+	 *
+	 * @return true if the information is available, false otherwise.
+	 */
+	virtual bool getSavefileStats(const String &name, int64 &size, int64 &modificationTime) { return false; }
 };
 
 /** @} */
@@ -53,12 +53,15 @@ class Store;
 }
 
 namespace Common {
+class ConditionVariableInternal;
 class EventManager;
 class MutexInternal;
 struct Rect;
 class SaveFileManager;
 class SearchSet;
 class String;
+class ThreadInternal;
+typedef void (*ThreadProc)(void *param);
 #if defined(USE_TASKBAR)
 class TaskbarManager;
 #endif
@@ -1510,6 +1513,15 @@ public:
 	 */
 	virtual uint32 getMillis(bool skipRecord = false) = 0;
 
+	/**
+	 * Get the number of microseconds since the program was started, with
+	 * the best resolution the backend offers.
+	 *
+	 * This is meant for profiling and is never recorded by the event
+	 * recorder. The default implementation is based on getMillis().
+	 */
+	virtual uint64 getMicros() { return (uint64)getMillis(true) * 1000; }
+
 	/** Delay/sleep for the specified amount of milliseconds. */
 	virtual void delayMillis(uint msecs) = 0;
 
@@ -1586,6 +1598,9 @@ public:
 	 *
 	 * Hence, backends that do not use threads to implement the timers can simply
 	 * use dummy implementations for these methods.
+	 *
+	 * Backends which provide worker threads (see @ref common_system_threads)
+	 * need real mutexes.
 	 */
 
 	/**
@@ -1598,6 +1613,46 @@ public:
 	/** @} */
 
 
+	/**
+	 * @defgroup common_system_threads Worker threads
+	 * @ingroup common_system
+	 * @{
+	 *
+	 * Backends may optionally provide worker threads, which are used by
+	 * Common::ThreadPool to spread work over several cores. Code running on
+	 * worker threads must not call into the backend, except for mutexes,
+	 * condition variables and getMillis()/getMicros().
+	 *
+	 * Backends which do not support threads keep the default implementations
+	 * below, and Common::ThreadPool then runs all tasks on the calling thread.
+	 */
+
+	/**
+	 * Create a new thread which calls @p proc with @p param and ends once
+	 * @p proc returns.
+	 *
+	 * @return The newly created thread, or 0 if threads are not supported or
+	 *         an error occurred.
+	 */
+	virtual Common::ThreadInternal *createThread(Common::ThreadProc proc, void *param) { return nullptr; }
+
+	/**
+	 * Create a new condition variable, to be used with mutexes created by
+	 * createMutex().
+	 *
+	 * @return The newly created condition variable, or 0 if threads are not
+	 *         supported or an error occurred.
+	 */
+	virtual Common::ConditionVariableInternal *createConditionVariable() { return nullptr; }
+
+	/**
+	 * Return the number of logical CPU cores worker threads can run on.
+	 */
+	virtual uint getCpuCount() { return 1; }
+
+	/** @} */
+
+
 
 	/** @defgroup common_system_sound Sound
 	 *  @ingroup common_system
@@ -0,0 +1,127 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/threadpool.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+namespace Common {
+
+void Task::wait() {
+	if (isDone())
+		return;
+
+	// Tasks only stay pending while they are queued on a pool with workers
+	assert(_pool);
+	ThreadPool *pool = _pool;
+
+	pool->_mutex.lock();
+	while (!isDone()) {
+		if (!pool->runQueuedTask())
+			pool->_doneCondition.wait(pool->_mutex);
+	}
+	pool->_mutex.unlock();
+}
+
+ThreadPool::ThreadPool(int numThreads) : _quit(false) {
+	if (numThreads < 0)
+		numThreads = (int)g_system->getCpuCount() - 1;
+
+	for (int i = 0; i < numThreads; i++) {
+		ThreadInternal *thread = g_system->createThread(&ThreadPool::workerProc, this);
+		if (!thread)
+			break;
+		_threads.push_back(thread);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	_mutex.lock();
+	_quit = true;
+	_workCondition.broadcast();
+	_mutex.unlock();
+
+	for (uint i = 0; i < _threads.size(); i++) {
+		if (!_threads[i]->join())
+			warning("ThreadPool: Failed to join worker thread");
+		delete _threads[i];
+	}
+
+	// Without workers, tasks never stay queued
+	assert(_queue.empty());
+}
+
+void ThreadPool::enqueue(Task *task) {
+	task->_pool = this;
+
+	if (_threads.empty()) {
+		task->run();
+		finishTask(task);
+		return;
+	}
+
+	_mutex.lock();
+	_queue.push_back(task);
+	_workCondition.signal();
+	_mutex.unlock();
+}
+
+// Must be called with the mutex locked, which is unlocked while the task runs
+bool ThreadPool::runQueuedTask() {
+	if (_queue.empty())
+		return false;
+
+	Task *task = _queue.front();
+	_queue.pop_front();
+
+	_mutex.unlock();
+	task->run();
+	finishTask(task);
+	_mutex.lock();
+	return true;
+}
+
+void ThreadPool::finishTask(Task *task) {
+	_mutex.lock();
+	atomicStoreRelease(&task->_done, 1);
+	_doneCondition.broadcast();
+	_mutex.unlock();
+
+	task->decRef();
+}
+
+void ThreadPool::workerLoop() {
+	_mutex.lock();
+	for (;;) {
+		if (runQueuedTask())
+			continue;
+		if (_quit)
+			break;
+		_workCondition.wait(_mutex);
+	}
+	_mutex.unlock();
+}
+
+void ThreadPool::workerProc(void *param) {
+	static_cast<ThreadPool *>(param)->workerLoop();
+}
+
+} // End of namespace Common
@@ -0,0 +1,296 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_THREADPOOL_H
+#define COMMON_THREADPOOL_H
+
+#include "common/scummsys.h"
+#include "common/array.h"
+#include "common/atomic.h"
+#include "common/list.h"
+#include "common/mutex.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_threadpool Thread pool
+ * @ingroup common
+ *
+ * @brief API for running work on several cores.
+ * @{
+ */
+
+class ThreadInternal {
+public:
+	virtual ~ThreadInternal() {}
+
+	/** Wait until the thread procedure has returned. */
+	virtual bool join() = 0;
+};
+
+class ThreadPool;
+
+/**
+ * A unit of work queued on a ThreadPool. Tasks are reference counted, as
+ * they are shared between the pool and the futures referring to them.
+ */
+class Task {
+	friend class ThreadPool;
+
+public:
+	Task() : _refCount(1), _done(0), _pool(nullptr) {}
+	virtual ~Task() {}
+
+	void incRef() { atomicFetchAdd(&_refCount, 1); }
+	void decRef() {
+		if (atomicFetchAdd(&_refCount, (uint32)-1) == 1)
+			delete this;
+	}
+
+	/** Return whether the task has finished running. */
+	bool isDone() const { return atomicLoadAcquire(&_done) != 0; }
+
+	/**
+	 * Wait until the task has finished running. While waiting, the calling
+	 * thread runs other queued tasks, so waiting from inside a task cannot
+	 * deadlock the pool.
+	 */
+	void wait();
+
+protected:
+	virtual void run() = 0;
+
+private:
+	volatile uint32 _refCount;
+	volatile uint32 _done;
+	ThreadPool *_pool;
+};
+
+template<typename T>
+class ValueTask : public Task {
+public:
+	ValueTask() : _value() {}
+	const T &getValue() const { return _value; }
+
+protected:
+	T _value;
+};
+
+template<>
+class ValueTask<void> : public Task {
+};
+
+template<typename T, typename F>
+class FunctionTask : public ValueTask<T> {
+public:
+	FunctionTask(const F &function) : _function(function) {}
+
+protected:
+	void run() override { this->_value = _function(); }
+
+private:
+	F _function;
+};
+
+template<typename F>
+class FunctionTask<void, F> : public ValueTask<void> {
+public:
+	FunctionTask(const F &function) : _function(function) {}
+
+protected:
+	void run() override { _function(); }
+
+private:
+	F _function;
+};
+
+/**
+ * A handle to the result of a task submitted to a ThreadPool.
+ */
+template<typename T>
+class FutureBase {
+public:
+	FutureBase() : _task(nullptr) {}
+	explicit FutureBase(ValueTask<T> *task) : _task(task) {}
+	FutureBase(const FutureBase &other) : _task(other._task) {
+		if (_task)
+			_task->incRef();
+	}
+	~FutureBase() {
+		if (_task)
+			_task->decRef();
+	}
+
+	FutureBase &operator=(const FutureBase &other) {
+		if (other._task)
+			other._task->incRef();
+		if (_task)
+			_task->decRef();
+		_task = other._task;
+		return *this;
+	}
+
+	/** Return whether this future refers to a task. */
+	bool isValid() const { return _task != nullptr; }
+
+	/** Return whether the result is available. */
+	bool isReady() const { return !_task || _task->isDone(); }
+
+	/** Wait until the result is available. */
+	void wait() const {
+		if (_task)
+			_task->wait();
+	}
+
+protected:
+	ValueTask<T> *_task;
+};
+
+template<typename T>
+class Future : public FutureBase<T> {
+public:
+	Future() {}
+	explicit Future(ValueTask<T> *task) : FutureBase<T>(task) {}
+
+	/** Wait until the result is available and return it. */
+	const T &get() const {
+		assert(this->_task);
+		this->_task->wait();
+		return this->_task->getValue();
+	}
+};
+
+template<>
+class Future<void> : public FutureBase<void> {
+public:
+	Future() {}
+	explicit Future(ValueTask<void> *task) : FutureBase<void>(task) {}
+
+	void get() const { wait(); }
+};
+
+/**
+ * A pool of worker threads running queued tasks.
+ *
+ * Worker threads are created through OSystem::createThread(). If the backend
+ * does not support threads, the pool has no workers and every task runs on
+ * the calling thread as soon as it is submitted.
+ *
+ * Tasks run on worker threads, so they must not call into the backend except
+ * for the functions documented as thread safe in OSystem.
+ */
+class ThreadPool {
+	friend class Task;
+
+public:
+	/**
+	 * Create a pool with the given number of worker threads. By default,
+	 * one worker per CPU core other than the calling thread's is created.
+	 */
+	explicit ThreadPool(int numThreads = -1);
+
+	/** Finish all queued tasks and stop the worker threads. */
+	~ThreadPool();
+
+	/** Return the number of worker threads, 0 if tasks run synchronously. */
+	uint getThreadCount() const { return _threads.size(); }
+
+	/**
+	 * Queue a function object for running on a worker thread. Returns a
+	 * future holding the value returned by the function.
+	 */
+	template<typename F>
+	auto submit(const F &function) -> Future<decltype(function())> {
+		typedef decltype(function()) T;
+		FunctionTask<T, F> *task = new FunctionTask<T, F>(function);
+		task->incRef();
+		enqueue(task);
+		return Future<T>(task);
+	}
+
+	/**
+	 * Call function(i) for every i in [begin, end) and wait until all calls
+	 * are done. The range is split into contiguous chunks of at least
+	 * @p grainSize iterations, which run on the worker threads and on the
+	 * calling thread. Iterations may run in any order.
+	 */
+	template<typename F>
+	void parallelFor(int begin, int end, const F &function, int grainSize = 1) {
+		if (end <= begin)
+			return;
+
+		const int count = end - begin;
+		int chunks = MIN<int>(getThreadCount() + 1, (count + grainSize - 1) / MAX(grainSize, 1));
+		if (chunks <= 1) {
+			for (int i = begin; i < end; i++)
+				function(i);
+			return;
+		}
+
+		Array<Future<void> > futures;
+		futures.reserve(chunks - 1);
+		for (int chunk = 1; chunk < chunks; chunk++) {
+			const int chunkBegin = begin + (int)((int64)count * chunk / chunks);
+			const int chunkEnd = begin + (int)((int64)count * (chunk + 1) / chunks);
+			futures.push_back(submit(RangeFunction<F>(function, chunkBegin, chunkEnd)));
+		}
+
+		const int firstEnd = begin + count / chunks;
+		for (int i = begin; i < firstEnd; i++)
+			function(i);
+
+		for (uint i = 0; i < futures.size(); i++)
+			futures[i].wait();
+	}
+
+private:
+	template<typename F>
+	struct RangeFunction {
+		const F &function;
+		int begin;
+		int end;
+
+		RangeFunction(const F &f, int b, int e) : function(f), begin(b), end(e) {}
+		void operator()() const {
+			for (int i = begin; i < end; i++)
+				function(i);
+		}
+	};
+
+	void enqueue(Task *task);
+	bool runQueuedTask();
+	void finishTask(Task *task);
+	void workerLoop();
+	static void workerProc(void *param);
+
+	Array<ThreadInternal *> _threads;
+	List<Task *> _queue;
+	Mutex _mutex;
+	ConditionVariable _workCondition;
+	ConditionVariable _doneCondition;
+	bool _quit;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -23,6 +23,7 @@
 #define COMMON_TIMER_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
 #include "common/str.h"
 #include "common/noncopyable.h"
 
@@ -41,6 +42,19 @@ class TimerManager : NonCopyable {
 public:
 	typedef void (*TimerProc)(void *refCon); /*!< Type definition of a timer instance. */
 
+	/** Profiling counters of a single installed timer. */
+	struct TimerStats {
+		String id;                 /*!< Unique ID the timer was installed with. */
+		int32 interval;            /*!< Interval the timer was installed with, in microseconds. */
+		uint32 calls;              /*!< Number of invocations of the callback. */
+		uint64 callbackTime;       /*!< Total time spent in the callback, in microseconds. */
+		uint32 maxCallbackTime;    /*!< Longest single invocation, in microseconds. */
+		uint64 jitter;             /*!< Total delay between the scheduled and the actual invocations, in microseconds. */
+		uint32 maxJitter;          /*!< Longest delay of a single invocation, in microseconds. */
+		uint32 missedDeadlines;    /*!< Invocations which only started once the following one was already due. */
+		uint32 overruns;           /*!< Invocations which took longer than the interval. */
+	};
+
 	virtual ~TimerManager() {}
 
 	/**
@@ -69,6 +83,22 @@ public:
 	 * of this callback will be running anymore.
 	 */
 	virtual void removeTimerProc(TimerProc proc) = 0;
+
+	/**
+	 * Retrieve the profiling counters of all installed timers, accumulated
+	 * since the timer was installed or resetStats() was last called.
+	 *
+	 * Timer managers which do not keep statistics return no timers.
+	 *
+	 * @param stats  Receives one entry per installed timer, ordered by
+	 *               the time of their next invocation.
+	 */
+	virtual void getStats(Array<TimerStats> &stats) { stats.clear(); }
+
+	/**
+	 * Reset the profiling counters of all installed timers.
+	 */
+	virtual void resetStats() {}
 };
 
 /** @} */
@@ -407,6 +407,7 @@ Common::Error AdvancedMetaEngineDetectionBase::identifyGame(DetectedGame &game,
 
 	// Detection is done, no need to keep archives in memory anymore
 	ADCacheMan.clearArchives();
+	ADCacheMan.savePersistentCache();
 
 	if (!agdDesc.desc)
 		return Common::kNoGameDataFoundError;
@@ -468,6 +469,48 @@ namespace Common {
 	DECLARE_SINGLETON(AdvancedDetectorCacheManager);
 }
 
+/* Persistent MD5 cache, stored next to the configuration file */
+
+static Common::Path getPersistentCachePath() {
+	Common::Path configFile = ConfMan.getCustomConfigFileName();
+	if (configFile.empty())
+		configFile = g_system->getDefaultConfigFileName();
+
+	return configFile.getParent().appendComponent("detection-cache.dat");
+}
+
+bool AdvancedDetectorCacheManager::getPersistentProps(const Common::String &key, const Common::FSNode &node, FileProperties &fileProps) {
+	if (!ConfMan.getBool("enable_detection_cache"))
+		return false;
+
+	if (!persistentCache.isLoaded())
+		persistentCache.load(getPersistentCachePath());
+
+	return persistentCache.lookup(key, node, fileProps.md5, fileProps.size);
+}
+
+void AdvancedDetectorCacheManager::setPersistentProps(const Common::String &key, const Common::FSNode &node, const FileProperties &fileProps) {
+	if (!ConfMan.getBool("enable_detection_cache"))
+		return;
+
+	if (!persistentCache.isLoaded())
+		persistentCache.load(getPersistentCachePath());
+
+	persistentCache.store(key, node, fileProps.md5, fileProps.size);
+}
+
+void AdvancedDetectorCacheManager::savePersistentCache() {
+	// A batch of detection runs writes the cache once, when it ends
+	if (persistentBatchLevel == 0)
+		persistentCache.save();
+}
+
+void AdvancedDetectorCacheManager::endPersistentBatch() {
+	assert(persistentBatchLevel > 0);
+	persistentBatchLevel--;
+	savePersistentCache();
+}
+
 
 static MD5Properties gameFileToMD5Props(const ADGameFileDescription *fileEntry, uint32 gameFlags) {
 	MD5Properties ret = kMD5Head;
@@ -545,11 +588,42 @@ bool AdvancedMetaEngineDetectionBase::getFileProperties(const FileMap &allFiles,
 		return true;
 	}
 
+	// The persistent cache is keyed by the location of the file on disk.
+	// Mac forks may live in a separate file, so they are not cached there.
+	Common::FSNode node;
+	Common::String persistentKey;
+	if (!(md5prop & (kMD5MacResFork | kMD5MacDataFork))) {
+		Common::String prefix = md5PropToCachePrefix(md5prop) + Common::String::format(":%d:", _md5Bytes);
+
+		if (md5prop & kMD5Archive) {
+			Common::StringTokenizer tok(fname.toString(), ":");
+			Common::String archiveType = tok.nextToken();
+			Common::Path archiveName(tok.nextToken());
+			if (allFiles.contains(archiveName)) {
+				node = allFiles[archiveName];
+				persistentKey = prefix + archiveType + ':' + node.getPath().toString('/') + ':' + tok.nextToken();
+			}
+		} else if (allFiles.contains(fname)) {
+			node = allFiles[fname];
+			persistentKey = prefix + node.getPath().toString('/');
+		}
+	}
+
+	if (!persistentKey.empty() && ADCacheMan.getPersistentProps(persistentKey, node, fileProps)) {
+		ADCacheMan.setMD5(hashname, fileProps.md5);
+		ADCacheMan.setSize(hashname, fileProps.size);
+		fileProps.md5prop = (MD5Properties)(md5prop & kMD5Tail);
+		return true;
+	}
+
 	bool res = getFilePropertiesIntern(_md5Bytes, allFiles, md5prop, fname, fileProps);
 
 	if (res) {
 		ADCacheMan.setMD5(hashname, fileProps.md5);
 		ADCacheMan.setSize(hashname, fileProps.size);
+
+		if (!persistentKey.empty())
+			ADCacheMan.setPersistentProps(persistentKey, node, fileProps);
 	}
 
 	return res;
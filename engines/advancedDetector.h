@@ -24,6 +24,7 @@
 
 #include "engines/metaengine.h"
 #include "engines/engine.h"
+#include "engines/detectionCache.h"
 
 #include "common/hash-str.h"
 
@@ -771,7 +772,29 @@ public:
 		return archiveHashMap.getValOrDefault(node.getPath(), nullptr);
 	}
 
-	AdvancedDetectorCacheManager() {
+	/**
+	 * Look up the properties of a file in the persistent detection cache.
+	 * Entries are only used while the size and the modification time of
+	 * the file on disk are unchanged.
+	 */
+	bool getPersistentProps(const Common::String &key, const Common::FSNode &node, FileProperties &fileProps);
+	void setPersistentProps(const Common::String &key, const Common::FSNode &node, const FileProperties &fileProps);
+
+	/**
+	 * Write the persistent detection cache back to disk if it has changed.
+	 * Called once a detection run is over; does nothing while a batch is open.
+	 */
+	void savePersistentCache();
+
+	/**
+	 * Defer the writes of the persistent detection cache until the matching
+	 * endPersistentBatch(), so that a scan of many directories writes it once.
+	 * Batches may be nested.
+	 */
+	void beginPersistentBatch() { persistentBatchLevel++; }
+	void endPersistentBatch();
+
+	AdvancedDetectorCacheManager() : persistentBatchLevel(0) {
 		clear();
 	}
 
@@ -797,6 +820,9 @@ private:
 	FileHashMap md5HashMap;
 	SizeHashMap sizeHashMap;
 	ArchiveHashMap archiveHashMap;
+
+	PersistentDetectionCache persistentCache;
+	uint persistentBatchLevel;
 };
 
 /** Convenience shortcut for accessing the MD5CacheManager. */
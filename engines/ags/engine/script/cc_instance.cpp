@@ -447,6 +447,11 @@ int ccInstance::Run(int32_t curpc) {
 	thisbase[0] = 0;
 	funcstart[0] = pc;
 	ccInstance *codeInst = runningInst;
+	// The code is translated on the first run after linking, never while
+	// it is being run, as the operations are referenced in the loop below
+	PredecodedCode *code_predecoded = codeInst->predecoded.get();
+	if (code_predecoded && !code_predecoded->IsBuilt)
+		codeInst->Predecode();
 	bool write_debug_dump = ccGetOption(SCOPT_DEBUGRUN) ||
 		(gDebugLevel > 0 && DebugMan.isDebugChannelEnabled(::AGS::kDebugScript));
 	ScriptOperation codeOp;
@@ -464,88 +469,114 @@ int ccInstance::Run(int32_t curpc) {
 		if (_G(abort_engine))
 			return -1;
 
-		/*
-		if (!codeInst->ReadOperation(codeOp, pc))
-		{
-		    return -1;
-		}
-		*/
-		/* ReadOperation */
-		//=====================================================================
-		codeOp.Instruction.Code         = codeInst->code[pc];
-		codeOp.Instruction.InstanceId   = (codeOp.Instruction.Code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
-		codeOp.Instruction.Code        &= INSTANCE_ID_REMOVEMASK; // now this is pure instruction code
-
-		if (codeOp.Instruction.Code < 0 || codeOp.Instruction.Code >= CC_NUM_SCCMDS) {
-			cc_error("invalid instruction %d found in code stream", codeOp.Instruction.Code);
-			return -1;
-		}
-
-		codeOp.ArgCount = (*g_commands)[codeOp.Instruction.Code].ArgCount;
-		if (pc + codeOp.ArgCount >= codeInst->codesize) {
-			cc_error("unexpected end of code data (%d; %d)", pc + codeOp.ArgCount, codeInst->codesize);
-			return -1;
-		}
+		// Take the operation from the predecoded code when it was translated;
+		// only the stack offsets have to be fixed up now
+		const RuntimeScriptValue *args = codeOp.Args;
+		const int32_t op_index = (code_predecoded && (uint32_t)pc < code_predecoded->OpIndex.size()) ? code_predecoded->OpIndex[pc] : -1;
+		if (op_index >= 0) {
+			PredecodedOperation &op = code_predecoded->Ops[op_index];
+			if (op.ImportArgs && op.ImportsGeneration != _GP(simp).getGeneration()) {
+				if (!codeInst->UpdatePredecodedImports(op, pc))
+					return -1;
+			}
 
-		int pc_at = pc + 1;
-		for (int i = 0; i < codeOp.ArgCount; ++i, ++pc_at) {
-			char fixup = codeInst->code_fixups[pc_at];
-			if (fixup > 0) {
-				// could be relative pointer or import address
-				/*
-				if (!FixupArgument(code[pc], fixup, codeOp.Args[i]))
-				{
-				    return -1;
+			codeOp.Instruction.Code = op.Code;
+			codeOp.Instruction.InstanceId = op.InstanceId;
+			codeOp.ArgCount = op.ArgCount;
+			args = &code_predecoded->Args[op.FirstArg];
+			if (op.StackArgs) {
+				for (int i = 0; i < op.ArgCount; ++i) {
+					if (op.StackArgs & (1 << i))
+						codeOp.Args[i] = GetStackPtrOffsetFw(args[i].IValue);
+					else
+						codeOp.Args[i] = args[i];
 				}
-				*/
-				/* FixupArgument */
-				//=====================================================================
-				switch (fixup) {
-				case FIXUP_GLOBALDATA: {
-					ScriptVariable *gl_var = (ScriptVariable *)codeInst->code[pc_at];
-					codeOp.Args[i].SetGlobalVar(&gl_var->RValue);
-				}
-				break;
-				case FIXUP_FUNCTION:
-					// originally commented -- CHECKME: could this be used in very old versions of AGS?
-					//      code[fixup] += (long)&code[0];
-					// This is a program counter value, presumably will be used as SCMD_CALL argument
-					codeOp.Args[i].SetInt32((int32_t)codeInst->code[pc_at]);
+				args = codeOp.Args;
+			}
+		} else {
+			/*
+			if (!codeInst->ReadOperation(codeOp, pc))
+			{
+			    return -1;
+			}
+			*/
+			/* ReadOperation */
+			//=====================================================================
+			codeOp.Instruction.Code         = codeInst->code[pc];
+			codeOp.Instruction.InstanceId   = (codeOp.Instruction.Code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
+			codeOp.Instruction.Code        &= INSTANCE_ID_REMOVEMASK; // now this is pure instruction code
+
+			if (codeOp.Instruction.Code < 0 || codeOp.Instruction.Code >= CC_NUM_SCCMDS) {
+				cc_error("invalid instruction %d found in code stream", codeOp.Instruction.Code);
+				return -1;
+			}
+
+			codeOp.ArgCount = (*g_commands)[codeOp.Instruction.Code].ArgCount;
+			if (pc + codeOp.ArgCount >= codeInst->codesize) {
+				cc_error("unexpected end of code data (%d; %d)", pc + codeOp.ArgCount, codeInst->codesize);
+				return -1;
+			}
+
+			int pc_at = pc + 1;
+			for (int i = 0; i < codeOp.ArgCount; ++i, ++pc_at) {
+				char fixup = codeInst->code_fixups[pc_at];
+				if (fixup > 0) {
+					// could be relative pointer or import address
+					/*
+					if (!FixupArgument(code[pc], fixup, codeOp.Args[i]))
+					{
+					    return -1;
+					}
+					*/
+					/* FixupArgument */
+					//=====================================================================
+					switch (fixup) {
+					case FIXUP_GLOBALDATA: {
+						ScriptVariable *gl_var = (ScriptVariable *)codeInst->code[pc_at];
+						codeOp.Args[i].SetGlobalVar(&gl_var->RValue);
+					}
 					break;
-				case FIXUP_STRING:
-					codeOp.Args[i].SetStringLiteral(&codeInst->strings[0] + codeInst->code[pc_at]);
+					case FIXUP_FUNCTION:
+						// originally commented -- CHECKME: could this be used in very old versions of AGS?
+						//      code[fixup] += (long)&code[0];
+						// This is a program counter value, presumably will be used as SCMD_CALL argument
+						codeOp.Args[i].SetInt32((int32_t)codeInst->code[pc_at]);
+						break;
+					case FIXUP_STRING:
+						codeOp.Args[i].SetStringLiteral(&codeInst->strings[0] + codeInst->code[pc_at]);
+						break;
+					case FIXUP_IMPORT: {
+						const ScriptImport *import = _GP(simp).getByIndex(static_cast<uint32_t>(codeInst->code[pc_at]));
+						if (import) {
+							codeOp.Args[i] = import->Value;
+						} else {
+							cc_error("cannot resolve import, key = %ld", codeInst->code[pc_at]);
+							return -1;
+						}
+					}
 					break;
-				case FIXUP_IMPORT: {
-					const ScriptImport *import = _GP(simp).getByIndex(static_cast<uint32_t>(codeInst->code[pc_at]));
-					if (import) {
-						codeOp.Args[i] = import->Value;
-					} else {
-						cc_error("cannot resolve import, key = %ld", codeInst->code[pc_at]);
+					case FIXUP_STACK:
+						codeOp.Args[i] = GetStackPtrOffsetFw((int32_t)codeInst->code[pc_at]);
+						break;
+					default:
+						cc_error("internal fixup type error: %d", fixup);
 						return -1;
 					}
+					/* End FixupArgument */
+					//=====================================================================
+				} else {
+					// should be a numeric literal (int32 or float)
+					codeOp.Args[i].SetInt32((int32_t)codeInst->code[pc_at]);
 				}
-				break;
-				case FIXUP_STACK:
-					codeOp.Args[i] = GetStackPtrOffsetFw((int32_t)codeInst->code[pc_at]);
-					break;
-				default:
-					cc_error("internal fixup type error: %d", fixup);
-					return -1;
-				}
-				/* End FixupArgument */
-				//=====================================================================
-			} else {
-				// should be a numeric literal (int32 or float)
-				codeOp.Args[i].SetInt32((int32_t)codeInst->code[pc_at]);
 			}
+			/* End ReadOperation */
+			//=====================================================================
 		}
-		/* End ReadOperation */
-		//=====================================================================
 
 		// save the arguments for quick access
-		RuntimeScriptValue &arg1 = codeOp.Args[0];
-		RuntimeScriptValue &arg2 = codeOp.Args[1];
-		RuntimeScriptValue &arg3 = codeOp.Args[2];
+		const RuntimeScriptValue &arg1 = args[0];
+		const RuntimeScriptValue &arg2 = args[1];
+		const RuntimeScriptValue &arg3 = args[2];
 		RuntimeScriptValue &reg1 =
 		    registers[arg1.IValue >= 0 && arg1.IValue < CC_NUM_REGISTERS ? arg1.IValue : 0];
 		RuntimeScriptValue &reg2 =
@@ -555,6 +586,10 @@ int ccInstance::Run(int32_t curpc) {
 		const char *direct_ptr2;
 
 		if (write_debug_dump) {
+			if (args != codeOp.Args) {
+				for (int i = 0; i < codeOp.ArgCount; ++i)
+					codeOp.Args[i] = args[i];
+			}
 			DumpInstruction(codeOp);
 		}
 
@@ -1431,7 +1466,9 @@ bool ccInstance::_Create(PScript scri, ccInstance *joined) {
 	if (joined) {
 		resolved_imports = joined->resolved_imports;
 		code_fixups = joined->code_fixups;
+		predecoded = joined->predecoded;
 	} else {
+		predecoded.reset(new PredecodedCode());
 		if (!CreateGlobalVars(scri.get())) {
 			return false;
 		}
@@ -1516,6 +1553,7 @@ void ccInstance::Free() {
 	}
 	resolved_imports = nullptr;
 	code_fixups = nullptr;
+	predecoded.reset();
 }
 
 bool ccInstance::ResolveScriptImports(const ccScript *scri) {
@@ -1726,6 +1764,91 @@ bool ccInstance::ResolveImportFixups(const ccScript *scri) {
 		if (import->InstancePtr != nullptr && (code[fixup + 1] & INSTANCE_ID_REMOVEMASK) == SCMD_CALLEXT)
 			code[fixup + 1] = SCMD_CALLAS | (import->InstancePtr->loadedInstanceId << INSTANCE_ID_SHIFT);
 	}
+	// The code changed, translate it again on the next run
+	predecoded->IsBuilt = false;
+	return true;
+}
+
+void ccInstance::Predecode() {
+	predecoded->OpIndex.clear();
+	predecoded->Ops.clear();
+	predecoded->Args.clear();
+	predecoded->OpIndex.resize(codesize, -1);
+
+	const uint32_t imports_generation = _GP(simp).getGeneration();
+	for (int32_t at_pc = 0; at_pc < codesize;) {
+		// Stop at invalid code, which Run() reports if it is ever reached
+		const int32_t instruction = (int32_t)code[at_pc];
+		PredecodedOperation op;
+		op.Code = instruction & INSTANCE_ID_REMOVEMASK;
+		op.InstanceId = (instruction >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
+		if (op.Code < 0 || op.Code >= CC_NUM_SCCMDS)
+			break;
+		op.ArgCount = (*g_commands)[op.Code].ArgCount;
+		if (at_pc + op.ArgCount >= codesize)
+			break;
+		op.StackArgs = 0;
+		op.ImportArgs = 0;
+		op.ImportsGeneration = imports_generation;
+		op.FirstArg = predecoded->Args.size();
+
+		bool valid = true;
+		for (int i = 0; i < op.ArgCount && valid; ++i) {
+			const int32_t arg_pc = at_pc + 1 + i;
+			const char fixup = code_fixups[arg_pc];
+			RuntimeScriptValue arg;
+			if (fixup <= 0 || fixup == FIXUP_FUNCTION) {
+				// numeric literal, or a program counter value
+				arg.SetInt32((int32_t)code[arg_pc]);
+			} else if (fixup == FIXUP_GLOBALDATA) {
+				ScriptVariable *gl_var = (ScriptVariable *)code[arg_pc];
+				arg.SetGlobalVar(&gl_var->RValue);
+			} else if (fixup == FIXUP_STRING) {
+				arg.SetStringLiteral(&strings[0] + code[arg_pc]);
+			} else if (fixup == FIXUP_IMPORT) {
+				// Missing imports are looked up again, and reported, when run
+				const ScriptImport *import = _GP(simp).getByIndex(static_cast<uint32_t>(code[arg_pc]));
+				if (import)
+					arg = import->Value;
+				else
+					op.ImportsGeneration = 0;
+				op.ImportArgs |= 1 << i;
+			} else if (fixup == FIXUP_STACK) {
+				arg.SetInt32((int32_t)code[arg_pc]);
+				op.StackArgs |= 1 << i;
+			} else {
+				valid = false;
+			}
+			predecoded->Args.push_back(arg);
+		}
+		if (!valid) {
+			predecoded->Args.resize(op.FirstArg);
+			break;
+		}
+
+		predecoded->OpIndex[at_pc] = predecoded->Ops.size();
+		predecoded->Ops.push_back(op);
+		at_pc += op.ArgCount + 1;
+	}
+
+	predecoded->Args.resize(predecoded->Args.size() + MAX_SCMD_ARGS);
+	predecoded->IsBuilt = true;
+}
+
+bool ccInstance::UpdatePredecodedImports(PredecodedOperation &op, int32_t at_pc) {
+	RuntimeScriptValue *args = &predecoded->Args[op.FirstArg];
+	for (int i = 0; i < op.ArgCount; ++i) {
+		if ((op.ImportArgs & (1 << i)) == 0)
+			continue;
+
+		const ScriptImport *import = _GP(simp).getByIndex(static_cast<uint32_t>(code[at_pc + 1 + i]));
+		if (!import) {
+			cc_error("cannot resolve import, key = %ld", code[at_pc + 1 + i]);
+			return false;
+		}
+		args[i] = import->Value;
+	}
+	op.ImportsGeneration = _GP(simp).getGeneration();
 	return true;
 }
 
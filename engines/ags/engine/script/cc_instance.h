@@ -24,6 +24,7 @@
 
 #include "common/std/memory.h"
 #include "common/std/map.h"
+#include "common/std/vector.h"
 #include "ags/engine/ac/timer.h"
 #include "ags/shared/script/cc_internal.h"
 #include "ags/shared/script/cc_script.h"  // ccScript
@@ -69,6 +70,33 @@ struct ScriptOperation {
 	int                 ArgCount;
 };
 
+// An instruction decoded ahead of execution, with its arguments fixed up
+struct PredecodedOperation {
+	int32_t  Code;          // pure instruction code
+	uint8_t  InstanceId;
+	uint8_t  ArgCount;
+	uint8_t  StackArgs;     // bit mask of arguments which are stack offsets, fixed up when run
+	uint8_t  ImportArgs;    // bit mask of arguments which are taken from the system imports
+	uint32_t ImportsGeneration; // generation of the system imports the import arguments were read from
+	uint32_t FirstArg;      // index of the first argument in PredecodedCode::Args
+};
+
+// Script code translated into a stream of predecoded operations, shared by
+// an instance and its forks. Once built, the stream is never reallocated,
+// because nested calls to Run() keep references to the arguments.
+struct PredecodedCode {
+	PredecodedCode() : IsBuilt(false) {}
+
+	bool IsBuilt;
+	// Index of the operation starting at each code position, or -1 if
+	// the position was not translated; it is then decoded when run
+	std::vector<int32_t> OpIndex;
+	std::vector<PredecodedOperation> Ops;
+	// Arguments of all the operations, followed by MAX_SCMD_ARGS unused
+	// entries, so that the first MAX_SCMD_ARGS arguments may always be read
+	std::vector<RuntimeScriptValue> Args;
+};
+
 struct ScriptVariable {
 	ScriptVariable() {
 		ScAddress = -1; // address = 0 is valid one, -1 means undefined
@@ -100,6 +128,7 @@ struct ccInstance {
 public:
 	typedef std::unordered_map<int32_t, ScriptVariable> ScVarMap;
 	typedef std::shared_ptr<ScVarMap>                   PScVarMap;
+	typedef std::shared_ptr<PredecodedCode>             PPredecodedCode;
 public:
 	int32_t flags;
 	PScVarMap globalvars;
@@ -139,6 +168,8 @@ public:
 	int  numimports;
 
 	char *code_fixups;
+	// code translated into predecoded operations before the first run
+	PPredecodedCode predecoded;
 
 	// returns the currently executing instance, or NULL if none
 	static ccInstance *GetCurrentInstance(void);
@@ -193,6 +224,10 @@ private:
 	bool    AddGlobalVar(const ScriptVariable &glvar);
 	ScriptVariable *FindGlobalVar(int32_t var_addr);
 	bool    CreateRuntimeCodeFixups(const ccScript *scri);
+	// Translate the code into predecoded operations, as far as it is valid
+	void    Predecode();
+	// Read the arguments of a predecoded operation from the system imports again
+	bool    UpdatePredecodedImports(PredecodedOperation &op, int32_t at_pc);
 	//bool    ReadOperation(ScriptOperation &op, int32_t at_pc);
 
 	// Begin executing script starting from the given bytecode index
@@ -31,6 +31,7 @@ uint32_t SystemImports::add(const String &name, const RuntimeScriptValue &value,
 		if (anotherscr == nullptr) {
 			imports[ixof].Value = value;
 			imports[ixof].InstancePtr = anotherscr;
+			nextGeneration();
 		}
 		return ixof;
 	}
@@ -49,6 +50,7 @@ uint32_t SystemImports::add(const String &name, const RuntimeScriptValue &value,
 	imports[ixof].Name = name;
 	imports[ixof].Value = value;
 	imports[ixof].InstancePtr = anotherscr;
+	nextGeneration();
 	return ixof;
 }
 
@@ -60,6 +62,7 @@ void SystemImports::remove(const String &name) {
 	imports[idx].Name = nullptr;
 	imports[idx].Value.Invalidate();
 	imports[idx].InstancePtr = nullptr;
+	nextGeneration();
 }
 
 const ScriptImport *SystemImports::getByName(const String &name) {
@@ -125,11 +128,18 @@ void SystemImports::RemoveScriptExports(ccInstance *inst) {
 			import.InstancePtr = nullptr;
 		}
 	}
+	nextGeneration();
 }
 
 void SystemImports::clear() {
 	btree.clear();
 	imports.clear();
+	nextGeneration();
+}
+
+void SystemImports::nextGeneration() {
+	if (++_generation == 0)
+		_generation = 1;
 }
 
 } // namespace AGS3
@@ -50,8 +50,15 @@ private:
 
 	std::vector<ScriptImport> imports;
 	IndexMap btree;
+	// Changes whenever an import is added, overridden or removed;
+	// never 0, which is used as an invalid generation
+	uint32_t _generation;
+
+	void nextGeneration();
 
 public:
+	SystemImports() : _generation(1) {}
+
 	uint32_t add(const String &name, const RuntimeScriptValue &value, ccInstance *inst);
 	void remove(const String &name);
 	const ScriptImport *getByName(const String &name);
@@ -60,6 +67,7 @@ public:
 	String findName(const RuntimeScriptValue &value);
 	void RemoveScriptExports(ccInstance *inst);
 	void clear();
+	uint32_t getGeneration() const { return _generation; }
 };
 
 } // namespace AGS3
@@ -0,0 +1,124 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+#include "common/debug.h"
+#include "common/system.h"
+#include "ags/shared/core/platform.h"
+#include "ags/shared/script/cc_common.h"
+#include "ags/shared/script/cc_internal.h"
+#include "ags/shared/util/string_compat.h"
+#include "ags/engine/script/cc_instance.h"
+
+namespace AGS3 {
+
+// Create a script exporting "loop$0", which adds (i + 3) up for i from 1 to
+// the given count, and returns the sum
+static PScript Test_CreateLoopScript(int32_t count) {
+	const int32_t code[] = {
+		SCMD_LINENUM, 1,
+		SCMD_LITTOREG, SREG_CX, 0,
+		SCMD_LITTOREG, SREG_DX, 0,
+		// loop:
+		SCMD_LITTOREG, SREG_BX, 0, // string literal
+		SCMD_ADD, SREG_CX, 1,
+		SCMD_REGTOREG, SREG_CX, SREG_BX,
+		SCMD_ADD, SREG_BX, 3,
+		SCMD_ADDREG, SREG_DX, SREG_BX,
+		SCMD_REGTOREG, SREG_CX, SREG_AX,
+		SCMD_LITTOREG, SREG_BX, count,
+		SCMD_LESSTHAN, SREG_AX, SREG_BX,
+		SCMD_JNZ, -26, // back to loop
+		SCMD_REGTOREG, SREG_DX, SREG_AX,
+		SCMD_RET
+	};
+	const char strings[] = "loop";
+
+	PScript scri(new ccScript());
+	scri->codesize = ARRAYSIZE(code);
+	scri->code = (int32_t *)malloc(sizeof(code));
+	memcpy(scri->code, code, sizeof(code));
+	scri->stringssize = sizeof(strings);
+	scri->strings = (char *)malloc(sizeof(strings));
+	memcpy(scri->strings, strings, sizeof(strings));
+
+	scri->numfixups = 1;
+	scri->fixups = (int32_t *)malloc(sizeof(int32_t));
+	scri->fixups[0] = 10;
+	scri->fixuptypes = (char *)malloc(sizeof(char));
+	scri->fixuptypes[0] = FIXUP_STRING;
+
+	// The export arrays are only freed along with the imports
+	scri->imports = (char **)malloc(sizeof(char *));
+	scri->numexports = 1;
+	scri->exports = (char **)malloc(sizeof(char *));
+	scri->exports[0] = ags_strdup("loop$0");
+	scri->export_addr = (int32_t *)malloc(sizeof(int32_t));
+	scri->export_addr[0] = EXPORT_FUNCTION << 24;
+	return scri;
+}
+
+// Run the loop script and return the time taken; with predecode off, the
+// instructions are decoded one by one as they are run
+static uint32 Test_RunLoopScript(int32_t count, int runs, bool predecode) {
+	PScript scri = Test_CreateLoopScript(count);
+	ccInstance *inst = ccInstance::CreateFromScript(scri);
+	assert(inst);
+	if (!predecode)
+		inst->predecoded.reset();
+
+	const int32_t expected = count * (count + 1) / 2 + 3 * count;
+	uint32 start = g_system->getMillis();
+	for (int i = 0; i < runs; i++) {
+		int result = inst->CallScriptFunction("loop", 0, nullptr);
+		assert(result == 0);
+		assert(inst->returnValue == expected);
+		(void)result;
+	}
+	uint32 time = g_system->getMillis() - start;
+
+	// Forks share the translated code
+	ccInstance *fork = inst->Fork();
+	assert(fork && fork->predecoded == inst->predecoded);
+	int result = fork->CallScriptFunction("loop", 0, nullptr);
+	assert(result == 0 && fork->returnValue == expected);
+	(void)result;
+
+	delete fork;
+	delete inst;
+	return time;
+}
+
+void Test_Script() {
+	Test_RunLoopScript(100, 1, true);
+	Test_RunLoopScript(100, 1, false);
+
+#if defined(SLOW_TESTS)
+	const int32_t count = 50000;
+	const int runs = 100;
+	uint32 decodeTime = Test_RunLoopScript(count, runs, false);
+	uint32 predecodeTime = Test_RunLoopScript(count, runs, true);
+	debug("Script: %d loop iterations run in %u ms decoding each instruction, %u ms predecoded",
+		count * runs, decodeTime, predecodeTime);
+#endif
+}
+
+} // namespace AGS3
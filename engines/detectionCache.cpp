@@ -0,0 +1,142 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/debug.h"
+#include "common/file.h"
+#include "common/textconsole.h"
+#include "common/tokenizer.h"
+#include "common/util.h"
+#include "engines/detectionCache.h"
+
+#define DETECTION_CACHE_HEADER "ScummVM detection cache v1"
+
+static bool parseInt64(const Common::String &str, int64 &val) {
+	const char *ptr = str.c_str();
+	bool negative = (*ptr == '-');
+	if (negative)
+		ptr++;
+	if (!*ptr)
+		return false;
+
+	val = 0;
+	for (; *ptr; ptr++) {
+		if (!Common::isDigit(*ptr))
+			return false;
+		val = val * 10 + (*ptr - '0');
+	}
+
+	if (negative)
+		val = -val;
+	return true;
+}
+
+void PersistentDetectionCache::load(const Common::Path &path) {
+	_path = path;
+	_loaded = true;
+	_dirty = false;
+	_entries.clear();
+
+	Common::File file;
+	if (!file.open(Common::FSNode(path)))
+		return;
+
+	if (file.readLine() != DETECTION_CACHE_HEADER) {
+		debugC(2, kDebugGlobalDetection, "Ignoring detection cache with an unknown format");
+		return;
+	}
+
+	while (!file.eos() && !file.err()) {
+		// md5, size, file size, modification time and key, separated by tabs
+		Common::StringArray fields = Common::StringTokenizer(file.readLine(), "\t").split();
+		if (fields.size() != 5)
+			continue;
+
+		Entry entry;
+		if (!parseInt64(fields[1], entry.size) || !parseInt64(fields[2], entry.fileSize) || !parseInt64(fields[3], entry.modificationTime))
+			continue;
+
+		entry.md5 = fields[0];
+		entry.used = false;
+		_entries.setVal(fields[4], entry);
+	}
+
+	debugC(2, kDebugGlobalDetection, "Loaded %d entries from the detection cache", _entries.size());
+}
+
+bool PersistentDetectionCache::lookup(const Common::String &key, const Common::FSNode &node, Common::String &md5, int64 &size) {
+	EntryMap::iterator i = _entries.find(key);
+	if (i == _entries.end())
+		return false;
+
+	int64 fileSize, modificationTime;
+	if (!node.getFileStats(fileSize, modificationTime))
+		return false;
+
+	if (i->_value.fileSize != fileSize || i->_value.modificationTime != modificationTime) {
+		debugC(3, kDebugGlobalDetection, "Detection cache entry for '%s' is outdated", key.c_str());
+		_entries.erase(i);
+		_dirty = true;
+		return false;
+	}
+
+	i->_value.used = true;
+	md5 = i->_value.md5;
+	size = i->_value.size;
+	return true;
+}
+
+void PersistentDetectionCache::store(const Common::String &key, const Common::FSNode &node, const Common::String &md5, int64 size) {
+	Entry entry;
+	if (!node.getFileStats(entry.fileSize, entry.modificationTime))
+		return;
+
+	entry.size = size;
+	entry.md5 = md5;
+	entry.used = true;
+	_entries.setVal(key, entry);
+	_dirty = true;
+}
+
+void PersistentDetectionCache::save() {
+	if (!_dirty || _path.empty())
+		return;
+	_dirty = false;
+
+	const bool usedOnly = (_entries.size() > kMaxEntries);
+
+	Common::DumpFile file;
+	if (!file.open(Common::FSNode(_path))) {
+		warning("Unable to write detection cache '%s'", _path.toString(Common::Path::kNativeSeparator).c_str());
+		return;
+	}
+
+	file.writeString(DETECTION_CACHE_HEADER "\n");
+	for (EntryMap::iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		if (usedOnly && !i->_value.used)
+			continue;
+
+		file.writeString(Common::String::format("%s\t%lld\t%lld\t%lld\t%s\n", i->_value.md5.c_str(),
+			(long long)i->_value.size, (long long)i->_value.fileSize, (long long)i->_value.modificationTime, i->_key.c_str()));
+	}
+
+	file.finalize();
+	debugC(2, kDebugGlobalDetection, "Saved the detection cache to '%s'", _path.toString(Common::Path::kNativeSeparator).c_str());
+}
@@ -0,0 +1,88 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ENGINES_DETECTION_CACHE_H
+#define ENGINES_DETECTION_CACHE_H
+
+#include "common/fs.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/path.h"
+#include "common/str.h"
+
+/**
+ * @defgroup engines_detection_cache Detection cache
+ * @ingroup engines
+ *
+ * @brief Checksums of game files kept on disk between detection runs.
+ * @{
+ */
+
+/**
+ * A file of checksums computed by earlier detection runs.
+ *
+ * Entries are keyed by a string naming the file and the kind of checksum,
+ * and are only used while the size and the modification time of the file
+ * on disk are unchanged.
+ */
+class PersistentDetectionCache {
+public:
+	PersistentDetectionCache() : _loaded(false), _dirty(false) {}
+
+	/** Replace the entries in memory with the ones stored in @p path. */
+	void load(const Common::Path &path);
+	bool isLoaded() const { return _loaded; }
+
+	/**
+	 * Look up the checksum stored for @p key. An entry that no longer
+	 * matches @p node is dropped.
+	 */
+	bool lookup(const Common::String &key, const Common::FSNode &node, Common::String &md5, int64 &size);
+	void store(const Common::String &key, const Common::FSNode &node, const Common::String &md5, int64 size);
+
+	/** Write the entries back to the file they were loaded from, if any of them changed. */
+	void save();
+
+	bool isDirty() const { return _dirty; }
+	uint size() const { return _entries.size(); }
+
+	/** Once the cache grows past this, only the entries used since loading are saved. */
+	static const uint kMaxEntries = 20000;
+
+private:
+	struct Entry {
+		int64 fileSize;
+		int64 modificationTime;
+		int64 size;
+		Common::String md5;
+		bool used;
+	};
+
+	typedef Common::HashMap<Common::String, Entry> EntryMap;
+	EntryMap _entries;
+	Common::Path _path;
+	bool _loaded;
+	bool _dirty;
+};
+
+/** @} */
+
+#endif
@@ -79,6 +79,8 @@ Debugger::Debugger(): GUI::Debugger() {
 	registerCmd("act", WRAP_METHOD(Debugger, cmdActions));
 	registerCmd("markers", WRAP_METHOD(Debugger, cmdMarkers));
 	registerCmd("mk", WRAP_METHOD(Debugger, cmdMarkers));
+	registerCmd("execstats", WRAP_METHOD(Debugger, cmdExecStats));
+	registerCmd("es", WRAP_METHOD(Debugger, cmdExecStats));
 	registerCmd("step", WRAP_METHOD(Debugger, cmdStep));
 	registerCmd("s", WRAP_METHOD(Debugger, cmdStep));
 	registerCmd("next", WRAP_METHOD(Debugger, cmdNext));
@@ -161,6 +163,7 @@ bool Debugger::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" actions / act - Lists all of the action scripts available in the current score\n");
 	debugPrintf(" var / v - Lists all of the variables available in the current script frame\n");
 	debugPrintf(" markers / mk - Lists all of the frame markers in the current score\n");
+	debugPrintf(" execstats / es [reset] - Shows how fast Lingo runs, and the time spent updating the screen while running\n");
 	debugPrintf(" step / s [n] - Steps forward one or more operations\n");
 	debugPrintf(" next / n [n] - Steps forward one or more operations, skips over calls\n");
 	debugPrintf(" finish / fin - Steps until the current stack frame returns\n");
@@ -429,6 +432,26 @@ bool Debugger::cmdStack(int argc, const char **argv) {
 	return true;
 }
 
+bool Debugger::cmdExecStats(int argc, const char **argv) {
+	Lingo *lingo = g_director->getLingo();
+	LingoExecStats &stats = lingo->_execStats;
+	if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		stats.reset();
+		debugPrintf("Lingo execution statistics reset\n");
+		return true;
+	}
+
+	const uint32 elapsed = MAX<uint32>(g_system->getMillis(true) - stats.start, 1);
+	debugPrintf("Over the last %u ms:\n", elapsed);
+	debugPrintf("  Instructions: %llu (%llu per second)\n", (unsigned long long)stats.instructions, (unsigned long long)(stats.instructions * 1000 / elapsed));
+	debugPrintf("  Event processing: %u times, %u ms\n", stats.pumps, stats.pumpTime);
+	debugPrintf("  Screen updates: %u times, %u ms\n", stats.presents, stats.presentTime);
+	debugPrintf("Events are processed every %u ms, and the screen updated every %u ms at most\n",
+		g_director->_lingoEventInterval, g_director->_lingoPresentInterval);
+	debugPrintf("\n");
+	return true;
+}
+
 bool Debugger::cmdScriptFrame(int argc, const char **argv) {
 	Lingo *lingo = g_director->getLingo();
 	debugPrintf("%s\n", lingo->formatFrame().c_str());
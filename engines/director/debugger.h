@@ -103,6 +103,7 @@ private:
 	bool cmdActions(int argc, const char **argv);
 	bool cmdVar(int argc, const char **argv);
 	bool cmdMarkers(int argc, const char **argv);
+	bool cmdExecStats(int argc, const char **argv);
 	bool cmdStep(int argc, const char **argv);
 	bool cmdNext(int argc, const char **argv);
 	bool cmdFinish(int argc, const char **argv);
@@ -107,6 +107,8 @@ DirectorEngine::DirectorEngine(OSystem *syst, const DirectorGameDescription *gam
 	_forceDate.tm_wday = -1;
 	_loadSlowdownFactor = 0;
 	_loadSlowdownCooldownTime = 0;
+	_lingoEventInterval = 10;
+	_lingoPresentInterval = 1000 / 60;
 
 	_wm = nullptr;
 
@@ -88,6 +88,7 @@ enum {
 	kDebugImGui,
 	kDebugPaused,
 	kDebugPauseOnLoad,
+	kDebugLingoBenchmark,
 };
 
 enum {
@@ -291,6 +292,8 @@ public:
 	TimeDate _forceDate;
 	uint32 _loadSlowdownFactor;
 	uint32 _loadSlowdownCooldownTime;
+	uint32 _lingoEventInterval;		// ms between processing events while Lingo is running
+	uint32 _lingoPresentInterval;	// ms between screen updates while Lingo is running
 
 private:
 	byte _currentPalette[768];
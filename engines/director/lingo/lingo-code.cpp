@@ -185,7 +185,7 @@ void Lingo::cleanupFuncs() {
 }
 
 void Lingo::push(Datum d) {
-	_stack.push_back(d);
+	_stack.push_back(Common::move(d));
 }
 
 Datum Lingo::getVoid() {
@@ -203,7 +203,7 @@ void Lingo::pushVoid() {
 Datum Lingo::pop() {
 	assert (_stack.size() != 0);
 
-	Datum ret = _stack.back();
+	Datum ret = Common::move(_stack.back());
 	_stack.pop_back();
 
 	return ret;
@@ -21,6 +21,8 @@
 
 #include "common/file.h"
 
+#include "gui/EventRecorder.h"
+
 #include "graphics/macgui/macwindowmanager.h"
 
 #include "director/director.h"
@@ -175,6 +177,7 @@ Lingo::Lingo(DirectorEngine *vm) : _vm(vm) {
 	_state = nullptr;
 	_currentChannelId = -1;
 	_globalCounter = 0;
+	_lastPresentTime = 0;
 	_freezeState = false;
 	_freezePlay = false;
 	_playDone = false;
@@ -615,8 +618,47 @@ Common::String Lingo::formatFunctionBody(Symbol &sym) {
 	return result;
 }
 
+void LingoExecStats::reset() {
+	start = g_system->getMillis(true);
+	instructions = 0;
+	pumps = 0;
+	pumpTime = 0;
+	presents = 0;
+	presentTime = 0;
+}
+
+void Lingo::pumpEvents(uint32 now, bool throttlePresent) {
+	_vm->processEvents();
+	// Also process update widgets!
+	Movie *movie = g_director->getCurrentMovie();
+	Score *score = movie->getScore();
+	score->updateWidgets(true);
+
+	const uint32 pumped = g_system->getMillis(true);
+	_execStats.pumps++;
+	_execStats.pumpTime += pumped - now;
+
+	// Presenting is the most expensive part, don't do it faster than the display
+	if (!throttlePresent || pumped - _lastPresentTime >= _vm->_lingoPresentInterval) {
+		g_system->updateScreen();
+
+		_lastPresentTime = g_system->getMillis(true);
+		_execStats.presents++;
+		_execStats.presentTime += _lastPresentTime - pumped;
+	}
+}
+
 bool Lingo::execute() {
 	uint localCounter = 0;
+	uint32 lastPumpTime = g_system->getMillis(true);
+
+	// The pump timing is not recorded, so while recording or playing back
+	// events, pump them at fixed instruction counts instead
+#ifdef ENABLE_EVENTRECORDER
+	const bool pumpByTime = (g_eventRec.getRecordMode() == GUI::EventRecorder::kPassthrough);
+#else
+	const bool pumpByTime = true;
+#endif
 
 	while (!_abort && !_freezeState && _state->script && (*_state->script)[_state->pc] != STOP) {
 		if ((_exec._state == kPause) || (_exec._shouldPause && _exec._shouldPause())) {
@@ -638,15 +680,17 @@ bool Lingo::execute() {
 			break;
 		}
 
-		// process events every so often
-		if (localCounter > 0 && localCounter % 100 == 0) {
-			_vm->processEvents();
-			// Also process update widgets!
-			Movie *movie = g_director->getCurrentMovie();
-			Score *score = movie->getScore();
-			score->updateWidgets(true);
-
-			g_system->updateScreen();
+		// process events every so often; the clock is only read every
+		// few instructions, to keep tight loops cheap
+		if (!pumpByTime) {
+			if (localCounter > 0 && localCounter % kLingoRecordedPumpInterval == 0)
+				pumpEvents(g_system->getMillis(true), false);
+		} else if (localCounter > 0 && localCounter % kLingoClockCheckInterval == 0) {
+			const uint32 now = g_system->getMillis(true);
+			if (now - lastPumpTime >= _vm->_lingoEventInterval) {
+				pumpEvents(now, true);
+				lastPumpTime = g_system->getMillis(true);
+			}
 		}
 
 		uint current = _state->pc;
@@ -681,6 +725,7 @@ bool Lingo::execute() {
 
 		_globalCounter++;
 		localCounter++;
+		_execStats.instructions++;
 
 		if (!_abort && _state->pc >= (*_state->script).size()) {
 			warning("Lingo::execute(): Bad PC (%d)", _state->pc);
@@ -861,29 +906,74 @@ int Lingo::getAlignedType(const Datum &d1, const Datum &d2, bool equality) {
 	return opType;
 }
 
+// Values of these types are held in the Datum itself, so copies of them
+// do not share anything
+static bool isImmediateDatumType(DatumType type) {
+	switch (type) {
+	case VOID:
+	case INT:
+	case FLOAT:
+	case ARGC:
+	case ARGCNORET:
+		return true;
+	default:
+		return false;
+	}
+}
+
 Datum::Datum() {
 	u.s = nullptr;
 	type = VOID;
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
 Datum::Datum(const Datum &d) {
+	type = d.type;
+	u = d.u;
+	refCount = d.share();
+	ignoreGlobal = false;
+}
+
+Datum::Datum(Datum &&d) {
 	type = d.type;
 	u = d.u;
 	refCount = d.refCount;
-	*refCount += 1;
 	ignoreGlobal = false;
+
+	d.type = VOID;
+	d.u.s = nullptr;
+	d.refCount = nullptr;
 }
 
 Datum& Datum::operator=(const Datum &d) {
-	if (this != &d && refCount != d.refCount) {
+	if (this != &d && (refCount == nullptr || refCount != d.refCount)) {
+		// d may be part of the data freed by reset()
+		const DatumType newType = d.type;
+		const decltype(u) newU = d.u;
+		int *newRefCount = d.share();
 		reset();
-		type = d.type;
-		u = d.u;
-		refCount = d.refCount;
-		*refCount += 1;
+		type = newType;
+		u = newU;
+		refCount = newRefCount;
+	}
+	ignoreGlobal = false;
+	return *this;
+}
+
+Datum& Datum::operator=(Datum &&d) {
+	if (this != &d) {
+		const DatumType newType = d.type;
+		const decltype(u) newU = d.u;
+		int *newRefCount = d.refCount;
+		d.type = VOID;
+		d.u.s = nullptr;
+		d.refCount = nullptr;
+
+		reset();
+		type = newType;
+		u = newU;
+		refCount = newRefCount;
 	}
 	ignoreGlobal = false;
 	return *this;
@@ -892,24 +982,21 @@ Datum& Datum::operator=(const Datum &d) {
 Datum::Datum(int val) {
 	u.i = val;
 	type = INT;
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
 Datum::Datum(double val) {
 	u.f = val;
 	type = FLOAT;
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
 Datum::Datum(const Common::String &val) {
 	u.s = new Common::String(val);
 	type = STRING;
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
@@ -921,8 +1008,7 @@ Datum::Datum(AbstractObject *val) {
 		*refCount += 1;
 	} else {
 		type = VOID;
-		refCount = new int;
-		*refCount = 1;
+		refCount = nullptr;
 	}
 	ignoreGlobal = false;
 }
@@ -930,98 +1016,120 @@ Datum::Datum(AbstractObject *val) {
 Datum::Datum(const CastMemberID &val) {
 	u.cast = new CastMemberID(val);
 	type = CASTREF;
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
 Datum::Datum(const Common::Point &point) {
 	type = POINT;
-	u.farr = new FArray;
-	u.farr->arr.push_back(Datum(point.x));
-	u.farr->arr.push_back(Datum(point.y));
-	refCount = new int;
-	*refCount = 1;
+	u.farr = new FArray(2);
+	u.farr->arr[0] = Datum(point.x);
+	u.farr->arr[1] = Datum(point.y);
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
 Datum::Datum(const Common::Rect &rect) {
 	type = RECT;
-	u.farr = new FArray;
-	u.farr->arr.push_back(Datum(rect.left));
-	u.farr->arr.push_back(Datum(rect.top));
-	u.farr->arr.push_back(Datum(rect.right));
-	u.farr->arr.push_back(Datum(rect.bottom));
-	refCount = new int;
-	*refCount = 1;
+	u.farr = new FArray(4);
+	u.farr->arr[0] = Datum(rect.left);
+	u.farr->arr[1] = Datum(rect.top);
+	u.farr->arr[2] = Datum(rect.right);
+	u.farr->arr[3] = Datum(rect.bottom);
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
-void Datum::reset() {
-	if (!refCount)
-		return;
+int *Datum::share() const {
+	if (!refCount) {
+		if (isImmediateDatumType(type))
+			return nullptr;
 
-	*refCount -= 1;
-	// Coverity thinks that we always free memory, as it assumes
-	// (correctly) that there are cases when refCount == 0
-	// Thus, DO NOT COMPILE, trick it and shut tons of false positives
+		// The data is shared from now on
+		refCount = new int;
+		*refCount = 1;
+	}
+	*refCount += 1;
+	return refCount;
+}
+
+void Datum::reset() {
+	if (refCount) {
+		*refCount -= 1;
+		// Coverity thinks that we always free memory, as it assumes
+		// (correctly) that there are cases when refCount == 0
+		// Thus, DO NOT COMPILE, trick it and shut tons of false positives
 #ifndef __COVERITY__
-	if (*refCount <= 0) {
-		switch (type) {
-		case VOID:
-		case INT:
-		case FLOAT:
-		case ARGC:
-		case ARGCNORET:
-			break;
-		case VARREF:
-		case GLOBALREF:
-		case LOCALREF:
-		case PROPREF:
-		case STRING:
-		case SYMBOL:
-			delete u.s;
-			break;
-		case ARRAY:
-		case POINT:
-		case RECT:
-			delete u.farr;
-			break;
-		case PARRAY:
-			delete u.parr;
-			break;
-		case OBJECT:
-			if (u.obj->getObjType() == kWindowObj) {
-				// Window has an override for decRefCount, use it directly
+		if (*refCount <= 0) {
+			freeData();
+			if (type != OBJECT) // object owns refCount
+				delete refCount;
+		}
+#endif
+	} else if (!isImmediateDatumType(type)) {
+#ifndef __COVERITY__
+		freeData();
+#endif
+	}
+
+	type = VOID;
+	u.s = nullptr;
+	refCount = nullptr;
+}
+
+void Datum::freeData() {
+	switch (type) {
+	case VOID:
+	case INT:
+	case FLOAT:
+	case ARGC:
+	case ARGCNORET:
+		break;
+	case VARREF:
+	case GLOBALREF:
+	case LOCALREF:
+	case PROPREF:
+	case STRING:
+	case SYMBOL:
+		delete u.s;
+		break;
+	case ARRAY:
+	case POINT:
+	case RECT:
+		delete u.farr;
+		break;
+	case PARRAY:
+		delete u.parr;
+		break;
+	case OBJECT:
+		if (u.obj->getObjType() == kWindowObj) {
+			// Window has an override for decRefCount, use it directly
+			if (refCount)
 				*refCount += 1;
-				static_cast<Window *>(u.obj)->decRefCount();
-			} else {
-				// *refCount is copied between the Datum and the Object,
-				// so should be safe to delete the Object
-				delete u.obj;
-			}
-			break;
-		case CHUNKREF:
-			delete u.cref;
-			break;
-		case CASTREF:
-		case FIELDREF:
-			delete u.cast;
-			break;
-		case MENUREF:
-			delete u.menu;
-			break;
-		case PICTUREREF:
-			delete u.picture;
-			break;
-		default:
-			warning("Datum::reset(): Unprocessed REF type %d", type);
-			break;
+			static_cast<Window *>(u.obj)->decRefCount();
+		} else {
+			// *refCount is copied between the Datum and the Object,
+			// so should be safe to delete the Object
+			delete u.obj;
 		}
-		if (type != OBJECT) // object owns refCount
-			delete refCount;
+		break;
+	case CHUNKREF:
+		delete u.cref;
+		break;
+	case CASTREF:
+	case FIELDREF:
+		delete u.cast;
+		break;
+	case MENUREF:
+		delete u.menu;
+		break;
+	case PICTUREREF:
+		delete u.picture;
+		break;
+	default:
+		warning("Datum::reset(): Unprocessed REF type %d", type);
+		break;
 	}
-#endif
 }
 
 Datum Datum::eval() const {
@@ -1473,6 +1581,7 @@ void Lingo::runTests() {
 	Common::sort(fileList.begin(), fileList.end());
 
 	int counter = 1;
+	uint32 totalTime = 0;
 
 	for (uint i = 0; i < fileList.size(); i++) {
 		Common::SeekableReadStream *const  stream = SearchMan.createReadStreamForMember(fileList[i]);
@@ -1488,10 +1597,20 @@ void Lingo::runTests() {
 			mainArchive->addCode(Common::U32String(script, Common::kMacRoman), kTestScript, counter);
 
 			if (!debugChannelSet(-1, kDebugCompileOnly)) {
-				if (!_compiler->_hadError)
-					executeScript(kTestScript, CastMemberID(counter, DEFAULT_CAST_LIB));
-				else
+				if (!_compiler->_hadError) {
+					if (debugChannelSet(-1, kDebugLingoBenchmark)) {
+						const uint32 start = g_system->getMillis();
+						for (int run = 0; run < kLingoBenchmarkRuns; run++)
+							executeScript(kTestScript, CastMemberID(counter, DEFAULT_CAST_LIB));
+						const uint32 time = g_system->getMillis() - start;
+						debug(">> Executed %d times in %u ms", kLingoBenchmarkRuns, time);
+						totalTime += time;
+					} else {
+						executeScript(kTestScript, CastMemberID(counter, DEFAULT_CAST_LIB));
+					}
+				} else {
 					debug(">> Skipping execution");
+				}
 			}
 
 			free(script);
@@ -1501,6 +1620,9 @@ void Lingo::runTests() {
 
 		inFile.close();
 	}
+
+	if (debugChannelSet(-1, kDebugLingoBenchmark))
+		debug(">> Executed all the tests %d times in %u ms", kLingoBenchmarkRuns, totalTime);
 }
 
 void Lingo::executeImmediateScripts(Frame *frame) {
@@ -143,13 +143,18 @@ struct Datum {	/* interpreter stack type */
 		PictureReference *picture; /* PICTUREREF */
 	} u;
 
-	int *refCount;
+	// Shared between the copies of the value. It is only allocated when a
+	// value which refers to other data is copied; until then, a nullptr
+	// means that the Datum is the only owner of that data.
+	mutable int *refCount;
 
 	bool ignoreGlobal; // True if this Datum should be ignored by showGlobals and clearGlobals
 
 	Datum();
 	Datum(const Datum &d);
+	Datum(Datum &&d);
 	Datum& operator=(const Datum &d);
+	Datum& operator=(Datum &&d);
 	Datum(int val);
 	Datum(double val);
 	Datum(const Common::String &val);
@@ -186,6 +191,12 @@ struct Datum {	/* interpreter stack type */
 	bool operator<(Datum &d) const;
 	bool operator>=(Datum &d) const;
 	bool operator<=(Datum &d) const;
+
+private:
+	// Take a new reference to the data of this value, if it has any
+	int *share() const;
+	// Free the data referred to by this value
+	void freeData();
 };
 
 struct ChunkReference {
@@ -260,6 +271,19 @@ struct CFrame {	/* proc/func call stack frame */
 	Common::Array<Datum> paramList;		/* original argument list */
 };
 
+// What execute() spent its time on, since the last reset
+struct LingoExecStats {
+	uint32 start;			/* time of the last reset */
+	uint64 instructions;
+	uint32 pumps;			/* events processed and widgets updated while executing */
+	uint32 pumpTime;
+	uint32 presents;		/* screen updates while executing */
+	uint32 presentTime;
+
+	LingoExecStats() { reset(); }
+	void reset();
+};
+
 struct LingoEvent {
 	LEvent event;
 	int eventId;
@@ -407,6 +431,8 @@ public:
 public:
 	bool execute();
 	void switchStateFromWindow();
+	// Process events, and update the screen, during a long execution
+	void pumpEvents(uint32 now, bool throttlePresent);
 	void freezeState();
 	void freezePlayState();
 	void pushContext(const Symbol funcSym, bool allowRetVal, Datum defaultRetVal, int paramCount, int nargs);
@@ -546,6 +572,9 @@ public:
 
 	uint _globalCounter;
 
+	LingoExecStats _execStats;
+	uint32 _lastPresentTime;
+
 	StackData _stack;
 
 	DirectorEngine *_vm;
@@ -28,6 +28,9 @@ namespace Director {
 
 enum {
 	kFewFamesMaxCounter = 19,
+	kLingoBenchmarkRuns = 100,
+	kLingoClockCheckInterval = 16,
+	kLingoRecordedPumpInterval = 100,
 };
 
 enum {
@@ -28,7 +28,8 @@ void Glulx::execute_loop() {
 	bool done_executing = false;
 	int ix;
 	uint opcode;
-	const operandlist_t *oplist;
+	decodedinst_t *decoded;
+	decodedinst_t ramdecoded;
 	oparg_t inst[MAX_OPERANDS];
 	uint value, addr, val0, val1;
 	int vals0, vals1;
@@ -48,44 +49,28 @@ void Glulx::execute_loop() {
 		/* Stash the current opcode's address, in case the interpreter needs to serialize the VM state out-of-band. */
 		prevpc = pc;
 
-		/* Fetch the opcode number. */
-		opcode = Mem1(pc);
-		pc++;
-		if (opcode & 0x80) {
-			/* More than one-byte opcode. */
-			if (opcode & 0x40) {
-				/* Four-byte opcode */
-				opcode &= 0x3F;
-				opcode = (opcode << 8) | Mem1(pc);
-				pc++;
-				opcode = (opcode << 8) | Mem1(pc);
-				pc++;
-				opcode = (opcode << 8) | Mem1(pc);
-				pc++;
+		/* Decode the instruction, or find it already decoded if it's in ROM.
+		   Then load the actual operand values into inst, and move the PC up
+		   to the end of the instruction. */
+		if (pc < ramstart) {
+			decoded = &decode_cache[pc & (DECODE_CACHE_SIZE - 1)];
+			if (decoded->addr == pc) {
+				decode_cache_hits++;
 			} else {
-				/* Two-byte opcode */
-				opcode &= 0x7F;
-				opcode = (opcode << 8) | Mem1(pc);
-				pc++;
+				decode_cache_misses++;
+				decode_instruction(decoded);
+				/* An instruction running over into RAM can't be kept */
+				if (decoded->nextpc > ramstart)
+					decoded->addr = DECODE_CACHE_EMPTY;
 			}
+		} else {
+			decoded = &ramdecoded;
+			decode_instruction(decoded);
 		}
 
-		/* Now we have an opcode number. */
-
-		/* Fetch the structure that describes how the operands for this
-		   opcode are arranged. This is a pointer to an immutable,
-		   static object. */
-		if (opcode < 0x80)
-			oplist = fast_operandlist[opcode];
-		else
-			oplist = lookup_operandlist(opcode);
-
-		if (!oplist)
-			fatal_error_i("Encountered unknown opcode.", opcode);
-
-		/* Based on the oplist structure, load the actual operand values
-		   into inst. This moves the PC up to the end of the instruction. */
-		parse_operands(inst, oplist);
+		opcode = decoded->opcode;
+		pc = decoded->nextpc;
+		load_operands(inst, decoded);
 
 		/* Perform the opcode. This switch statement is split in two, based
 		   on some paranoid suspicions about the ability of compilers to
@@ -35,6 +35,7 @@ void Glulx::enter_function(uint funcaddr, uint argc, uint *argv) {
 
 	accelFunc = accel_get_func(addr);
 	if (accelFunc) {
+		accel_calls++;
 		profile_in(addr, stackptr, true);
 		val = (this->*accelFunc)(argc, argv);
 		profile_out(stackptr);
@@ -39,7 +39,9 @@ Glulx::Glulx(OSystem *syst, const GlkGameDescription &gameDesc) : GlkAPI(syst, g
 		// accel
 		classes_table(0), indiv_prop_start(0), class_metaclass(0), object_metaclass(0),
 		routine_metaclass(0), string_metaclass(0), self(0), num_attr_bytes(0), cpv__start(0),
-		accelentries(nullptr),
+		accelentries(nullptr), accel_calls(0),
+		// operand
+		decode_cache(nullptr), decode_cache_hits(0), decode_cache_misses(0),
 		// heap
 		heap_start(0), alloc_count(0), heap_head(nullptr), heap_tail(nullptr),
 		// serial
@@ -65,7 +67,13 @@ void Glulx::runGame() {
 	if (library_autorestore_hook)
 		library_autorestore_hook();
 
+	uint32 startTime = g_system->getMillis();
 	execute_loop();
+
+	// Timings for benchmarking, which are meaningful for stories which run without waiting for input
+	debugC(kDebugScripts, "Glulx ran for %u ms: %llu ROM instructions found decoded, %llu decoded, %llu accelerated calls",
+		g_system->getMillis() - startTime, (unsigned long long)decode_cache_hits,
+		(unsigned long long)decode_cache_misses, (unsigned long long)accel_calls);
 	finalize_vm();
 
 	gamefile_start = 0;
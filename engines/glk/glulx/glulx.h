@@ -104,6 +104,12 @@ private:
 	uint cpv__start;        ///< array of common prop defaults
 	accelentry_t **accelentries;
 
+	/**
+	 * Number of calls handled by an accelerated function rather than by running the function's
+	 * code. Together with the decode cache counts, this shows how much of a game runs natively.
+	 */
+	uint64 accel_calls;
+
 	/**@}*/
 
 	/**
@@ -145,6 +151,16 @@ private:
 	 */
 	const operandlist_t *fast_operandlist[0x80];
 
+	/**
+	 * Decoded instructions in ROM, indexed by the low bits of their address.
+	 */
+	enum : uint {
+		DECODE_CACHE_SIZE = 4096,   ///< Number of entries in the cache; must be a power of two
+		DECODE_CACHE_EMPTY = 0xFFFFFFFF
+	};
+	decodedinst_t *decode_cache;
+	uint64 decode_cache_hits, decode_cache_misses;
+
 	/**@}*/
 
 	/**
@@ -543,13 +559,21 @@ public:
 	const operandlist_t *lookup_operandlist(uint opcode);
 
 	/**
-	 * Read the list of operands of an instruction, and put the values in args. This assumes
-	 * that the PC is at the beginning of the operand mode list (right after an opcode number.)
-	 * Upon return, the PC will be at the beginning of the next instruction.
-	 *
-	 * This also assumes that args points at an allocated array of MAX_OPERANDS oparg_t structures.
-	*/
-	void parse_operands(oparg_t *opargs, const operandlist_t *oplist);
+	 * Decode the instruction at the PC: its opcode, and the addressing modes and constants of its
+	 * operands. The PC isn't changed; the address of the next instruction is put in inst->nextpc.
+	 */
+	void decode_instruction(decodedinst_t *inst);
+
+	/**
+	 * Fetch the values of the operands of a decoded instruction, and put them in args. This
+	 * assumes that args points at an allocated array of MAX_OPERANDS oparg_t structures.
+	 */
+	void load_operands(oparg_t *args, const decodedinst_t *inst);
+
+	/**
+	 * Forget all decoded instructions. This has to be done whenever ROM changes.
+	 */
+	void decode_cache_invalidate();
 
 	/**
 	 * Store a result value, according to the desttype and destaddress given. This is usually used to store
@@ -85,7 +85,8 @@ class Glulx;
 #define VerifyW(adr, ln) verify_address_write(adr, ln)
 #else
 #define Verify(adr, ln) (0)
-#define VerifyW(adr, ln) (0)
+/* Writes to ROM aren't caught, so they have to drop the decoded instructions */
+#define VerifyW(adr, ln) ((adr) < ramstart ? decode_cache_invalidate() : (void)0)
 #endif /* VERIFY_MEMORY_ACCESS */
 
 #define Mem1(adr)  (Read1(memmap+(adr)))
@@ -351,6 +352,41 @@ typedef oparg_struct oparg_t;
 
 #define MAX_OPERANDS (8)
 
+/**
+ * How an operand of a decoded instruction is fetched when the instruction is executed.
+ */
+enum decodemode {
+	decode_Const = 0,       ///< The value is a constant
+	decode_Pop = 1,         ///< The value is popped off the stack
+	decode_Mem = 2,         ///< The value is read from main memory, at an absolute address
+	decode_Locals = 3,      ///< The value is read from the locals segment
+	decode_Store = 4        ///< A store operand, whose destination is already known
+};
+
+/**
+ * Represents one operand of an instruction, with its addressing mode decoded but its value not yet fetched.
+ */
+struct decodedop_struct {
+	byte mode;              ///< One of the decodemode values
+	byte desttype;          ///< Destination type of a store operand, as in oparg_t
+	uint value;             ///< Constant, address or store destination, depending on the mode
+};
+typedef decodedop_struct decodedop_t;
+
+/**
+ * Represents an instruction whose opcode and operand modes have been decoded. Since ROM can't
+ * change, instructions in it are kept decoded in a cache, and only their operand values are
+ * fetched each time they are run.
+ */
+struct decodedinst_struct {
+	uint addr;              ///< Address of the instruction; Glulx::DECODE_CACHE_EMPTY for an unused cache entry
+	uint opcode;
+	const operandlist_t *oplist;
+	uint nextpc;            ///< Address of the following instruction
+	decodedop_t ops[MAX_OPERANDS];
+};
+typedef decodedinst_struct decodedinst_t;
+
 typedef uint(Glulx::*acceleration_func)(uint argc, uint *argv);
 
 struct accelentry_struct {
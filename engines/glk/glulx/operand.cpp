@@ -66,6 +66,13 @@ static const operandlist_t list_LLSS = { 4, 4, &array_LLSS[0] };
 void Glulx::init_operands() {
 	for (int ix = 0; ix < 0x80; ix++)
 		fast_operandlist[ix] = lookup_operandlist(ix);
+
+	if (!decode_cache) {
+		decode_cache = (decodedinst_t *)glulx_malloc(DECODE_CACHE_SIZE * sizeof(decodedinst_t));
+		if (!decode_cache)
+			fatal_error("Unable to allocate the decoded instruction cache.");
+	}
+	decode_cache_invalidate();
 }
 
 const operandlist_t *Glulx::lookup_operandlist(uint opcode) {
@@ -279,22 +286,60 @@ const operandlist_t *Glulx::lookup_operandlist(uint opcode) {
 	}
 }
 
-void Glulx::parse_operands(oparg_t *args, const operandlist_t *oplist) {
+void Glulx::decode_instruction(decodedinst_t *inst) {
 	int ix;
-	oparg_t *curarg;
+	decodedop_t *curop;
+	uint opcode;
+	const operandlist_t *oplist;
+	uint addr = pc;
+
+	/* Don't leave a half-decoded instruction in the cache if anything goes wrong */
+	inst->addr = DECODE_CACHE_EMPTY;
+
+	/* Fetch the opcode number. */
+	opcode = Mem1(addr);
+	addr++;
+	if (opcode & 0x80) {
+		/* More than one-byte opcode. */
+		if (opcode & 0x40) {
+			/* Four-byte opcode */
+			opcode &= 0x3F;
+			opcode = (opcode << 8) | Mem1(addr);
+			addr++;
+			opcode = (opcode << 8) | Mem1(addr);
+			addr++;
+			opcode = (opcode << 8) | Mem1(addr);
+			addr++;
+		} else {
+			/* Two-byte opcode */
+			opcode &= 0x7F;
+			opcode = (opcode << 8) | Mem1(addr);
+			addr++;
+		}
+	}
+
+	/* Fetch the structure that describes how the operands for this
+	   opcode are arranged. This is a pointer to an immutable,
+	   static object. */
+	if (opcode < 0x80)
+		oplist = fast_operandlist[opcode];
+	else
+		oplist = lookup_operandlist(opcode);
+
+	if (!oplist)
+		fatal_error_i("Encountered unknown opcode.", opcode);
+
+	inst->opcode = opcode;
+	inst->oplist = oplist;
+
 	int numops = oplist->num_ops;
-	int argsize = oplist->arg_size;
-	uint modeaddr = pc;
+	uint modeaddr = addr;
 	int modeval = 0;
 
-	pc += (numops + 1) / 2;
+	addr += (numops + 1) / 2;
 
-	for (ix = 0, curarg = args; ix < numops; ix++, curarg++) {
+	for (ix = 0, curop = inst->ops; ix < numops; ix++, curop++) {
 		int mode;
-		uint value;
-		uint addr;
-
-		curarg->desttype = 0;
 
 		if ((ix & 1) == 0) {
 			modeval = Mem1(modeaddr);
@@ -304,203 +349,175 @@ void Glulx::parse_operands(oparg_t *args, const operandlist_t *oplist) {
 			modeaddr++;
 		}
 
+		curop->desttype = 0;
+		curop->value = 0;
+
 		if (oplist->formlist[ix] == modeform_Load) {
 
 			switch (mode) {
 
 			case 8: /* pop off stack */
-				if (stackptr < valstackbase + 4) {
-					fatal_error("Stack underflow in operand.");
-				}
-				stackptr -= 4;
-				value = Stk4(stackptr);
+				curop->mode = decode_Pop;
 				break;
 
 			case 0: /* constant zero */
-				value = 0;
+				curop->mode = decode_Const;
 				break;
 
 			case 1: /* one-byte constant */
 				/* Sign-extend from 8 bits to 32 */
-				value = (int)(signed char)(Mem1(pc));
-				pc++;
+				curop->mode = decode_Const;
+				curop->value = (int)(signed char)(Mem1(addr));
+				addr++;
 				break;
 
 			case 2: /* two-byte constant */
 				/* Sign-extend the first byte from 8 bits to 32; the subsequent
 				   byte must not be sign-extended. */
-				value = (int)(signed char)(Mem1(pc));
-				pc++;
-				value = (value << 8) | (uint)(Mem1(pc));
-				pc++;
+				curop->mode = decode_Const;
+				curop->value = (int)(signed char)(Mem1(addr));
+				addr++;
+				curop->value = (curop->value << 8) | (uint)(Mem1(addr));
+				addr++;
 				break;
 
 			case 3: /* four-byte constant */
 				/* Bytes must not be sign-extended. */
-				value = Mem4(pc);
-				pc += 4;
+				curop->mode = decode_Const;
+				curop->value = Mem4(addr);
+				addr += 4;
 				break;
 
 			case 15: /* main memory RAM, four-byte address */
-				addr = Mem4(pc);
-				addr += ramstart;
-				pc += 4;
-				goto MainMemAddr;
+				curop->mode = decode_Mem;
+				curop->value = Mem4(addr) + ramstart;
+				addr += 4;
+				break;
 
 			case 14: /* main memory RAM, two-byte address */
-				addr = (uint)Mem2(pc);
-				addr += ramstart;
-				pc += 2;
-				goto MainMemAddr;
+				curop->mode = decode_Mem;
+				curop->value = (uint)Mem2(addr) + ramstart;
+				addr += 2;
+				break;
 
 			case 13: /* main memory RAM, one-byte address */
-				addr = (uint)(Mem1(pc));
-				addr += ramstart;
-				pc++;
-				goto MainMemAddr;
+				curop->mode = decode_Mem;
+				curop->value = (uint)(Mem1(addr)) + ramstart;
+				addr++;
+				break;
 
 			case 7: /* main memory, four-byte address */
-				addr = Mem4(pc);
-				pc += 4;
-				goto MainMemAddr;
+				curop->mode = decode_Mem;
+				curop->value = Mem4(addr);
+				addr += 4;
+				break;
 
 			case 6: /* main memory, two-byte address */
-				addr = (uint)Mem2(pc);
-				pc += 2;
-				goto MainMemAddr;
+				curop->mode = decode_Mem;
+				curop->value = (uint)Mem2(addr);
+				addr += 2;
+				break;
 
 			case 5: /* main memory, one-byte address */
-				addr = (uint)(Mem1(pc));
-				pc++;
-				/* fall through */
-
-MainMemAddr:
-				/* cases 5, 6, 7, 13, 14, 15 all wind up here. */
-				if (argsize == 4) {
-					value = Mem4(addr);
-				} else if (argsize == 2) {
-					value = Mem2(addr);
-				} else {
-					value = Mem1(addr);
-				}
+				curop->mode = decode_Mem;
+				curop->value = (uint)(Mem1(addr));
+				addr++;
 				break;
 
 			case 11: /* locals, four-byte address */
-				addr = Mem4(pc);
-				pc += 4;
-				goto LocalsAddr;
+				curop->mode = decode_Locals;
+				curop->value = Mem4(addr);
+				addr += 4;
+				break;
 
 			case 10: /* locals, two-byte address */
-				addr = (uint)Mem2(pc);
-				pc += 2;
-				goto LocalsAddr;
+				curop->mode = decode_Locals;
+				curop->value = (uint)Mem2(addr);
+				addr += 2;
+				break;
 
 			case 9: /* locals, one-byte address */
-				addr = (uint)(Mem1(pc));
-				pc++;
-				/* fall through */
-
-LocalsAddr:
-				/* cases 9, 10, 11 all wind up here. It's illegal for addr to not
-				   be four-byte aligned, but we don't check this explicitly.
-				   A "strict mode" interpreter probably should. It's also illegal
-				   for addr to be less than zero or greater than the size of
-				   the locals segment. */
-				addr += localsbase;
-				if (argsize == 4) {
-					value = Stk4(addr);
-				} else if (argsize == 2) {
-					value = Stk2(addr);
-				} else {
-					value = Stk1(addr);
-				}
+				/* It's illegal for the address to not be four-byte aligned, but
+				   we don't check this explicitly. A "strict mode" interpreter
+				   probably should. It's also illegal for it to be less than zero
+				   or greater than the size of the locals segment. */
+				curop->mode = decode_Locals;
+				curop->value = (uint)(Mem1(addr));
+				addr++;
 				break;
 
 			default:
-				value = 0;
 				fatal_error("Unknown addressing mode in load operand.");
 			}
 
-			curarg->value = value;
-
 		} else { /* modeform_Store */
+			curop->mode = decode_Store;
+
 			switch (mode) {
 
 			case 0: /* discard value */
-				curarg->desttype = 0;
-				curarg->value = 0;
+				curop->desttype = 0;
 				break;
 
 			case 8: /* push on stack */
-				curarg->desttype = 3;
-				curarg->value = 0;
+				curop->desttype = 3;
 				break;
 
 			case 15: /* main memory RAM, four-byte address */
-				addr = Mem4(pc);
-				addr += ramstart;
-				pc += 4;
-				goto WrMainMemAddr;
+				curop->desttype = 1;
+				curop->value = Mem4(addr) + ramstart;
+				addr += 4;
+				break;
 
 			case 14: /* main memory RAM, two-byte address */
-				addr = (uint)Mem2(pc);
-				addr += ramstart;
-				pc += 2;
-				goto WrMainMemAddr;
+				curop->desttype = 1;
+				curop->value = (uint)Mem2(addr) + ramstart;
+				addr += 2;
+				break;
 
 			case 13: /* main memory RAM, one-byte address */
-				addr = (uint)(Mem1(pc));
-				addr += ramstart;
-				pc++;
-				goto WrMainMemAddr;
+				curop->desttype = 1;
+				curop->value = (uint)(Mem1(addr)) + ramstart;
+				addr++;
+				break;
 
 			case 7: /* main memory, four-byte address */
-				addr = Mem4(pc);
-				pc += 4;
-				goto WrMainMemAddr;
+				curop->desttype = 1;
+				curop->value = Mem4(addr);
+				addr += 4;
+				break;
 
 			case 6: /* main memory, two-byte address */
-				addr = (uint)Mem2(pc);
-				pc += 2;
-				goto WrMainMemAddr;
+				curop->desttype = 1;
+				curop->value = (uint)Mem2(addr);
+				addr += 2;
+				break;
 
 			case 5: /* main memory, one-byte address */
-				addr = (uint)(Mem1(pc));
-				pc++;
-				/* fall through */
-
-WrMainMemAddr:
-				/* cases 5, 6, 7 all wind up here. */
-				curarg->desttype = 1;
-				curarg->value = addr;
+				curop->desttype = 1;
+				curop->value = (uint)(Mem1(addr));
+				addr++;
 				break;
 
 			case 11: /* locals, four-byte address */
-				addr = Mem4(pc);
-				pc += 4;
-				goto WrLocalsAddr;
+				curop->desttype = 2;
+				curop->value = Mem4(addr);
+				addr += 4;
+				break;
 
 			case 10: /* locals, two-byte address */
-				addr = (uint)Mem2(pc);
-				pc += 2;
-				goto WrLocalsAddr;
+				curop->desttype = 2;
+				curop->value = (uint)Mem2(addr);
+				addr += 2;
+				break;
 
 			case 9: /* locals, one-byte address */
-				addr = (uint)(Mem1(pc));
-				pc++;
-				/* fall through */
-
-WrLocalsAddr:
-				/* cases 9, 10, 11 all wind up here. It's illegal for addr to not
-				   be four-byte aligned, but we don't check this explicitly.
-				   A "strict mode" interpreter probably should. It's also illegal
-				   for addr to be less than zero or greater than the size of
-				   the locals segment. */
-				curarg->desttype = 2;
 				/* We don't add localsbase here; the store address for desttype 2
 				   is relative to the current locals segment, not an absolute
 				   stack position. */
-				curarg->value = addr;
+				curop->desttype = 2;
+				curop->value = (uint)(Mem1(addr));
+				addr++;
 				break;
 
 			case 1:
@@ -514,6 +531,71 @@ WrLocalsAddr:
 			}
 		}
 	}
+
+	inst->addr = pc;
+	inst->nextpc = addr;
+}
+
+void Glulx::load_operands(oparg_t *args, const decodedinst_t *inst) {
+	int ix;
+	oparg_t *curarg;
+	const decodedop_t *curop;
+	int numops = inst->oplist->num_ops;
+	int argsize = inst->oplist->arg_size;
+	uint addr;
+
+	for (ix = 0, curarg = args, curop = inst->ops; ix < numops; ix++, curarg++, curop++) {
+		curarg->desttype = curop->desttype;
+
+		switch (curop->mode) {
+
+		case decode_Const:
+		case decode_Store:
+			curarg->value = curop->value;
+			break;
+
+		case decode_Pop:
+			if (stackptr < valstackbase + 4) {
+				fatal_error("Stack underflow in operand.");
+			}
+			stackptr -= 4;
+			curarg->value = Stk4(stackptr);
+			break;
+
+		case decode_Mem:
+			addr = curop->value;
+			if (argsize == 4) {
+				curarg->value = Mem4(addr);
+			} else if (argsize == 2) {
+				curarg->value = Mem2(addr);
+			} else {
+				curarg->value = Mem1(addr);
+			}
+			break;
+
+		case decode_Locals:
+			addr = curop->value + localsbase;
+			if (argsize == 4) {
+				curarg->value = Stk4(addr);
+			} else if (argsize == 2) {
+				curarg->value = Stk2(addr);
+			} else {
+				curarg->value = Stk1(addr);
+			}
+			break;
+
+		default:
+			break;
+		}
+	}
+}
+
+void Glulx::decode_cache_invalidate() {
+	if (!decode_cache)
+		return;
+
+	for (uint ix = 0; ix < DECODE_CACHE_SIZE; ix++)
+		decode_cache[ix].addr = DECODE_CACHE_EMPTY;
 }
 
 void Glulx::store_operand(uint desttype, uint destaddr, uint storeval) {
@@ -110,6 +110,10 @@ void Glulx::finalize_vm() {
 		glulx_free(memmap);
 		memmap = nullptr;
 	}
+	if (decode_cache) {
+		glulx_free(decode_cache);
+		decode_cache = nullptr;
+	}
 	if (stack) {
 		glulx_free(stack);
 		stack = nullptr;
@@ -154,6 +158,7 @@ void Glulx::vm_restart() {
 	for (lx = endgamefile; lx < origendmem; lx++) {
 		memmap[lx] = 0;
 	}
+	decode_cache_invalidate();
 
 	/* Reset all the registers */
 	stackptr = 0;
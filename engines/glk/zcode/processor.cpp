@@ -134,7 +134,7 @@ Opcode Processor::ext_opcodes[64] = {
 Processor::Processor(OSystem *syst, const GlkGameDescription &gameDesc) :
 		GlkInterface(syst, gameDesc),
 		_finished(0), _sp(nullptr), _fp(nullptr), _frameCount(0),
-		zargc(0), _decoded(nullptr), _encoded(nullptr), _resolution(0),
+		zargc(0), _decodeCache(nullptr), _decodeCacheHits(0), _decodeCacheMisses(0), _decoded(nullptr), _encoded(nullptr), _resolution(0),
 		_randomInterval(0), _randomCtr(0), first_restart(true), script_valid(false),
 		_bufPos(0), _locked(false), _prevC('\0'), script_width(0),
 		sfp(nullptr), rfp(nullptr), pfp(nullptr), ostream_screen(true), ostream_script(false),
@@ -186,6 +186,10 @@ Processor::Processor(OSystem *syst, const GlkGameDescription &gameDesc) :
 	Common::fill(&_errorCount[0], &_errorCount[ERR_NUM_ERRORS], 0);
 }
 
+Processor::~Processor() {
+	delete[] _decodeCache;
+}
+
 void Processor::initialize() {
 	Mem::initialize();
 	GlkInterface::initialize();
@@ -197,6 +201,12 @@ void Processor::initialize() {
 		op0_opcodes[9] = &Processor::z_catch;
 		op1_opcodes[15] = &Processor::z_call_n;
 	}
+
+	// The story and the opcode handlers have changed, so drop anything decoded so far
+	if (!_decodeCache)
+		_decodeCache = new DecodedInstruction[DECODE_CACHE_SIZE];
+	for (uint i = 0; i < DECODE_CACHE_SIZE; i++)
+		_decodeCache[i]._pc = DECODE_CACHE_EMPTY;
 }
 
 void Processor::load_operand(zbyte type) {
@@ -242,48 +252,130 @@ void Processor::load_all_operands(zbyte specifier) {
 	}
 }
 
-void Processor::interpret() {
-	do {
-		zbyte opcode;
-		CODE_BYTE(opcode);
-		zargc = 0;
+void Processor::decodeOperand(DecodedInstruction &inst, zbyte type) {
+	zword value;
 
-		if (opcode < 0x80) {
-			// 2OP opcodes
-			load_operand((zbyte)(opcode & 0x40) ? 2 : 1);
-			load_operand((zbyte)(opcode & 0x20) ? 2 : 1);
+	if (type & 2) {
+		// variable, which is read when the instruction runs
+		zbyte variable;
 
-			(*this.*var_opcodes[opcode & 0x1f])();
+		CODE_BYTE(variable);
+		value = variable;
+	} else if (type & 1) {
+		// small constant
+		zbyte bvalue;
 
-		} else if (opcode < 0xb0) {
-			// 1OP opcodes
-			load_operand((zbyte)(opcode >> 4));
+		CODE_BYTE(bvalue);
+		value = bvalue;
 
-			(*this.*op1_opcodes[opcode & 0x0f])();
+	} else {
+		// large constant
+		CODE_WORD(value);
+	}
 
-		} else if (opcode < 0xc0) {
-			// 0OP opcodes
-			(*this.*op0_opcodes[opcode - 0xb0])();
+	inst._types[inst._argc] = type;
+	inst._values[inst._argc++] = value;
+}
 
+void Processor::decodeInstruction(DecodedInstruction &inst) {
+	uint pc = getPC();
+	zbyte opcode;
+	CODE_BYTE(opcode);
+	inst._argc = 0;
 
-		} else {
-			// VAR opcodes
-			zbyte specifier1;
-			zbyte specifier2;
-
-			if (opcode == 0xec || opcode == 0xfa) {	// opcodes 0xec
-				CODE_BYTE(specifier1);			// and 0xfa are
-				CODE_BYTE(specifier2);          // call opcodes
-				load_all_operands(specifier1);	// with up to 8
-				load_all_operands(specifier2);	// arguments
-			} else {
-				CODE_BYTE(specifier1);
-				load_all_operands(specifier1);
+	if (opcode < 0x80) {
+		// 2OP opcodes
+		decodeOperand(inst, (zbyte)(opcode & 0x40) ? 2 : 1);
+		decodeOperand(inst, (zbyte)(opcode & 0x20) ? 2 : 1);
+
+		inst._handler = var_opcodes[opcode & 0x1f];
+
+	} else if (opcode < 0xb0) {
+		// 1OP opcodes
+		decodeOperand(inst, (zbyte)(opcode >> 4));
+
+		inst._handler = op1_opcodes[opcode & 0x0f];
+
+	} else if (opcode < 0xc0) {
+		// 0OP opcodes
+		inst._handler = op0_opcodes[opcode - 0xb0];
+
+	} else {
+		// VAR opcodes
+		zbyte specifier[2];
+		int specifiers = (opcode == 0xec || opcode == 0xfa) ? 2 : 1;
+
+		// opcodes 0xec and 0xfa are call opcodes with up to 8 arguments
+		for (int i = 0; i < specifiers; i++)
+			CODE_BYTE(specifier[i]);
+
+		for (int i = 0; i < specifiers; i++) {
+			for (int j = 6; j >= 0; j -= 2) {
+				zbyte type = (specifier[i] >> j) & 0x03;
+
+				if (type == 3)
+					break;
+
+				decodeOperand(inst, type);
+			}
+		}
+
+		inst._handler = var_opcodes[opcode - 0xc0];
+	}
+
+	inst._pc = pc;
+	inst._nextPC = getPC();
+}
+
+void Processor::loadDecodedOperands(const DecodedInstruction &inst) {
+	zargc = 0;
+
+	for (int i = 0; i < inst._argc; i++) {
+		zword value = inst._values[i];
+
+		if (inst._types[i] & 2) {
+			// variable
+			if (value == 0)
+				value = *_sp++;
+			else if (value < 16)
+				value = *(_fp - value);
+			else {
+				zword addr = h_globals + 2 * (value - 16);
+				LOW_WORD(addr, value);
 			}
+		}
+
+		zargs[zargc++] = value;
+	}
+}
 
-			(*this.*var_opcodes[opcode - 0xc0])();
+void Processor::interpret() {
+	DecodedInstruction dynamicInst;
+
+	do {
+		// Static memory can't change, so instructions there only need decoding once.
+		// Dynamic memory could be rewritten, so its instructions are decoded every time
+		DecodedInstruction *inst;
+		uint pc = getPC();
+
+		if (pc >= h_dynamic_size) {
+			inst = &_decodeCache[pc & (DECODE_CACHE_SIZE - 1)];
+
+			if (inst->_pc == pc) {
+				_decodeCacheHits++;
+				setPC(inst->_nextPC);
+			} else {
+				_decodeCacheMisses++;
+				decodeInstruction(*inst);
+			}
+		} else {
+			inst = &dynamicInst;
+			decodeInstruction(*inst);
 		}
 
+		loadDecodedOperands(*inst);
+		(*this.*inst->_handler)();
+
 #if defined(DJGPP) && defined(SOUND_SUPPORT)
 		if (end_of_sound_flag)
 			end_of_sound();
@@ -46,11 +46,29 @@ class Processor;
 class Quetzal;
 typedef void (Processor::*Opcode)();
 
+/**
+ * An instruction whose opcode and operand types have been decoded. Store and branch
+ * bytes, and inline strings, are still read from the code by the opcode handlers
+ */
+struct DecodedInstruction {
+	uint _pc;				///< Address of the instruction, or Processor::DECODE_CACHE_EMPTY if unused
+	uint _nextPC;			///< Address just past the operands
+	Opcode _handler;
+	zbyte _argc;
+	zbyte _types[8];		///< Operand types, as given by the operand specifiers
+	zword _values[8];		///< Constants, or the variable numbers of variable operands
+};
+
 /**
  * Zcode processor
  */
 class Processor : public GlkInterface, public virtual Mem {
 	friend class Quetzal;
+public:
+	enum : uint {
+		DECODE_CACHE_SIZE = 4096,		///< Entries in the decode cache; must be a power of two
+		DECODE_CACHE_EMPTY = 0xffffffff	///< Address of an unused decode cache entry
+	};
 private:
 	static const char *const ERR_MESSAGES[ERR_NUM_ERRORS];
 	static Opcode var_opcodes[64];
@@ -61,6 +79,10 @@ private:
 	int _finished;
 	zword zargs[8];
 	int zargc;
+
+	// Decoded instructions in static memory, indexed by the low bits of their address
+	DecodedInstruction *_decodeCache;
+	uint64 _decodeCacheHits, _decodeCacheMisses;
 	uint _randomInterval;
 	uint _randomCtr;
 	bool first_restart;
@@ -111,6 +133,21 @@ protected:
 	 */
 	void load_all_operands(zbyte specifier);
 
+	/**
+	 * Decode the instruction at the PC, and move the PC past its operands
+	 */
+	void decodeInstruction(DecodedInstruction &inst);
+
+	/**
+	 * Add an operand of the given type to a decoded instruction
+	 */
+	void decodeOperand(DecodedInstruction &inst, zbyte type);
+
+	/**
+	 * Load the operands of a decoded instruction, reading the variables it uses
+	 */
+	void loadDecodedOperands(const DecodedInstruction &inst);
+
 	/**
 	 * Call a subroutine. Save PC and FP then load new PC and initialise
 	 * new stack frame. Note that the caller may legally provide less or
@@ -1702,7 +1739,7 @@ public:
 	 * Constructor
 	 */
 	Processor(OSystem *syst, const GlkGameDescription &gameDesc);
-	~Processor() override {}
+	~Processor() override;
 
 	/**
 	 * Initialization
@@ -1714,6 +1751,12 @@ public:
 	 */
 	void interpret();
 
+	/**
+	 * Returns the number of instructions found in, and added to, the decoded instruction cache
+	 */
+	uint64 getDecodeCacheHits() const { return _decodeCacheHits; }
+	uint64 getDecodeCacheMisses() const { return _decodeCacheMisses; }
+
 	/**
 	 * \defgroup Memory access methods
 	 * @{
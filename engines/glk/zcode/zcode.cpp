@@ -76,6 +76,11 @@ void ZCode::runGame() {
 	// Game loop
 	interpret();
 
+	uint64 lookups = getDecodeCacheHits() + getDecodeCacheMisses();
+	debugC(kDebugScripts, "Decoded instruction cache: %llu hits, %llu misses (%d%% hit rate)",
+		(unsigned long long)getDecodeCacheHits(), (unsigned long long)getDecodeCacheMisses(),
+		lookups ? (int)(getDecodeCacheHits() * 100 / lookups) : 0);
+
 	if (!shouldQuit()) {
 		flush_buffer();
 		glk_exit();
@@ -601,6 +601,17 @@ public:
 	 */
 	DetectionResults detectGames(const Common::FSList &fslist, uint32 skipADFlags = 0, bool skipIncomplete = false);
 
+	/**
+	 * Run the detector of a single engine on the given directory contents,
+	 * like detectGames() does for all engines. This allows spreading the
+	 * detection of a directory over time, or abandoning it halfway.
+	 *
+	 * The caller has to clear the AdvancedDetector caches before running
+	 * the first engine on a directory, and close the archives it cached
+	 * after the last one, see detectGames().
+	 */
+	DetectedGames detectGames(const Plugin *plugin, const Common::FSList &fslist, uint32 skipADFlags = 0, bool skipIncomplete = false);
+
 	/** Find a plugin by its engine ID. */
 	const Plugin *findDetectionPlugin(const Common::String &engineId) const;
 
@@ -54,6 +54,7 @@
 #include "sci/video/seq_decoder.h"
 #ifdef ENABLE_SCI32
 #include "common/memstream.h"
+#include "sci/graphics/celobj32.h"
 #include "sci/graphics/frameout.h"
 #include "sci/graphics/paint32.h"
 #include "sci/graphics/palette32.h"
@@ -150,6 +151,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("vpi",                WRAP_METHOD(Console, cmdVisiblePlaneItemList));	// alias
 	registerCmd("saved_bits",         WRAP_METHOD(Console, cmdSavedBits));
 	registerCmd("show_saved_bits",    WRAP_METHOD(Console, cmdShowSavedBits));
+	registerCmd("cel_cache",          WRAP_METHOD(Console, cmdCelCache));
 	// Segments
 	registerCmd("segment_table",		WRAP_METHOD(Console, cmdPrintSegmentTable));
 	registerCmd("segtable",			WRAP_METHOD(Console, cmdPrintSegmentTable));	// alias
@@ -233,6 +235,8 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("bpe",				WRAP_METHOD(Console, cmdBreakpointFunction));		// alias
 	// VM
 	registerCmd("script_steps",		WRAP_METHOD(Console, cmdScriptSteps));
+	registerCmd("vm_stats",			WRAP_METHOD(Console, cmdVMStats));
+	registerCmd("vmstats",			WRAP_METHOD(Console, cmdVMStats));		// alias
 	registerCmd("script_objects",   WRAP_METHOD(Console, cmdScriptObjects));
 	registerCmd("scro",             WRAP_METHOD(Console, cmdScriptObjects));
 	registerCmd("script_strings",   WRAP_METHOD(Console, cmdScriptStrings));
@@ -386,6 +390,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" visible_plane_items / vpi - Shows a list of all items for a plane in the visible draw list (SCI2+)\n");
 	debugPrintf(" saved_bits - List saved bits on the hunk\n");
 	debugPrintf(" show_saved_bits - Display saved bits\n");
+	debugPrintf(" cel_cache - Shows statistics of the cel cache, resets them or resizes the cache (SCI2+)\n");
 	debugPrintf("\n");
 	debugPrintf("Segments:\n");
 	debugPrintf(" segment_table / segtable - Lists all segments\n");
@@ -447,6 +452,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf("\n");
 	debugPrintf("VM:\n");
 	debugPrintf(" script_steps - Shows the number of executed SCI operations\n");
+	debugPrintf(" vm_stats / vmstats - Shows the VM throughput and its decoding and send cache statistics\n");
 	debugPrintf(" script_objects / scro - Shows all objects inside a specified script\n");
 	debugPrintf(" script_strings / scrs - Shows all strings inside a specified script\n");
 	debugPrintf(" script_said - Shows all said - strings inside a specified script\n");
@@ -2411,6 +2417,43 @@ bool Console::cmdShowSavedBits(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdCelCache(int argc, const char **argv) {
+#ifdef ENABLE_SCI32
+	if (argc > 2) {
+		debugPrintf("Shows statistics of the cel cache.\n");
+		debugPrintf("Usage: %s [reset | <size>]\n", argv[0]);
+		debugPrintf("reset clears the statistics, <size> replaces the cache with an empty one of the given size\n");
+		return true;
+	}
+
+	if (!CelObj::getCache()) {
+		debugPrintf("This SCI version does not have a cel cache\n");
+		return true;
+	}
+
+	if (argc == 2) {
+		int size;
+		if (!scumm_stricmp(argv[1], "reset")) {
+			CelObj::getCache()->resetStats();
+		} else if (parseInteger(argv[1], size) && size > 0) {
+			CelObj::resizeCache(size);
+		} else {
+			debugPrintf("Invalid cache size %s\n", argv[1]);
+			return true;
+		}
+	}
+
+	const CelCache &cache = *CelObj::getCache();
+	const uint lookups = cache.getHits() + cache.getMisses();
+	debugPrintf("Cel cache: %u of %u entries used\n", cache.getUsedCount(), cache.size());
+	debugPrintf("Lookups: %u, hits: %u (%u%%), misses: %u, evictions: %u\n", lookups,
+		cache.getHits(), lookups ? cache.getHits() * 100 / lookups : 0, cache.getMisses(), cache.getEvictions());
+#else
+	debugPrintf("SCI32 isn't included in this compiled executable\n");
+#endif
+	return true;
+}
+
 
 bool Console::cmdParseGrammar(int argc, const char **argv) {
 	debugPrintf("Parse grammar, in strict GNF:\n");
@@ -3440,6 +3483,37 @@ bool Console::cmdScriptSteps(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdVMStats(int argc, const char **argv) {
+	EngineState *s = _engine->_gamestate;
+	VMStats &stats = s->_vmStats;
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		stats.reset(s->scriptStepCounter);
+		debugPrintf("VM statistics reset\n");
+		return true;
+	} else if (argc != 1) {
+		debugPrintf("Shows the VM throughput since the statistics were last reset, along\n");
+		debugPrintf("with how often instructions and selector lookups were cached.\n");
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	const uint32 elapsed = g_system->getMillis() - stats.startTime;
+	const uint32 steps = s->scriptStepCounter - stats.startStep;
+	const uint32 decoded = stats.decodedHits + stats.decodedMisses;
+	const uint32 sends = stats.sendCacheHits + stats.sendCacheMisses;
+
+	debugPrintf("%u SCI operations executed in %u ms", steps, elapsed);
+	if (elapsed)
+		debugPrintf(" (%u operations per second)", (uint32)((uint64)steps * 1000 / elapsed));
+	debugPrintf("\n");
+	debugPrintf("Decoded instructions: %u hits, %u misses (%u%% hits)\n",
+		stats.decodedHits, stats.decodedMisses, decoded ? (uint32)((uint64)stats.decodedHits * 100 / decoded) : 0);
+	debugPrintf("Send caches: %u hits, %u misses (%u%% hits)\n",
+		stats.sendCacheHits, stats.sendCacheMisses, sends ? (uint32)((uint64)stats.sendCacheHits * 100 / sends) : 0);
+	return true;
+}
+
 bool Console::cmdScriptObjects(int argc, const char **argv) {
 	if (argc < 2) {
 		debugPrintf("Shows all objects inside a specified script.\n");
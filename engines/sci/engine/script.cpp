@@ -74,6 +74,27 @@ void Script::freeScript(const bool keepLocalsSegment) {
 	_offsetLookupObjectCount = 0;
 	_offsetLookupStringCount = 0;
 	_offsetLookupSaidCount = 0;
+
+	_decodedIndex.clear();
+	_decoded.clear();
+}
+
+DecodedInstruction *Script::decodeInstruction(uint32 offset) {
+	DecodedInstruction decoded;
+	decoded.size = readPMachineInstruction(getBuf(offset), decoded.extOpcode, decoded.opparams);
+	decoded.sendCache.generation = 0;
+
+	if (_decoded.size() >= 0xFFFF) {
+		// Out of indices, the instruction has to be decoded each time
+		_decodedOverflow = decoded;
+		return &_decodedOverflow;
+	}
+
+	if (_decodedIndex.empty())
+		_decodedIndex.resize(getBufSize(), 0);
+	_decoded.push_back(decoded);
+	_decodedIndex[offset] = _decoded.size();
+	return &_decoded.back();
 }
 
 enum {
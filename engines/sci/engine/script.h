@@ -101,6 +101,14 @@ private:
 	uint16 _offsetLookupStringCount;
 	uint16 _offsetLookupSaidCount;
 
+	/**
+	 * For every byte of the script buffer, 1 + the index in _decoded of the
+	 * instruction starting there, or 0 if it has not been decoded yet
+	 */
+	Common::Array<uint16> _decodedIndex;
+	Common::Array<DecodedInstruction> _decoded; /**< Instructions which have been run */
+	DecodedInstruction _decodedOverflow; /**< Used once _decoded can't be indexed anymore */
+
 public:
 	int getLocalsOffset() const { return _localsOffset; }
 	uint16 getLocalsCount() const { return _localsCount; }
@@ -126,6 +134,23 @@ public:
 	ObjMap &getObjectMap() { return _objects; }
 	const ObjMap &getObjectMap() const { return _objects; }
 
+	/**
+	 * Returns the decoded instruction at the given offset, or NULL if it has
+	 * not been decoded yet.
+	 */
+	DecodedInstruction *getDecodedInstruction(uint32 offset) {
+		if (offset < _decodedIndex.size() && _decodedIndex[offset])
+			return &_decoded[_decodedIndex[offset] - 1];
+		return nullptr;
+	}
+
+	/**
+	 * Decodes the instruction at the given offset, and keeps it for
+	 * getDecodedInstruction(). Script code is not expected to change once
+	 * loaded.
+	 */
+	DecodedInstruction *decodeInstruction(uint32 offset);
+
 	// speed optimization: inline due to frequent calling
 	bool offsetIsObject(uint32 offset) const {
 		return _buf->getUint16SEAt(offset + SCRIPT_OBJECT_MAGIC_OFFSET) == SCRIPT_OBJECT_MAGIC_NUMBER;
@@ -149,6 +149,18 @@ public:
 	 */
 	Script *getScriptIfLoaded(SegmentId seg) const;
 
+	/**
+	 * Returns a counter which changes whenever scripts are loaded or unloaded,
+	 * or segments are freed. Send caches of the VM are only valid for the
+	 * generation they were filled in.
+	 */
+	uint32 getScriptGeneration() const { return _scriptGeneration; }
+
+	/**
+	 * Invalidates all send caches, by moving to a new script generation
+	 */
+	void invalidateSendCaches();
+
 	// 2. Clones
 
 	/**
@@ -474,6 +486,8 @@ private:
 	SegmentId _nodesSegId; ///< ID of the (a) node segment
 	SegmentId _hunksSegId; ///< ID of the (a) hunk segment
 
+	uint32 _scriptGeneration; ///< See getScriptGeneration()
+
 	// Statically allocated memory for system strings
 	reg_t _saveDirPtr;
 	reg_t _parserPtr;
@@ -119,6 +119,7 @@ void EngineState::reset(bool isRestoring) {
 
 	scriptStepCounter = 0;
 	scriptGCInterval = GC_INTERVAL;
+	_vmStats.reset(0);
 }
 
 void EngineState::speedThrottler(uint32 neededSleep) {
@@ -172,6 +172,7 @@ struct EngineState : public Common::Serializable {
 
 	int scriptStepCounter; // Counts the number of steps executed
 	int scriptGCInterval; // Number of steps in between gcs
+	VMStats _vmStats; // Decoding and send cache statistics, see the vm_stats console command
 
 	uint16 currentRoomNumber() const;
 	void setRoomNumber(uint16 roomNumber);
@@ -22,6 +22,7 @@
 #include "common/config-manager.h"
 #include "common/debug.h"
 #include "common/debug-channels.h"
+#include "common/system.h"
 
 #include "sci/sci.h"
 #include "sci/console.h"
@@ -232,7 +233,22 @@ static void _exec_varselectors(EngineState *s) {
 }
 
 
-ExecStack *send_selector(EngineState *s, reg_t send_obj, reg_t work_obj, StackPtr sp, int framesize, StackPtr argp) {
+// Returns the object which determines how selectors sent to the given object
+// are resolved, or NULL_REG if that can't be cached. Instances without methods
+// of their own resolve selectors just like their class. Clones keep the
+// position of the script object they were copied from, and resolve selectors
+// just like it, so they are never keyed on their own address, and freeing and
+// reusing clone slots doesn't affect the caches.
+static reg_t getSendCacheSpecies(SegManager *segMan, reg_t obj) {
+	const Object *object = segMan->getObject(obj);
+	if (!object)
+		return NULL_REG;
+	if (object->isClass() || object->getMethodCount() > 0 || getSciVersion() == SCI_VERSION_3)
+		return object->getPos();
+	return object->getSuperClassSelector();
+}
+
+ExecStack *send_selector(EngineState *s, reg_t send_obj, reg_t work_obj, StackPtr sp, int framesize, StackPtr argp, SendCache *cache) {
 	// send_obj and work_obj are equal for anything but 'super'
 	// Returns a pointer to the TOS exec_stack element
 	assert(s);
@@ -258,7 +274,32 @@ ExecStack *send_selector(EngineState *s, reg_t send_obj, reg_t work_obj, StackPt
 		g_sci->_guestAdditions->sendSelectorHook(send_obj, selector, argp);
 #endif
 
-		SelectorType selectorType = lookupSelector(s->_segMan, send_obj, selector, &varp, &funcp);
+		SelectorType selectorType;
+		reg_t species = cache ? getSendCacheSpecies(s->_segMan, send_obj) : NULL_REG;
+		if (!species.isNull() && cache->generation == s->_segMan->getScriptGeneration()
+				&& cache->species == species && cache->selector == selector) {
+			s->_vmStats.sendCacheHits++;
+			selectorType = cache->type;
+			if (selectorType == kSelectorVariable) {
+				varp.obj = send_obj;
+				varp.varindex = cache->varIndex;
+			} else {
+				funcp = cache->funcp;
+			}
+		} else {
+			selectorType = lookupSelector(s->_segMan, send_obj, selector, &varp, &funcp);
+			if (cache) {
+				s->_vmStats.sendCacheMisses++;
+				if (!species.isNull() && selectorType != kSelectorNone) {
+					cache->generation = s->_segMan->getScriptGeneration();
+					cache->species = species;
+					cache->selector = selector;
+					cache->type = selectorType;
+					cache->varIndex = (selectorType == kSelectorVariable) ? varp.varindex : -1;
+					cache->funcp = (selectorType == kSelectorMethod) ? funcp : NULL_REG;
+				}
+			}
+		}
 		if (selectorType == kSelectorNone)
 			error("Send to invalid selector 0x%x (%s) of object at %04x:%04x", 0xffff & selector, g_sci->getKernel()->getSelectorName(0xffff & selector).c_str(), PRINT_REG(send_obj));
 
@@ -537,6 +578,15 @@ uint32 findOffset(const int16 relOffset, const Script *scr, const uint32 pcOffse
 	return offset;
 }
 
+void VMStats::reset(int step) {
+	startTime = g_system->getMillis();
+	startStep = step;
+	decodedHits = 0;
+	decodedMisses = 0;
+	sendCacheHits = 0;
+	sendCacheMisses = 0;
+}
+
 void run_vm(EngineState *s) {
 	assert(s);
 
@@ -620,9 +670,19 @@ void run_vm(EngineState *s) {
 			error("run_vm(): program counter gone astray, addr: %d, code buffer size: %d",
 			s->xs->addr.pc.getOffset(), scr->getBufSize());
 
-		// Get opcode
-		byte extOpcode;
-		s->xs->addr.pc.incOffset(readPMachineInstruction(scr->getBuf(s->xs->addr.pc.getOffset()), extOpcode, opparams));
+		// Get opcode, decoding it only the first time it is run. The decoded
+		// instruction may move once other instructions of the script are
+		// decoded, so it must not be used after running any other code.
+		DecodedInstruction *decoded = scr->getDecodedInstruction(s->xs->addr.pc.getOffset());
+		if (decoded) {
+			s->_vmStats.decodedHits++;
+		} else {
+			s->_vmStats.decodedMisses++;
+			decoded = scr->decodeInstruction(s->xs->addr.pc.getOffset());
+		}
+		const byte extOpcode = decoded->extOpcode;
+		memcpy(opparams, decoded->opparams, sizeof(opparams));
+		s->xs->addr.pc.incOffset(decoded->size);
 		const byte opcode = extOpcode >> 1;
 		//debug("%s: %d, %d, %d, %d, acc = %04x:%04x, script %d, local script %d", opcodeNames[opcode], opparams[0], opparams[1], opparams[2], opparams[3], PRINT_REG(s->r_acc), scr->getScriptNumber(), local_script->getScriptNumber());
 
@@ -964,7 +1024,8 @@ void run_vm(EngineState *s) {
 
 			s->xs->sp[1].incOffset(s->r_rest);
 			xs_new = send_selector(s, s->r_acc, s->r_acc, s_temp,
-									(int)(opparams[0] >> 1) + (uint16)s->r_rest, s->xs->sp);
+									(int)(opparams[0] >> 1) + (uint16)s->r_rest, s->xs->sp,
+									&decoded->sendCache);
 
 			if (xs_new && xs_new != s->xs)
 				s->_executionStackPosChanged = true;
@@ -1011,7 +1072,7 @@ void run_vm(EngineState *s) {
 			s->xs->sp[1].incOffset(s->r_rest);
 			xs_new = send_selector(s, s->xs->objp, s->xs->objp,
 									s_temp, (int)(opparams[0] >> 1) + (uint16)s->r_rest,
-									s->xs->sp);
+									s->xs->sp, &decoded->sendCache);
 
 			if (xs_new && xs_new != s->xs)
 				s->_executionStackPosChanged = true;
@@ -1040,7 +1101,7 @@ void run_vm(EngineState *s) {
 				s->xs->sp[1].incOffset(s->r_rest);
 				xs_new = send_selector(s, r_temp, s->xs->objp, s_temp,
 										(int)(opparams[1] >> 1) + (uint16)s->r_rest,
-										s->xs->sp);
+										s->xs->sp, &decoded->sendCache);
 
 				if (xs_new && xs_new != s->xs)
 					s->_executionStackPosChanged = true;
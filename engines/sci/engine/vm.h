@@ -70,6 +70,47 @@ struct ObjVarRef {
 	reg_t* getPointer(SegManager *segMan) const;
 };
 
+/**
+ * A monomorphic inline cache for a send instruction. It remembers how the last
+ * selector sent from that instruction was resolved, and is reused as long as
+ * the same selector is sent to an object which resolves selectors the same
+ * way, and no scripts have been loaded or unloaded since.
+ */
+struct SendCache {
+	uint32 generation;   ///< SegManager script generation the entry is valid for, 0 if unused
+	reg_t species;       ///< The object which determines how the receiver resolves selectors
+	Selector selector;
+	SelectorType type;
+	int varIndex;        ///< Variable index, for kSelectorVariable
+	reg_t funcp;         ///< Method address, for kSelectorMethod
+};
+
+/**
+ * A PMachine instruction, as decoded by readPMachineInstruction(). Scripts
+ * keep the instructions which have been run in this form, so that they only
+ * have to be decoded once.
+ */
+struct DecodedInstruction {
+	byte extOpcode;
+	uint16 size;         ///< Length of the instruction in bytes
+	int16 opparams[4];
+	SendCache sendCache; ///< Only used by send, self and super
+};
+
+/**
+ * Execution statistics of the VM, shown by the vm_stats console command
+ */
+struct VMStats {
+	uint32 startTime;      ///< Time when the statistics were last reset
+	int startStep;         ///< Value of scriptStepCounter at that time
+	uint32 decodedHits;    ///< Instructions which had already been decoded
+	uint32 decodedMisses;  ///< Instructions which had to be decoded
+	uint32 sendCacheHits;
+	uint32 sendCacheMisses;
+
+	void reset(int step);
+};
+
 enum ExecStackType {
 	EXEC_STACK_TYPE_CALL = 0,
 	EXEC_STACK_TYPE_KERNEL = 1,
@@ -360,10 +401,11 @@ ExecStack *execute_method(EngineState *s, uint16 script, uint16 pubfunct,
  * 						[selector_number][argument_counter] and then
  * 						"argument_counter" word entries with the
  * 						parameter values.
+ * @param[in] cache		Inline cache of the send instruction, if any
  * @return				A pointer to the new execution stack TOS entry
  */
 ExecStack *send_selector(EngineState *s, reg_t send_obj, reg_t work_obj,
-	StackPtr sp, int framesize, StackPtr argp);
+	StackPtr sp, int framesize, StackPtr argp, SendCache *cache = nullptr);
 
 
 /**
@@ -88,9 +88,8 @@ bool CelObj::_drawBlackLines = false;
 void CelObj::init() {
 	CelObj::deinit();
 	_drawBlackLines = false;
-	_nextCacheId = 1;
 	_scaler = new CelScaler();
-	_cache = new CelCache(100);
+	_cache = new CelCache(ConfMan.hasKey("cel_cache_size") ? MAX(ConfMan.getInt("cel_cache_size"), 1) : 100);
 }
 
 void CelObj::deinit() {
@@ -686,35 +685,94 @@ void CelObj::submitPalette() const {
 #pragma mark -
 #pragma mark CelObj - Caching
 
-int CelObj::_nextCacheId = 1;
 CelCache *CelObj::_cache = nullptr;
 
-int CelObj::searchCache(const CelInfo32 &celInfo, int *const nextInsertIndex) const {
-	*nextInsertIndex = -1;
-	int oldestId = _nextCacheId + 1;
-	int oldestIndex = 0;
+CelCache::CelCache(const uint size) :
+	_entries(size),
+	_used(0),
+	_head(-1),
+	_tail(-1),
+	_hits(0),
+	_misses(0),
+	_evictions(0) {}
 
-	for (int i = 0, len = _cache->size(); i < len; ++i) {
-		CelCacheEntry &entry = (*_cache)[i];
+void CelCache::removeFromList(const int index) {
+	CelCacheEntry &entry = _entries[index];
 
-		if (entry.celObj == nullptr) {
-			if (*nextInsertIndex == -1) {
-				*nextInsertIndex = i;
-			}
-		} else if (entry.celObj->_info == celInfo) {
-			entry.id = ++_nextCacheId;
-			return i;
-		} else if (oldestId > entry.id) {
-			oldestId = entry.id;
-			oldestIndex = i;
-		}
+	if (entry.prev != -1) {
+		_entries[entry.prev].next = entry.next;
+	} else {
+		_head = entry.next;
+	}
+
+	if (entry.next != -1) {
+		_entries[entry.next].prev = entry.prev;
+	} else {
+		_tail = entry.prev;
+	}
+
+	entry.prev = entry.next = -1;
+}
+
+void CelCache::addToFront(const int index) {
+	CelCacheEntry &entry = _entries[index];
+	entry.prev = -1;
+	entry.next = _head;
+
+	if (_head != -1) {
+		_entries[_head].prev = index;
+	} else {
+		_tail = index;
+	}
+
+	_head = index;
+}
+
+int CelCache::find(const CelInfo32 &info) {
+	const IndexMap::const_iterator it = _index.find(info);
+	if (it == _index.end()) {
+		++_misses;
+		return -1;
 	}
 
-	if (*nextInsertIndex == -1) {
-		*nextInsertIndex = oldestIndex;
+	++_hits;
+	if (it->_value != _head) {
+		removeFromList(it->_value);
+		addToFront(it->_value);
 	}
+	return it->_value;
+}
+
+int CelCache::getInsertIndex() const {
+	return _used < _entries.size() ? _used : _tail;
+}
+
+void CelCache::put(const int index, const CelInfo32 &info, CelObj *celObj) {
+	CelCacheEntry &entry = _entries[index];
 
-	return -1;
+	if (entry.celObj) {
+		_index.erase(entry.info);
+		removeFromList(index);
+		++_evictions;
+	} else {
+		++_used;
+	}
+
+	entry.info = info;
+	entry.celObj.reset(celObj);
+	_index.setVal(info, index);
+	addToFront(index);
+}
+
+void CelObj::resizeCache(const uint size) {
+	delete _cache;
+	_cache = new CelCache(size);
+}
+
+int CelObj::searchCache(const CelInfo32 &celInfo, int *const nextInsertIndex) const {
+	const int index = _cache->find(celInfo);
+	*nextInsertIndex = (index == -1) ? _cache->getInsertIndex() : -1;
+	return index;
 }
 
 void CelObj::putCopyInCache(const int cacheIndex) const {
@@ -722,9 +780,7 @@ void CelObj::putCopyInCache(const int cacheIndex) const {
 		error("Invalid cache index");
 	}
 
-	CelCacheEntry &entry = (*_cache)[cacheIndex];
-	entry.celObj.reset(duplicate());
-	entry.id = ++_nextCacheId;
+	_cache->put(cacheIndex, _info, duplicate());
 }
 
 #pragma mark -
@@ -980,7 +1036,6 @@ CelObjView::CelObjView(const GuiResourceId viewId, const int16 loopNo, const int
 			error("Expected a CelObjView in cache slot %d", cacheIndex);
 		}
 		*this = *cachedCelObj;
-		entry.id = ++_nextCacheId;
 		return;
 	}
 
@@ -1188,7 +1243,6 @@ CelObjPic::CelObjPic(const GuiResourceId picId, const int16 celNo) {
 			error("Expected a CelObjPic in cache slot %d", cacheIndex);
 		}
 		*this = *cachedCelObj;
-		entry.id = ++_nextCacheId;
 		return;
 	}
 
@@ -22,6 +22,7 @@
 #ifndef SCI_GRAPHICS_CELOBJ32_H
 #define SCI_GRAPHICS_CELOBJ32_H
 
+#include "common/hashmap.h"
 #include "common/rational.h"
 #include "common/rect.h"
 #include "sci/resource/resource.h"
@@ -105,7 +106,7 @@ struct CelInfo32 {
 
 	// This is the equivalence criteria used by CelObj::searchCache in at least
 	// SSCI SQ6. Notably, it does not check the color field.
-	inline bool operator==(const CelInfo32 &other) {
+	inline bool operator==(const CelInfo32 &other) const {
 		return (
 			type == other.type &&
 			resourceId == other.resourceId &&
@@ -115,7 +116,7 @@ struct CelInfo32 {
 		);
 	}
 
-	inline bool operator!=(const CelInfo32 &other) {
+	inline bool operator!=(const CelInfo32 &other) const {
 		return !(*this == other);
 	}
 
@@ -135,18 +136,95 @@ struct CelInfo32 {
 	}
 };
 
+struct CelInfo32_Hash {
+	uint operator()(const CelInfo32 &info) const {
+		// Uses the same fields as CelInfo32::operator==
+		return ((uint)info.type << 30) ^ ((uint)info.resourceId << 14) ^ ((uint)info.loopNo << 7) ^ (uint)info.celNo ^
+			((uint)info.bitmap.getSegment() << 16) ^ info.bitmap.getOffset();
+	}
+};
+
+struct CelInfo32_EqualTo {
+	bool operator()(const CelInfo32 &x, const CelInfo32 &y) const {
+		return x == y;
+	}
+};
+
 class CelObj;
 struct CelCacheEntry {
+	CelInfo32 info;
+	Common::ScopedPtr<CelObj> celObj;
+
 	/**
-	 * A monotonically increasing cache ID used to identify the least recently
-	 * used item in the cache for replacement.
+	 * The neighbours of this entry in the cache's recently used list, or -1.
 	 */
-	int id;
-	Common::ScopedPtr<CelObj> celObj;
-	CelCacheEntry() : id(0) {}
+	int prev;
+	int next;
+
+	CelCacheEntry() : prev(-1), next(-1) {}
 };
 
-typedef Common::Array<CelCacheEntry> CelCache;
+/**
+ * A fixed size cache of cel objects, indexed by their CelInfo32. Once the
+ * cache is full, the least recently used entry is replaced. In SSCI, this was
+ * a plain array which was searched linearly for every lookup.
+ */
+class CelCache {
+public:
+	CelCache(const uint size);
+
+	/**
+	 * Returns the index of the entry for the given CelInfo32 and marks it as
+	 * the most recently used one, or -1 if there is no such entry.
+	 */
+	int find(const CelInfo32 &info);
+
+	/**
+	 * Returns the index of an unused entry, or of the least recently used
+	 * entry if the cache is full.
+	 */
+	int getInsertIndex() const;
+
+	/**
+	 * Replaces the object in the entry at the given index and marks the entry
+	 * as the most recently used one. Takes ownership of the object.
+	 */
+	void put(const int index, const CelInfo32 &info, CelObj *celObj);
+
+	CelCacheEntry &operator[](const int index) { return _entries[index]; }
+
+	uint size() const { return _entries.size(); }
+	uint getUsedCount() const { return _used; }
+	uint getHits() const { return _hits; }
+	uint getMisses() const { return _misses; }
+	uint getEvictions() const { return _evictions; }
+	void resetStats() { _hits = _misses = _evictions = 0; }
+
+private:
+	typedef Common::HashMap<CelInfo32, int, CelInfo32_Hash, CelInfo32_EqualTo> IndexMap;
+
+	void removeFromList(const int index);
+	void addToFront(const int index);
+
+	Common::Array<CelCacheEntry> _entries;
+	IndexMap _index;
+
+	/**
+	 * The number of entries in use. Entries are used in order, so this is
+	 * also the index of the next unused entry.
+	 */
+	uint _used;
+
+	/**
+	 * The most and least recently used entries.
+	 */
+	int _head;
+	int _tail;
+
+	uint _hits;
+	uint _misses;
+	uint _evictions;
+};
 
 #pragma mark -
 #pragma mark CelScaler
@@ -449,13 +527,18 @@ private:
 
 #pragma mark -
 #pragma mark CelObj - Caching
-protected:
+public:
 	/**
-	 * A monotonically increasing cache ID used to identify the least recently
-	 * used item in the cache for replacement.
+	 * Returns the cel cache, or null if CelObj is not initialised.
 	 */
-	static int _nextCacheId;
+	static CelCache *getCache() { return _cache; }
 
+	/**
+	 * Replaces the cel cache with an empty cache of the given size.
+	 */
+	static void resizeCache(const uint size);
+
+protected:
 	/**
 	 * A cache of cel objects used to avoid reinitialisation overhead for cels
 	 * with the same CelInfo32.
@@ -464,9 +547,9 @@ protected:
 
 	/**
 	 * Searches the cel cache for a CelObj matching the provided CelInfo32. If
-	 * not found, -1 is returned. `nextInsertIndex` will receive the index of
-	 * the oldest item in the cache, which can be used to replace the oldest
-	 * item with a newer item.
+	 * not found, -1 is returned and `nextInsertIndex` will receive the index of
+	 * an unused or the least recently used item in the cache, which can be
+	 * replaced with a newer item.
 	 */
 	int searchCache(const CelInfo32 &celInfo, int *nextInsertIndex) const;
 
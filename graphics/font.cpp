@@ -469,17 +469,23 @@ void Font::drawChar(ManagedSurface *dst, uint32 chr, int x, int y, uint32 color)
 
 void Font::drawString(Surface *dst, const Common::String &str, int x, int y, int w, uint32 color, TextAlign align, int deltax, bool useEllipsis) const {
 	Common::String renderStr = useEllipsis ? handleEllipsis(*this, str, w) : str;
-	drawStringImpl(*this, dst, renderStr, x, y, w, color, align, deltax);
+	if (!drawRun(dst, renderStr, x, y, w, color, align, deltax, nullptr))
+		drawStringImpl(*this, dst, renderStr, x, y, w, color, align, deltax);
 }
 
 void Font::drawString(Surface *dst, const Common::U32String &str, int x, int y, int w, uint32 color, TextAlign align, int deltax, bool useEllipsis) const {
 	Common::U32String renderStr = useEllipsis ? handleEllipsis(*this, str, w) : str;
-	drawStringImpl(*this, dst, renderStr, x, y, w, color, align, deltax);
+	if (!drawRun(dst, renderStr, x, y, w, color, align, deltax, nullptr))
+		drawStringImpl(*this, dst, renderStr, x, y, w, color, align, deltax);
 }
 
 void Font::drawString(ManagedSurface *dst, const Common::String &str, int x, int y, int w, uint32 color, TextAlign align, int deltax, bool useEllipsis) const {
 	Common::String renderStr = useEllipsis ? handleEllipsis(*this, str, w) : str;
-	drawStringImpl(*this, dst, renderStr, x, y, w, color, align, deltax);
+
+	// Without a width, the dirty area is only added by drawChar
+	const uint32 transColor = dst->hasTransparentColor() ? dst->getTransparentColor() : 0;
+	if (w == 0 || !drawRun(dst->surfacePtr(), renderStr, x, y, w, color, align, deltax, dst->hasTransparentColor() ? &transColor : nullptr))
+		drawStringImpl(*this, dst, renderStr, x, y, w, color, align, deltax);
 
 	if (w != 0) {
 		dst->addDirtyRect(getBoundingBox(str, x, y, w, align, deltax, useEllipsis));
@@ -488,7 +494,11 @@ void Font::drawString(ManagedSurface *dst, const Common::String &str, int x, int
 
 void Font::drawString(ManagedSurface *dst, const Common::U32String &str, int x, int y, int w, uint32 color, TextAlign align, int deltax, bool useEllipsis) const {
 	Common::U32String renderStr = useEllipsis ? handleEllipsis(*this, str, w) : str;
-	drawStringImpl(*this, dst, renderStr, x, y, w, color, align, deltax);
+
+	// Without a width, the dirty area is only added by drawChar
+	const uint32 transColor = dst->hasTransparentColor() ? dst->getTransparentColor() : 0;
+	if (w == 0 || !drawRun(dst->surfacePtr(), renderStr, x, y, w, color, align, deltax, dst->hasTransparentColor() ? &transColor : nullptr))
+		drawStringImpl(*this, dst, renderStr, x, y, w, color, align, deltax);
 
 	if (w != 0) {
 		dst->addDirtyRect(getBoundingBox(str, x, y, w, align, useEllipsis));
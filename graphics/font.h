@@ -299,6 +299,21 @@ public:
 	 */
 	void scaleSingleGlyph(Surface *scaleSurface, int *grayScaleMap, int grayScaleMapSize, int width, int height, int xOffset, int yOffset, int grayLevel, int chr, int srcheight, int srcwidth, float scale) const;
 
+protected:
+	/**
+	 * Draw the given @p str string, laid out and clipped exactly like drawString does it.
+	 *
+	 * Fonts which can draw a whole string faster than character by character can
+	 * implement this. The default implementation does nothing and returns false,
+	 * in which case drawString falls back to drawing each character with drawChar.
+	 *
+	 * @param transparentColor  The transparent color of the destination surface, if any.
+	 *
+	 * @return True if the string has been drawn.
+	 */
+	virtual bool drawRun(Surface *dst, const Common::String &str, int x, int y, int w, uint32 color, TextAlign align, int deltax, const uint32 *transparentColor) const { return false; }
+	/** @overload */
+	virtual bool drawRun(Surface *dst, const Common::U32String &str, int x, int y, int w, uint32 color, TextAlign align, int deltax, const uint32 *transparentColor) const { return false; }
 };
 /** @} */
 } // End of namespace Graphics
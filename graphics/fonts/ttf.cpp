@@ -177,6 +177,10 @@ public:
 	void drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) const override;
 	void drawChar(ManagedSurface *dst, uint32 chr, int x, int y, uint32 color) const override;
 
+protected:
+	bool drawRun(Surface *dst, const Common::String &str, int x, int y, int w, uint32 color, TextAlign align, int deltax, const uint32 *transparentColor) const override;
+	bool drawRun(Surface *dst, const Common::U32String &str, int x, int y, int w, uint32 color, TextAlign align, int deltax, const uint32 *transparentColor) const override;
+
 private:
 	bool _initialized;
 	FT_StreamRec_ _stream;
@@ -189,10 +193,12 @@ private:
 	int _ascent, _descent;
 
 	struct Glyph {
-		Surface image;
 		int xOffset, yOffset;
 		int advance;
 		FT_UInt slot;
+		// The image of the glyph is stored in an atlas page, unless it is empty
+		int page;
+		int16 x, y, w, h;
 	};
 
 	bool cacheGlyph(Glyph &glyph, uint32 chr) const;
@@ -200,6 +206,40 @@ private:
 	mutable GlyphCache _glyphs;
 	bool _allowLateCaching;
 	void assureCached(uint32 chr) const;
+	const Glyph *findGlyph(uint32 chr) const;
+
+	/**
+	 * The glyph images are packed in rows into a few large surfaces,
+	 * instead of being allocated one by one. When fonts are allowed to cache
+	 * any character, the number of pages is bounded, and the least
+	 * recently drawn page is reused when all are full.
+	 */
+	struct AtlasPage {
+		Surface image;
+		int shelfX, shelfY, shelfHeight;
+		uint32 lastUse;
+	};
+
+	enum {
+		kAtlasPageSize = 256,
+		kMaxAtlasPages = 16
+	};
+
+	mutable Common::Array<AtlasPage *> _atlas;
+	mutable uint32 _atlasClock;
+	Surface allocateGlyphImage(Glyph &glyph, int w, int h) const;
+	void evictAtlasPage(int page) const;
+
+	// A glyph of a string being drawn, and its position in the string
+	struct RunGlyph {
+		const Glyph *glyph;
+		int x;
+	};
+
+	mutable Common::Array<RunGlyph> _run;
+	template<class StringType>
+	bool drawRunImpl(Surface *dst, const StringType &str, int x, int y, int w, uint32 color, TextAlign align, int deltax, const uint32 *transparentColor) const;
+	void drawGlyph(Surface *dst, const Glyph &glyph, int x, int y, uint32 color, const uint32 *transparentColor) const;
 
 	Common::SeekableReadStream *readTTFTable(FT_ULong tag) const;
 
@@ -221,7 +261,7 @@ TTFFont::TTFFont()
 	: _initialized(false), _stream(), _face(), _ttfFile(0), _width(0), _height(0), _ascent(0),
 	  _descent(0), _glyphs(), _loadFlags(FT_LOAD_TARGET_NORMAL), _renderMode(FT_RENDER_MODE_NORMAL),
 	  _hasKerning(false), _allowLateCaching(false), _fakeBold(false), _fakeItalic(false),
-	  _disposeAfterUse(DisposeAfterUse::NO) {
+	  _disposeAfterUse(DisposeAfterUse::NO), _atlasClock(0) {
 }
 
 TTFFont::~TTFFont() {
@@ -232,11 +272,13 @@ TTFFont::~TTFFont() {
 			delete _ttfFile;
 		_ttfFile = 0;
 
-		for (GlyphCache::iterator i = _glyphs.begin(), end = _glyphs.end(); i != end; ++i)
-			i->_value.image.free();
-
 		_initialized = false;
 	}
+
+	for (uint i = 0; i < _atlas.size(); ++i) {
+		_atlas[i]->image.free();
+		delete _atlas[i];
+	}
 }
 
 
@@ -589,10 +631,8 @@ Common::Rect TTFFont::getBoundingBox(uint32 chr) const {
 	if (glyphEntry == _glyphs.end()) {
 		return Common::Rect();
 	} else {
-		const int xOffset = glyphEntry->_value.xOffset;
-		const int yOffset = glyphEntry->_value.yOffset;
-		const Graphics::Surface &image = glyphEntry->_value.image;
-		return Common::Rect(xOffset, yOffset, xOffset + image.w, yOffset + image.h);
+		const Glyph &glyph = glyphEntry->_value;
+		return Common::Rect(glyph.xOffset, glyph.yOffset, glyph.xOffset + glyph.w, glyph.yOffset + glyph.h);
 	}
 }
 
@@ -664,12 +704,72 @@ void TTFFont::drawChar(ManagedSurface *dst, uint32 chr, int x, int y, uint32 col
 
 void TTFFont::drawChar(Surface * dst, uint32 chr, int x, int y, uint32 color,
 		const uint32 *transparentColor) const {
-	assureCached(chr);
-	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
-	if (glyphEntry == _glyphs.end())
+	++_atlasClock;
+	const Glyph *glyph = findGlyph(chr);
+	if (glyph)
+		drawGlyph(dst, *glyph, x, y, color, transparentColor);
+}
+
+bool TTFFont::drawRun(Surface *dst, const Common::String &str, int x, int y, int w, uint32 color, TextAlign align, int deltax, const uint32 *transparentColor) const {
+	return drawRunImpl(dst, str, x, y, w, color, align, deltax, transparentColor);
+}
+
+bool TTFFont::drawRun(Surface *dst, const Common::U32String &str, int x, int y, int w, uint32 color, TextAlign align, int deltax, const uint32 *transparentColor) const {
+	return drawRunImpl(dst, str, x, y, w, color, align, deltax, transparentColor);
+}
+
+template<class StringType>
+bool TTFFont::drawRunImpl(Surface *dst, const StringType &str, int x, int y, int w, uint32 color, TextAlign align, int deltax, const uint32 *transparentColor) const {
+	// This follows the layout of drawStringImpl, but looks up every glyph,
+	// and the kerning of every pair of glyphs, only once. The pages used by
+	// the string are marked as used first, so no glyph of the string gets
+	// evicted while the following ones are cached.
+	++_atlasClock;
+	_run.resize(str.size());
+
+	const Glyph *last = findGlyph(0);
+	int width = 0;
+	for (uint i = 0; i < str.size(); ++i) {
+		const Glyph *glyph = findGlyph((typename StringType::unsigned_type)str[i]);
+		if (_hasKerning && last && glyph && last->slot && glyph->slot) {
+			FT_Vector kerningVector;
+			FT_Get_Kerning(_face, last->slot, glyph->slot, FT_KERNING_DEFAULT, &kerningVector);
+			width += kerningVector.x / 64;
+		}
+		last = glyph;
+
+		_run[i].glyph = glyph;
+		_run[i].x = width;
+		if (glyph)
+			width += glyph->advance;
+	}
+
+	const int leftX = x, rightX = x + w + 1;
+	if (align == kTextAlignCenter)
+		x = x + (w - width)/2;
+	else if (align == kTextAlignRight)
+		x = x + w - width;
+	x += deltax;
+
+	for (uint i = 0; i < _run.size(); ++i) {
+		const Glyph *glyph = _run[i].glyph;
+		const int glyphX = x + _run[i].x;
+		const int right = glyph ? glyph->xOffset + glyph->w : 0;
+		if (glyphX + right > rightX)
+			break;
+		if (glyph && glyphX + right >= leftX)
+			drawGlyph(dst, *glyph, glyphX, y, color, transparentColor);
+	}
+
+	return true;
+}
+
+void TTFFont::drawGlyph(Surface *dst, const Glyph &glyph, int x, int y, uint32 color,
+		const uint32 *transparentColor) const {
+	if (glyph.page < 0)
 		return;
 
-	const Glyph &glyph = glyphEntry->_value;
+	const Surface &image = _atlas[glyph.page]->image;
 
 	x += glyph.xOffset;
 	y += glyph.yOffset;
@@ -679,10 +779,10 @@ void TTFFont::drawChar(Surface * dst, uint32 chr, int x, int y, uint32 color,
 	if (y > dst->h)
 		return;
 
-	int w = glyph.image.w;
-	int h = glyph.image.h;
+	int w = glyph.w;
+	int h = glyph.h;
 
-	const uint8 *srcPos = (const uint8 *)glyph.image.getPixels();
+	const uint8 *srcPos = (const uint8 *)image.getBasePtr(glyph.x, glyph.y);
 
 	// Make sure we are not drawing outside the screen bounds
 	if (x < 0) {
@@ -698,7 +798,7 @@ void TTFFont::drawChar(Surface * dst, uint32 chr, int x, int y, uint32 color,
 		return;
 
 	if (y < 0) {
-		srcPos -= y * glyph.image.pitch;
+		srcPos -= y * image.pitch;
 		h += y;
 		y = 0;
 	}
@@ -727,14 +827,14 @@ void TTFFont::drawChar(Surface * dst, uint32 chr, int x, int y, uint32 color,
 			}
 
 			dstPos += dst->pitch;
-			srcPos += glyph.image.pitch;
+			srcPos += image.pitch;
 		}
 	} else if (dst->format.bytesPerPixel == 1) {
-		renderGlyph<uint8>(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format, transparentColor);
+		renderGlyph<uint8>(dstPos, dst->pitch, srcPos, image.pitch, w, h, color, dst->format, transparentColor);
 	} else if (dst->format.bytesPerPixel == 2) {
-		renderGlyph<uint16>(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format, transparentColor);
+		renderGlyph<uint16>(dstPos, dst->pitch, srcPos, image.pitch, w, h, color, dst->format, transparentColor);
 	} else if (dst->format.bytesPerPixel == 4) {
-		renderGlyph<uint32>(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format, transparentColor);
+		renderGlyph<uint32>(dstPos, dst->pitch, srcPos, image.pitch, w, h, color, dst->format, transparentColor);
 	}
 }
 
@@ -803,7 +903,17 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	}
 
 
-	glyph.image.create(bitmap->width, bitmap->rows, PixelFormat::createFormatCLUT8());
+	if (bitmap->pixel_mode != FT_PIXEL_MODE_MONO && bitmap->pixel_mode != FT_PIXEL_MODE_GRAY) {
+		warning("TTFFont::cacheGlyph: Unsupported pixel mode %d", bitmap->pixel_mode);
+#if FAKE_BOLD == 1
+		if (_fakeBold) {
+			FT_Bitmap_Done(_face->glyph->library, &ownBitmap);
+		}
+#endif
+		return false;
+	}
+
+	Surface image = allocateGlyphImage(glyph, bitmap->width, bitmap->rows);
 
 	const uint8 *src = bitmap->buffer;
 	int srcPitch = bitmap->pitch;
@@ -812,7 +922,7 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 		srcPitch = -srcPitch;
 	}
 
-	uint8 *dst = (uint8 *)glyph.image.getPixels();
+	uint8 *dst = (uint8 *)image.getPixels();
 
 	switch (bitmap->pixel_mode) {
 	case FT_PIXEL_MODE_MONO:
@@ -824,13 +934,11 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 				if ((x % 8) == 0)
 					mask = *curSrc++;
 
-				if (mask & 0x80)
-					*dst = 255;
-
+				dst[x] = (mask & 0x80) ? 255 : 0;
 				mask <<= 1;
-				++dst;
 			}
 
+			dst += image.pitch;
 			src += srcPitch;
 		}
 		break;
@@ -838,15 +946,13 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	case FT_PIXEL_MODE_GRAY:
 		for (int y = 0; y < (int)bitmap->rows; ++y) {
 			memcpy(dst, src, bitmap->width);
-			dst += glyph.image.pitch;
+			dst += image.pitch;
 			src += srcPitch;
 		}
 		break;
 
 	default:
-		warning("TTFFont::cacheGlyph: Unsupported pixel mode %d", bitmap->pixel_mode);
-		glyph.image.free();
-		return false;
+		break;
 	}
 
 #if FAKE_BOLD == 1
@@ -869,6 +975,99 @@ void TTFFont::assureCached(uint32 chr) const {
 	}
 }
 
+const TTFFont::Glyph *TTFFont::findGlyph(uint32 chr) const {
+	assureCached(chr);
+	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
+	if (glyphEntry == _glyphs.end())
+		return nullptr;
+
+	const Glyph &glyph = glyphEntry->_value;
+	if (glyph.page >= 0)
+		_atlas[glyph.page]->lastUse = _atlasClock;
+	return &glyph;
+}
+
+Surface TTFFont::allocateGlyphImage(Glyph &glyph, int w, int h) const {
+	glyph.page = -1;
+	glyph.x = glyph.y = 0;
+	glyph.w = w;
+	glyph.h = h;
+
+	Surface image;
+	if (w <= 0 || h <= 0)
+		return image;
+
+	// Look for room in the current row of a page, or start a new row
+	int page = -1;
+	for (uint i = 0; i < _atlas.size() && page < 0; ++i) {
+		AtlasPage &atlasPage = *_atlas[i];
+		if (atlasPage.shelfX + w > atlasPage.image.w) {
+			if (atlasPage.shelfY + atlasPage.shelfHeight + h > atlasPage.image.h || w > atlasPage.image.w)
+				continue;
+
+			atlasPage.shelfX = 0;
+			atlasPage.shelfY += atlasPage.shelfHeight;
+			atlasPage.shelfHeight = 0;
+		}
+
+		if (atlasPage.shelfY + h <= atlasPage.image.h)
+			page = i;
+	}
+
+	if (page < 0) {
+		// Reuse the least recently drawn page, unless it is in use by the string being drawn
+		if (_allowLateCaching && _atlas.size() >= kMaxAtlasPages) {
+			for (uint i = 0; i < _atlas.size(); ++i) {
+				if (_atlas[i]->lastUse != _atlasClock && _atlas[i]->image.w >= w && _atlas[i]->image.h >= h &&
+					(page < 0 || _atlas[i]->lastUse < _atlas[page]->lastUse))
+					page = i;
+			}
+
+			if (page >= 0)
+				evictAtlasPage(page);
+		}
+
+		if (page < 0) {
+			// Pages are large enough for several rows of the largest glyphs
+			const int size = MAX<int>(kAtlasPageSize, MAX(_width, _height) * 4);
+
+			AtlasPage *atlasPage = new AtlasPage();
+			atlasPage->image.create(MAX(size, w), MAX(size, h), PixelFormat::createFormatCLUT8());
+			atlasPage->shelfX = atlasPage->shelfY = atlasPage->shelfHeight = 0;
+			page = _atlas.size();
+			_atlas.push_back(atlasPage);
+		}
+	}
+
+	AtlasPage &atlasPage = *_atlas[page];
+	atlasPage.lastUse = _atlasClock;
+
+	glyph.page = page;
+	glyph.x = atlasPage.shelfX;
+	glyph.y = atlasPage.shelfY;
+
+	atlasPage.shelfX += w;
+	atlasPage.shelfHeight = MAX(atlasPage.shelfHeight, h);
+
+	return atlasPage.image.getSubArea(Common::Rect(glyph.x, glyph.y, glyph.x + w, glyph.y + h));
+}
+
+void TTFFont::evictAtlasPage(int page) const {
+	GlyphCache::iterator i = _glyphs.begin();
+	while (i != _glyphs.end()) {
+		if (i->_value.page == page) {
+			uint32 chr = i->_key;
+			++i;
+			_glyphs.erase(chr);
+		} else {
+			++i;
+		}
+	}
+
+	AtlasPage &atlasPage = *_atlas[page];
+	atlasPage.shelfX = atlasPage.shelfY = atlasPage.shelfHeight = 0;
+}
+
 Font *loadTTFFont(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, int size, TTFSizeMode sizeMode, uint xdpi, uint ydpi, TTFRenderMode renderMode, const uint32 *mapping, bool stemDarkening) {
 	TTFFont *font = new TTFFont();
 
@@ -932,7 +1131,9 @@ Font *loadTTFFontFromArchive(const Common::String &filename, int size, TTFSizeMo
 		return nullptr;
 	}
 
-	// HACK: We currently assume that ZipArchive always loads the whole file into memory, so we can delete the archive here.
+	// The font stream doesn't depend on the archive: ZipArchive either loads
+	// the whole member into memory, or streams it while keeping the zipfile
+	// stream alive on its own.
 	delete archive;
 	return font;
 }
@@ -73,6 +73,7 @@ void Context::reset() {
 	packedPixelsSupported = false;
 	packedDepthStencilSupported = false;
 	unpackSubImageSupported = false;
+	pixelBufferObjectSupported = false;
 	OESDepth24 = false;
 	textureEdgeClampSupported = false;
 	textureBorderClampSupported = false;
@@ -262,6 +263,11 @@ void Context::initialize(ContextType contextType) {
 		// Desktop GL always has unpack sub-image support
 		unpackSubImageSupported = true;
 
+#ifdef USE_GLAD
+		// OpenGL 3.0 adds mapping ranges of pixel buffer objects
+		pixelBufferObjectSupported = isGLVersionOrHigher(3, 0);
+#endif
+
 		framebufferObjectMultisampleSupported = EXTFramebufferMultisample && EXTFramebufferBlit;
 
 		if (framebufferObjectMultisampleSupported) {
@@ -307,6 +313,7 @@ void Context::initialize(ContextType contextType) {
 	debug(5, "OpenGL: Packed pixels support: %d", packedPixelsSupported);
 	debug(5, "OpenGL: Packed depth stencil support: %d", packedDepthStencilSupported);
 	debug(5, "OpenGL: Unpack subimage support: %d", unpackSubImageSupported);
+	debug(5, "OpenGL: Pixel buffer object support: %d", pixelBufferObjectSupported);
 	debug(5, "OpenGL: OpenGL ES depth 24 support: %d", OESDepth24);
 	debug(5, "OpenGL: Texture edge clamping support: %d", textureEdgeClampSupported);
 	debug(5, "OpenGL: Texture border clamping support: %d", textureBorderClampSupported);
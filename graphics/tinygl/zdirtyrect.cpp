@@ -192,6 +192,10 @@ void GLContext::presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas)
 		}
 
 		// Execute draw calls.
+		// TODO: The merged rectangles don't overlap, so they could be split
+		// into tiles and rasterized on a worker pool. This needs per-worker
+		// GLContext and FrameBuffer raster state first, since execute() goes
+		// through gl_get_context() and the blitting scissor is global.
 		for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
 			Common::Rect drawCallRegion = (*it)->getDirtyRegion();
 			for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
@@ -84,6 +84,7 @@
 
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_kernels.h"
 
 namespace Common {
 DECLARE_SINGLETON(Graphics::YUVToRGBManager);
@@ -99,15 +100,18 @@ public:
 	YUVToRGBManager::LuminanceScale getScale() const { return _scale; }
 	const int16 *getColorTable() const { return _colorTab; }
 	const byte *getClipTable() const { return _clipTable; }
+	const YUVToRGBKernels::Params &getKernelParams() const { return _kernelParams; }
 
 private:
 	Graphics::PixelFormat _format;
 	YUVToRGBManager::LuminanceScale _scale;
+	YUVToRGBKernels::Params _kernelParams;
 	int16 _colorTab[4 * 256]; // 2048 bytes
 	byte _clipTable[3 * 768];
 };
 
-YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::LuminanceScale scale) {
+YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::LuminanceScale scale)
+	: _kernelParams(format, scale == YUVToRGBManager::kScaleITU) {
 	_format = format;
 	_scale = scale;
 
@@ -217,7 +221,14 @@ void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 	const PixelInt a_mask = (0xFF >> lookup->getFormat().aLoss) << lookup->getFormat().aShift;
 
 	for (int h = 0; h < yHeight; h++) {
-		for (int w = 0; w < yWidth; w++) {
+		// Let the SIMD kernels convert as much of the row as they can
+		int w = YUVToRGBKernels::convertRow444(dstPtr, ySrc, uSrc, vSrc, yWidth, lookup->getKernelParams());
+		ySrc += w;
+		uSrc += w;
+		vSrc += w;
+		dstPtr += w * sizeof(PixelInt);
+
+		for (; w < yWidth; w++) {
 			const byte *L;
 
 			int16 cr_r  = Cr_r_tab[*vSrc];
@@ -270,7 +281,14 @@ void convertYUV422ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 	const PixelInt a_mask = (0xFF >> lookup->getFormat().aLoss) << lookup->getFormat().aShift;
 
 	for (int h = 0; h < yHeight; h++) {
-		for (int w = 0; w < halfWidth; w++) {
+		// Let the SIMD kernels convert as much of the row as they can
+		int w = YUVToRGBKernels::convertRow422(dstPtr, ySrc, uSrc, vSrc, yWidth, lookup->getKernelParams());
+		ySrc += w;
+		uSrc += w >> 1;
+		vSrc += w >> 1;
+		dstPtr += w * sizeof(PixelInt);
+
+		for (w >>= 1; w < halfWidth; w++) {
 			const byte *L;
 
 			int16 cr_r  = Cr_r_tab[*vSrc];
@@ -328,7 +346,16 @@ void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 	const PixelInt a_mask = (0xFF >> lookup->getFormat().aLoss) << lookup->getFormat().aShift;
 
 	for (int h = 0; h < halfHeight; h++) {
-		for (int w = 0; w < halfWidth; w++) {
+		// Let the SIMD kernels convert as much of both rows as they can
+		int w = YUVToRGBKernels::convertRow422(dstPtr, ySrc, uSrc, vSrc, yWidth, lookup->getKernelParams());
+		if (w)
+			YUVToRGBKernels::convertRow422(dstPtr + dstPitch, ySrc + yPitch, uSrc, vSrc, yWidth, lookup->getKernelParams());
+		ySrc += w;
+		uSrc += w >> 1;
+		vSrc += w >> 1;
+		dstPtr += w * sizeof(PixelInt);
+
+		for (w >>= 1; w < halfWidth; w++) {
 			const byte *L;
 
 			int16 cr_r  = Cr_r_tab[*vSrc];
@@ -0,0 +1,163 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/yuv_to_rgb_kernels.h"
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace Graphics {
+
+namespace {
+
+struct AVX2Consts {
+	__m128i rShift, gShift, bShift;
+	__m128i rLoss, gLoss, bLoss;
+	__m256i aMask16, aMask32;
+	bool itu;
+
+	AVX2Consts(const YUVToRGBKernels::Params &params) {
+		rShift = _mm_cvtsi32_si128(params.rShift);
+		gShift = _mm_cvtsi32_si128(params.gShift);
+		bShift = _mm_cvtsi32_si128(params.bShift);
+		rLoss = _mm_cvtsi32_si128(params.rLoss);
+		gLoss = _mm_cvtsi32_si128(params.gLoss);
+		bLoss = _mm_cvtsi32_si128(params.bLoss);
+		aMask16 = _mm256_set1_epi16((int16)params.aMask);
+		aMask32 = _mm256_set1_epi32((int32)params.aMask);
+		itu = params.itu;
+	}
+};
+
+// Compute sign(c) * ((|c| * k) >> 14), for c in [-128, 127]
+static FORCEINLINE __m256i avx2_chroma(__m256i c, int k) {
+	__m256i prod = _mm256_mulhi_epu16(_mm256_slli_epi16(_mm256_abs_epi16(c), 2), _mm256_set1_epi16(k));
+	return _mm256_sign_epi16(prod, c);
+}
+
+// Add the chroma contribution to the luminance and clip it like the lookup tables do
+static FORCEINLINE __m256i avx2_channel(__m256i y, __m256i c, __m128i loss, const AVX2Consts &consts) {
+	__m256i x = _mm256_add_epi16(y, c);
+	if (consts.itu) {
+		x = _mm256_min_epi16(_mm256_max_epi16(x, _mm256_set1_epi16(16)), _mm256_set1_epi16(235));
+		x = _mm256_mullo_epi16(_mm256_sub_epi16(x, _mm256_set1_epi16(16)), _mm256_set1_epi16(255));
+		x = _mm256_srli_epi16(_mm256_mulhi_epu16(x, _mm256_set1_epi16(kYUVITUScale)), 6);
+	} else {
+		x = _mm256_min_epi16(_mm256_max_epi16(x, _mm256_setzero_si256()), _mm256_set1_epi16(255));
+	}
+	return _mm256_srl_epi16(x, loss);
+}
+
+static FORCEINLINE void avx2_store(byte *dst, __m256i r, __m256i g, __m256i b, byte bytesPerPixel, const AVX2Consts &consts) {
+	if (bytesPerPixel == 2) {
+		__m256i pixels = _mm256_or_si256(_mm256_sll_epi16(r, consts.rShift), _mm256_sll_epi16(g, consts.gShift));
+		pixels = _mm256_or_si256(pixels, _mm256_or_si256(_mm256_sll_epi16(b, consts.bShift), consts.aMask16));
+		_mm256_storeu_si256((__m256i *)dst, pixels);
+	} else {
+		__m256i lo = _mm256_or_si256(_mm256_sll_epi32(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(r)), consts.rShift),
+		                             _mm256_sll_epi32(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(g)), consts.gShift));
+		__m256i hi = _mm256_or_si256(_mm256_sll_epi32(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(r, 1)), consts.rShift),
+		                             _mm256_sll_epi32(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(g, 1)), consts.gShift));
+		lo = _mm256_or_si256(lo, _mm256_or_si256(_mm256_sll_epi32(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(b)), consts.bShift), consts.aMask32));
+		hi = _mm256_or_si256(hi, _mm256_or_si256(_mm256_sll_epi32(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(b, 1)), consts.bShift), consts.aMask32));
+		_mm256_storeu_si256((__m256i *)dst, lo);
+		_mm256_storeu_si256((__m256i *)(dst + 32), hi);
+	}
+}
+
+// Convert sixteen pixels, given their luminance and chroma contributions
+static FORCEINLINE void avx2_pixels(byte *dst, __m256i y, __m256i cR, __m256i cG, __m256i cB, byte bytesPerPixel, const AVX2Consts &consts) {
+	__m256i r = avx2_channel(y, cR, consts.rLoss, consts);
+	__m256i g = avx2_channel(y, cG, consts.gLoss, consts);
+	__m256i b = avx2_channel(y, cB, consts.bLoss, consts);
+	avx2_store(dst, r, g, b, bytesPerPixel, consts);
+}
+
+// Load sixteen chroma samples and compute their contributions to each channel
+static FORCEINLINE void avx2_chromaContributions(const byte *uSrc, const byte *vSrc, __m256i &cR, __m256i &cG, __m256i &cB) {
+	const __m256i bias = _mm256_set1_epi16(128);
+	__m256i cb = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)uSrc)), bias);
+	__m256i cr = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)vSrc)), bias);
+
+	cR = avx2_chroma(cr, kYUVCrToR);
+	cG = _mm256_sub_epi16(_mm256_sub_epi16(_mm256_setzero_si256(), avx2_chroma(cr, kYUVCrToG)), avx2_chroma(cb, kYUVCbToG));
+	cB = avx2_chroma(cb, kYUVCbToB);
+}
+
+} // End of anonymous namespace
+
+int YUVToRGBKernels::convertRow444AVX2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const Params &params) {
+	const AVX2Consts consts(params);
+	const byte bytesPerPixel = params.bytesPerPixel;
+
+	int x = 0;
+	for (; x + 16 <= width; x += 16) {
+		__m256i cR, cG, cB;
+		avx2_chromaContributions(uSrc + x, vSrc + x, cR, cG, cB);
+
+		__m256i y = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(ySrc + x)));
+		avx2_pixels(dst + x * bytesPerPixel, y, cR, cG, cB, bytesPerPixel, consts);
+	}
+
+	return x;
+}
+
+int YUVToRGBKernels::convertRow422AVX2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const Params &params) {
+	const AVX2Consts consts(params);
+	const byte bytesPerPixel = params.bytesPerPixel;
+
+	int x = 0;
+	for (; x + 32 <= width; x += 32) {
+		__m256i cR, cG, cB;
+		avx2_chromaContributions(uSrc + (x >> 1), vSrc + (x >> 1), cR, cG, cB);
+
+		// Unpacking works within 128-bit lanes, so reorder the quarters
+		// first for the duplicated samples to come out in pixel order
+		cR = _mm256_permute4x64_epi64(cR, _MM_SHUFFLE(3, 1, 2, 0));
+		cG = _mm256_permute4x64_epi64(cG, _MM_SHUFFLE(3, 1, 2, 0));
+		cB = _mm256_permute4x64_epi64(cB, _MM_SHUFFLE(3, 1, 2, 0));
+
+		__m256i y0 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(ySrc + x)));
+		__m256i y1 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(ySrc + x + 16)));
+		avx2_pixels(dst + x * bytesPerPixel, y0,
+		            _mm256_unpacklo_epi16(cR, cR), _mm256_unpacklo_epi16(cG, cG), _mm256_unpacklo_epi16(cB, cB), bytesPerPixel, consts);
+		avx2_pixels(dst + (x + 16) * bytesPerPixel, y1,
+		            _mm256_unpackhi_epi16(cR, cR), _mm256_unpackhi_epi16(cG, cG), _mm256_unpackhi_epi16(cB, cB), bytesPerPixel, consts);
+	}
+
+	return x;
+}
+
+} // End of namespace Graphics
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
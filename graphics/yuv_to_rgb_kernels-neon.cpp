@@ -0,0 +1,176 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/yuv_to_rgb_kernels.h"
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("neon"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+
+#endif // !defined(__aarch64__)
+
+namespace Graphics {
+
+namespace {
+
+struct NEONConsts {
+	int16x8_t rShift, gShift, bShift;
+	int32x4_t rShift32, gShift32, bShift32;
+	int16x8_t rLoss, gLoss, bLoss;
+	uint16x8_t aMask16;
+	uint32x4_t aMask32;
+	bool itu;
+
+	NEONConsts(const YUVToRGBKernels::Params &params) {
+		rShift = vdupq_n_s16(params.rShift);
+		gShift = vdupq_n_s16(params.gShift);
+		bShift = vdupq_n_s16(params.bShift);
+		rShift32 = vdupq_n_s32(params.rShift);
+		gShift32 = vdupq_n_s32(params.gShift);
+		bShift32 = vdupq_n_s32(params.bShift);
+		// Shifting by a negative amount shifts to the right
+		rLoss = vdupq_n_s16(-params.rLoss);
+		gLoss = vdupq_n_s16(-params.gLoss);
+		bLoss = vdupq_n_s16(-params.bLoss);
+		aMask16 = vdupq_n_u16((uint16)params.aMask);
+		aMask32 = vdupq_n_u32(params.aMask);
+		itu = params.itu;
+	}
+};
+
+// Compute sign(c) * ((|c| * k) >> 14), for c in [-128, 127]
+static FORCEINLINE int16x8_t neon_chroma(int16x8_t c, int16 k) {
+	// vqdmulhq computes (2 * a * b) >> 16, which cannot saturate here
+	int16x8_t prod = vqdmulhq_s16(vshlq_n_s16(vabsq_s16(c), 1), vdupq_n_s16(k));
+	return vbslq_s16(vcltq_s16(c, vdupq_n_s16(0)), vnegq_s16(prod), prod);
+}
+
+// Add the chroma contribution to the luminance and clip it like the lookup tables do
+static FORCEINLINE uint16x8_t neon_channel(int16x8_t y, int16x8_t c, int16x8_t loss, const NEONConsts &consts) {
+	int16x8_t x = vaddq_s16(y, c);
+	uint16x8_t result;
+	if (consts.itu) {
+		x = vminq_s16(vmaxq_s16(x, vdupq_n_s16(16)), vdupq_n_s16(235));
+		uint16x8_t scaled = vmulq_n_u16(vreinterpretq_u16_s16(vsubq_s16(x, vdupq_n_s16(16))), 255);
+		uint16x4_t lo = vshrn_n_u32(vmull_n_u16(vget_low_u16(scaled), kYUVITUScale), 16);
+		uint16x4_t hi = vshrn_n_u32(vmull_n_u16(vget_high_u16(scaled), kYUVITUScale), 16);
+		result = vshrq_n_u16(vcombine_u16(lo, hi), 6);
+	} else {
+		result = vreinterpretq_u16_s16(vminq_s16(vmaxq_s16(x, vdupq_n_s16(0)), vdupq_n_s16(255)));
+	}
+	return vshlq_u16(result, loss);
+}
+
+static FORCEINLINE void neon_store(byte *dst, uint16x8_t r, uint16x8_t g, uint16x8_t b, byte bytesPerPixel, const NEONConsts &consts) {
+	if (bytesPerPixel == 2) {
+		uint16x8_t pixels = vorrq_u16(vshlq_u16(r, consts.rShift), vshlq_u16(g, consts.gShift));
+		pixels = vorrq_u16(pixels, vorrq_u16(vshlq_u16(b, consts.bShift), consts.aMask16));
+		vst1q_u16((uint16 *)dst, pixels);
+	} else {
+		uint32x4_t lo = vorrq_u32(vshlq_u32(vmovl_u16(vget_low_u16(r)), consts.rShift32), vshlq_u32(vmovl_u16(vget_low_u16(g)), consts.gShift32));
+		uint32x4_t hi = vorrq_u32(vshlq_u32(vmovl_u16(vget_high_u16(r)), consts.rShift32), vshlq_u32(vmovl_u16(vget_high_u16(g)), consts.gShift32));
+		lo = vorrq_u32(lo, vorrq_u32(vshlq_u32(vmovl_u16(vget_low_u16(b)), consts.bShift32), consts.aMask32));
+		hi = vorrq_u32(hi, vorrq_u32(vshlq_u32(vmovl_u16(vget_high_u16(b)), consts.bShift32), consts.aMask32));
+		vst1q_u32((uint32 *)dst, lo);
+		vst1q_u32((uint32 *)(dst + 16), hi);
+	}
+}
+
+// Convert eight pixels, given their luminance and chroma contributions
+static FORCEINLINE void neon_pixels(byte *dst, int16x8_t y, int16x8_t cR, int16x8_t cG, int16x8_t cB, byte bytesPerPixel, const NEONConsts &consts) {
+	uint16x8_t r = neon_channel(y, cR, consts.rLoss, consts);
+	uint16x8_t g = neon_channel(y, cG, consts.gLoss, consts);
+	uint16x8_t b = neon_channel(y, cB, consts.bLoss, consts);
+	neon_store(dst, r, g, b, bytesPerPixel, consts);
+}
+
+// Load eight chroma samples and compute their contributions to each channel
+static FORCEINLINE void neon_chromaContributions(const byte *uSrc, const byte *vSrc, int16x8_t &cR, int16x8_t &cG, int16x8_t &cB) {
+	const int16x8_t bias = vdupq_n_s16(128);
+	int16x8_t cb = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(uSrc))), bias);
+	int16x8_t cr = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(vSrc))), bias);
+
+	cR = neon_chroma(cr, kYUVCrToR);
+	cG = vsubq_s16(vnegq_s16(neon_chroma(cr, kYUVCrToG)), neon_chroma(cb, kYUVCbToG));
+	cB = neon_chroma(cb, kYUVCbToB);
+}
+
+} // End of anonymous namespace
+
+int YUVToRGBKernels::convertRow444NEON(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const Params &params) {
+	const NEONConsts consts(params);
+	const byte bytesPerPixel = params.bytesPerPixel;
+
+	int x = 0;
+	for (; x + 8 <= width; x += 8) {
+		int16x8_t cR, cG, cB;
+		neon_chromaContributions(uSrc + x, vSrc + x, cR, cG, cB);
+
+		int16x8_t y = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(ySrc + x)));
+		neon_pixels(dst + x * bytesPerPixel, y, cR, cG, cB, bytesPerPixel, consts);
+	}
+
+	return x;
+}
+
+int YUVToRGBKernels::convertRow422NEON(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const Params &params) {
+	const NEONConsts consts(params);
+	const byte bytesPerPixel = params.bytesPerPixel;
+
+	int x = 0;
+	for (; x + 16 <= width; x += 16) {
+		int16x8_t cR, cG, cB;
+		neon_chromaContributions(uSrc + (x >> 1), vSrc + (x >> 1), cR, cG, cB);
+
+		int16x8x2_t r = vzipq_s16(cR, cR);
+		int16x8x2_t g = vzipq_s16(cG, cG);
+		int16x8x2_t b = vzipq_s16(cB, cB);
+
+		uint8x16_t y = vld1q_u8(ySrc + x);
+		neon_pixels(dst + x * bytesPerPixel, vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(y))),
+		            r.val[0], g.val[0], b.val[0], bytesPerPixel, consts);
+		neon_pixels(dst + (x + 8) * bytesPerPixel, vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(y))),
+		            r.val[1], g.val[1], b.val[1], bytesPerPixel, consts);
+	}
+
+	return x;
+}
+
+} // End of namespace Graphics
+
+#if !defined(__aarch64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__aarch64__)
@@ -0,0 +1,168 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/yuv_to_rgb_kernels.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace Graphics {
+
+namespace {
+
+struct SSE2Consts {
+	__m128i rShift, gShift, bShift;
+	__m128i rLoss, gLoss, bLoss;
+	__m128i aMask16, aMask32;
+	bool itu;
+
+	SSE2Consts(const YUVToRGBKernels::Params &params) {
+		rShift = _mm_cvtsi32_si128(params.rShift);
+		gShift = _mm_cvtsi32_si128(params.gShift);
+		bShift = _mm_cvtsi32_si128(params.bShift);
+		rLoss = _mm_cvtsi32_si128(params.rLoss);
+		gLoss = _mm_cvtsi32_si128(params.gLoss);
+		bLoss = _mm_cvtsi32_si128(params.bLoss);
+		aMask16 = _mm_set1_epi16((int16)params.aMask);
+		aMask32 = _mm_set1_epi32((int32)params.aMask);
+		itu = params.itu;
+	}
+};
+
+// Compute sign(c) * ((|c| * k) >> 14), for c in [-128, 127]
+static FORCEINLINE __m128i sse2_chroma(__m128i c, int k) {
+	__m128i sign = _mm_srai_epi16(c, 15);
+	__m128i mag = _mm_sub_epi16(_mm_xor_si128(c, sign), sign);
+	__m128i prod = _mm_mulhi_epu16(_mm_slli_epi16(mag, 2), _mm_set1_epi16(k));
+	return _mm_sub_epi16(_mm_xor_si128(prod, sign), sign);
+}
+
+// Add the chroma contribution to the luminance and clip it like the lookup tables do
+static FORCEINLINE __m128i sse2_channel(__m128i y, __m128i c, __m128i loss, const SSE2Consts &consts) {
+	__m128i x = _mm_add_epi16(y, c);
+	if (consts.itu) {
+		x = _mm_min_epi16(_mm_max_epi16(x, _mm_set1_epi16(16)), _mm_set1_epi16(235));
+		x = _mm_mullo_epi16(_mm_sub_epi16(x, _mm_set1_epi16(16)), _mm_set1_epi16(255));
+		x = _mm_srli_epi16(_mm_mulhi_epu16(x, _mm_set1_epi16(kYUVITUScale)), 6);
+	} else {
+		x = _mm_min_epi16(_mm_max_epi16(x, _mm_setzero_si128()), _mm_set1_epi16(255));
+	}
+	return _mm_srl_epi16(x, loss);
+}
+
+static FORCEINLINE void sse2_store(byte *dst, __m128i r, __m128i g, __m128i b, byte bytesPerPixel, const SSE2Consts &consts) {
+	if (bytesPerPixel == 2) {
+		__m128i pixels = _mm_or_si128(_mm_sll_epi16(r, consts.rShift), _mm_sll_epi16(g, consts.gShift));
+		pixels = _mm_or_si128(pixels, _mm_or_si128(_mm_sll_epi16(b, consts.bShift), consts.aMask16));
+		_mm_storeu_si128((__m128i *)dst, pixels);
+	} else {
+		const __m128i zero = _mm_setzero_si128();
+		__m128i lo = _mm_or_si128(_mm_sll_epi32(_mm_unpacklo_epi16(r, zero), consts.rShift), _mm_sll_epi32(_mm_unpacklo_epi16(g, zero), consts.gShift));
+		__m128i hi = _mm_or_si128(_mm_sll_epi32(_mm_unpackhi_epi16(r, zero), consts.rShift), _mm_sll_epi32(_mm_unpackhi_epi16(g, zero), consts.gShift));
+		lo = _mm_or_si128(lo, _mm_or_si128(_mm_sll_epi32(_mm_unpacklo_epi16(b, zero), consts.bShift), consts.aMask32));
+		hi = _mm_or_si128(hi, _mm_or_si128(_mm_sll_epi32(_mm_unpackhi_epi16(b, zero), consts.bShift), consts.aMask32));
+		_mm_storeu_si128((__m128i *)dst, lo);
+		_mm_storeu_si128((__m128i *)(dst + 16), hi);
+	}
+}
+
+// Convert eight pixels, given their luminance and chroma contributions
+static FORCEINLINE void sse2_pixels(byte *dst, __m128i y, __m128i cR, __m128i cG, __m128i cB, byte bytesPerPixel, const SSE2Consts &consts) {
+	__m128i r = sse2_channel(y, cR, consts.rLoss, consts);
+	__m128i g = sse2_channel(y, cG, consts.gLoss, consts);
+	__m128i b = sse2_channel(y, cB, consts.bLoss, consts);
+	sse2_store(dst, r, g, b, bytesPerPixel, consts);
+}
+
+// Load eight chroma samples and compute their contributions to each channel
+static FORCEINLINE void sse2_chromaContributions(const byte *uSrc, const byte *vSrc, __m128i &cR, __m128i &cG, __m128i &cB) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i bias = _mm_set1_epi16(128);
+	__m128i cb = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)uSrc), zero), bias);
+	__m128i cr = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)vSrc), zero), bias);
+
+	cR = sse2_chroma(cr, kYUVCrToR);
+	cG = _mm_sub_epi16(_mm_sub_epi16(zero, sse2_chroma(cr, kYUVCrToG)), sse2_chroma(cb, kYUVCbToG));
+	cB = sse2_chroma(cb, kYUVCbToB);
+}
+
+} // End of anonymous namespace
+
+int YUVToRGBKernels::convertRow444SSE2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const Params &params) {
+	const SSE2Consts consts(params);
+	const byte bytesPerPixel = params.bytesPerPixel;
+	const __m128i zero = _mm_setzero_si128();
+
+	int x = 0;
+	for (; x + 8 <= width; x += 8) {
+		__m128i cR, cG, cB;
+		sse2_chromaContributions(uSrc + x, vSrc + x, cR, cG, cB);
+
+		__m128i y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(ySrc + x)), zero);
+		sse2_pixels(dst + x * bytesPerPixel, y, cR, cG, cB, bytesPerPixel, consts);
+	}
+
+	return x;
+}
+
+int YUVToRGBKernels::convertRow422SSE2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const Params &params) {
+	const SSE2Consts consts(params);
+	const byte bytesPerPixel = params.bytesPerPixel;
+	const __m128i zero = _mm_setzero_si128();
+
+	int x = 0;
+	for (; x + 16 <= width; x += 16) {
+		__m128i cR, cG, cB;
+		sse2_chromaContributions(uSrc + (x >> 1), vSrc + (x >> 1), cR, cG, cB);
+
+		__m128i y = _mm_loadu_si128((const __m128i *)(ySrc + x));
+		sse2_pixels(dst + x * bytesPerPixel, _mm_unpacklo_epi8(y, zero),
+		            _mm_unpacklo_epi16(cR, cR), _mm_unpacklo_epi16(cG, cG), _mm_unpacklo_epi16(cB, cB), bytesPerPixel, consts);
+		sse2_pixels(dst + (x + 8) * bytesPerPixel, _mm_unpackhi_epi8(y, zero),
+		            _mm_unpackhi_epi16(cR, cR), _mm_unpackhi_epi16(cG, cG), _mm_unpackhi_epi16(cB, cB), bytesPerPixel, consts);
+	}
+
+	return x;
+}
+
+} // End of namespace Graphics
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
@@ -0,0 +1,88 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/system.h"
+
+#include "graphics/yuv_to_rgb_kernels.h"
+
+namespace Graphics {
+
+// The actual functions are selected on first use. Without SIMD support,
+// they are left as nullptr and the lookup tables are used for everything.
+bool YUVToRGBKernels::funcsSelected = false;
+YUVToRGBKernels::ConvertRowFunc YUVToRGBKernels::convertRow444Func = nullptr;
+YUVToRGBKernels::ConvertRowFunc YUVToRGBKernels::convertRow422Func = nullptr;
+
+YUVToRGBKernels::Params::Params(const PixelFormat &format, bool itu_) {
+	bytesPerPixel = format.bytesPerPixel;
+	rShift = format.rShift;
+	gShift = format.gShift;
+	bShift = format.bShift;
+	rLoss = format.rLoss;
+	gLoss = format.gLoss;
+	bLoss = format.bLoss;
+	aMask = (0xFF >> format.aLoss) << format.aShift;
+	itu = itu_;
+}
+
+void YUVToRGBKernels::selectFuncs() {
+	funcsSelected = true;
+	convertRow444Func = nullptr;
+	convertRow422Func = nullptr;
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+		convertRow444Func = convertRow444NEON;
+		convertRow422Func = convertRow422NEON;
+	}
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		convertRow444Func = convertRow444SSE2;
+		convertRow422Func = convertRow422SSE2;
+	}
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+		convertRow444Func = convertRow444AVX2;
+		convertRow422Func = convertRow422AVX2;
+	}
+#endif
+}
+
+int YUVToRGBKernels::convertRow444(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const Params &params) {
+	if (!funcsSelected)
+		selectFuncs();
+
+	if (!convertRow444Func)
+		return 0;
+	return convertRow444Func(dst, ySrc, uSrc, vSrc, width, params);
+}
+
+int YUVToRGBKernels::convertRow422(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const Params &params) {
+	if (!funcsSelected)
+		selectFuncs();
+
+	if (!convertRow422Func)
+		return 0;
+	return convertRow422Func(dst, ySrc, uSrc, vSrc, width, params);
+}
+
+} // End of namespace Graphics
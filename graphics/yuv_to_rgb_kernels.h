@@ -0,0 +1,129 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_YUV_TO_RGB_KERNELS_H
+#define GRAPHICS_YUV_TO_RGB_KERNELS_H
+
+#include "common/scummsys.h"
+#include "graphics/pixelformat.h"
+
+class YUVToRGBTestSuite;
+
+namespace Graphics {
+
+/**
+ * @defgroup graphics_yuvtorgb_kernels YUV to RGB kernels
+ * @ingroup graphics_yuvtorgb
+ *
+ * @brief SIMD row kernels used by YUVToRGBManager.
+ * @{
+ */
+
+/**
+ * SIMD row kernels used by YUVToRGBManager.
+ *
+ * The kernels compute the color components instead of reading them from the
+ * lookup tables, using fixed point coefficients chosen so that the results
+ * are identical to the tables for every input. Each kernel only converts
+ * the largest part of the row it can process in whole vectors, and returns
+ * the number of pixels converted, leaving the rest of the row to the table
+ * based code.
+ *
+ * The SIMD variants are selected at runtime, depending on the features
+ * reported by OSystem::hasFeature().
+ */
+class YUVToRGBKernels {
+public:
+	/** Destination format parameters shared by all pixels of a conversion. */
+	struct Params {
+		Params(const PixelFormat &format, bool itu);
+
+		byte bytesPerPixel;
+		byte rShift, gShift, bShift;
+		byte rLoss, gLoss, bLoss;
+		uint32 aMask;
+		bool itu;
+	};
+
+	/**
+	 * Convert a row with one chroma sample per pixel.
+	 *
+	 * @return The number of pixels converted, starting at the beginning of the row.
+	 */
+	static int convertRow444(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const Params &params);
+
+	/**
+	 * Convert a row with one chroma sample per two horizontal pixels.
+	 *
+	 * @return The number of pixels converted, starting at the beginning of the row.
+	 *         This is always an even number.
+	 */
+	static int convertRow422(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const Params &params);
+
+private:
+	typedef int(*ConvertRowFunc)(byte *, const byte *, const byte *, const byte *, int, const Params &);
+
+	static void selectFuncs();
+
+#ifdef SCUMMVM_NEON
+	static int convertRow444NEON(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const Params &params);
+	static int convertRow422NEON(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const Params &params);
+#endif
+#ifdef SCUMMVM_SSE2
+	static int convertRow444SSE2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const Params &params);
+	static int convertRow422SSE2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const Params &params);
+#endif
+#ifdef SCUMMVM_AVX2
+	static int convertRow444AVX2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const Params &params);
+	static int convertRow422AVX2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const Params &params);
+#endif
+
+	static bool funcsSelected;
+	static ConvertRowFunc convertRow444Func;
+	static ConvertRowFunc convertRow422Func;
+
+	friend class ::YUVToRGBTestSuite;
+};
+
+/**
+ * Fixed point coefficients of the chroma contributions, with 14 fractional
+ * bits. With these, (|c| * k) >> 14 equals the magnitude of the truncated
+ * products stored in the lookup tables for every chroma value c.
+ */
+enum {
+	kYUVCrToR = 22959, ///< 0.419 / 0.299
+	kYUVCrToG = 11691, ///< 0.299 / 0.419
+	kYUVCbToG = 5642,  ///< 0.114 / 0.331
+	kYUVCbToB = 29055  ///< 0.587 / 0.331
+};
+
+/**
+ * Scale a luminance in the range [0, 219] to [0, 255] like (x * 255) / 219,
+ * as (x * 255 * kYUVITUScale) >> 22.
+ */
+enum {
+	kYUVITUScale = 19153
+};
+
+/** @} */
+} // End of namespace Graphics
+
+#endif
@@ -26,6 +26,7 @@
 #include "common/debug.h"
 #include "common/debug-channels.h"
 #include "common/system.h"
+#include "common/timer.h"
 
 #ifndef DISABLE_MD5
 #include "common/md5.h"
@@ -36,6 +37,8 @@
 
 #include "engines/engine.h"
 
+#include "audio/mixer.h"
+
 #include "gui/debugger.h"
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
 	#include "gui/console.h"
@@ -81,6 +84,9 @@ Debugger::Debugger() {
 	registerCmd("debugflag_list",		WRAP_METHOD(Debugger, cmdDebugFlagsList));
 	registerCmd("debugflag_enable",	WRAP_METHOD(Debugger, cmdDebugFlagEnable));
 	registerCmd("debugflag_disable",	WRAP_METHOD(Debugger, cmdDebugFlagDisable));
+
+	registerCmd("mixer_stats",		WRAP_METHOD(Debugger, cmdMixerStats));
+	registerCmd("timer_stats",		WRAP_METHOD(Debugger, cmdTimerStats));
 }
 
 Debugger::~Debugger() {
@@ -776,6 +782,87 @@ bool Debugger::cmdDebugLevel(int argc, const char **argv) {
 	return true;
 }
 
+bool Debugger::cmdMixerStats(int argc, const char **argv) {
+	Audio::Mixer *mixer = g_system->getMixer();
+	if (!mixer) {
+		debugPrintf("No mixer available\n");
+		return true;
+	}
+
+	if (argc == 2 && !strcmp(argv[1], "reset")) {
+		mixer->resetStats();
+		debugPrintf("Mixer statistics reset\n");
+		return true;
+	} else if (argc != 1) {
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	static const char *const typeNames[] = { "plain", "music", "sfx", "speech" };
+
+	Audio::Mixer::MixerStats stats;
+	Common::Array<Audio::Mixer::ChannelStats> channels;
+	mixer->getStats(stats, channels);
+
+	debugPrintf("Output: %d Hz, %s, %d frames per buffer\n", mixer->getOutputRate(), mixer->getOutputStereo() ? "stereo" : "mono", mixer->getOutputBufSize());
+	debugPrintf("Callbacks: %u, frames: %llu, overruns: %u\n", stats.callbacks, (unsigned long long)stats.samplesRequested, stats.overrunCallbacks);
+	if (stats.callbacks)
+		debugPrintf("Callback time: avg %llu us, max %u us\n", (unsigned long long)(stats.mixTime / stats.callbacks), stats.maxCallbackTime);
+
+	if (channels.empty()) {
+		debugPrintf("No sounds playing\n");
+		return true;
+	}
+
+	debugPrintf("%-4s %-6s %-6s %-6s %-6s %-8s %-8s %-10s %-10s %s\n", "chan", "id", "type", "state", "rate", "calls", "starved", "frames", "time (us)", "us/call");
+	for (uint i = 0; i < channels.size(); i++) {
+		const Audio::Mixer::ChannelStats &c = channels[i];
+		debugPrintf("%-4d %-6d %-6s %-6s %-6u %-8u %-8u %-10llu %-10llu %llu\n",
+			c.index, c.id, typeNames[c.type], c.paused ? "paused" : "play", c.rate,
+			c.callbacks, c.starvedCallbacks, (unsigned long long)c.samplesProduced, (unsigned long long)c.mixTime,
+			(unsigned long long)(c.callbacks ? c.mixTime / c.callbacks : 0));
+	}
+
+	return true;
+}
+
+bool Debugger::cmdTimerStats(int argc, const char **argv) {
+	Common::TimerManager *timerManager = g_system->getTimerManager();
+	if (!timerManager) {
+		debugPrintf("No timer manager available\n");
+		return true;
+	}
+
+	if (argc == 2 && !strcmp(argv[1], "reset")) {
+		timerManager->resetStats();
+		debugPrintf("Timer statistics reset\n");
+		return true;
+	} else if (argc != 1) {
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	Common::Array<Common::TimerManager::TimerStats> timers;
+	timerManager->getStats(timers);
+
+	if (timers.empty()) {
+		debugPrintf("No timers installed\n");
+		return true;
+	}
+
+	debugPrintf("%-24s %-10s %-8s %-10s %-10s %-10s %-10s %-8s %s\n", "id", "interval", "calls", "avg (us)", "max (us)", "avg jitter", "max jitter", "missed", "overruns");
+	for (uint i = 0; i < timers.size(); i++) {
+		const Common::TimerManager::TimerStats &t = timers[i];
+		debugPrintf("%-24s %-10d %-8u %-10llu %-10u %-10llu %-10u %-8u %u\n",
+			t.id.c_str(), t.interval, t.calls,
+			(unsigned long long)(t.calls ? t.callbackTime / t.calls : 0), t.maxCallbackTime,
+			(unsigned long long)(t.calls ? t.jitter / t.calls : 0), t.maxJitter,
+			t.missedDeadlines, t.overruns);
+	}
+
+	return true;
+}
+
 bool Debugger::cmdDebugFlagsList(int argc, const char **argv) {
 	const Common::DebugManager::DebugChannelList &debugLevels = DebugMan.getDebugChannels();
 
@@ -1656,6 +1656,8 @@ void LauncherGrid::build() {
 
 	// Add list with game titles
 	_grid = new GridWidget(this, "LauncherGrid.IconArea");
+	// The grid picks up the thumbnails loaded in the background on tickles
+	setTickleWidget(_grid);
 	// Populate the list
 	updateListing();
 
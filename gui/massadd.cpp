@@ -19,6 +19,7 @@
  *
  */
 
+#include "base/plugins.h"
 #include "engines/metaengine.h"
 #include "common/algorithm.h"
 #include "common/config-manager.h"
@@ -61,6 +62,8 @@ MassAddDialog::MassAddDialog(const Common::FSNode &startDir)
 	_dirsScanned(0),
 	_oldGamesCount(0),
 	_dirTotal(0),
+	_scanEngine(0),
+	_scanInProgress(false),
 	_okButton(nullptr),
 	_dirProgressText(nullptr),
 	_gameProgressText(nullptr) {
@@ -107,6 +110,14 @@ MassAddDialog::MassAddDialog(const Common::FSNode &startDir)
 			_pathToTargets[path].push_back(iter->_key);
 		}
 	}
+
+	// Write the detection cache once, when the dialog closes, instead of
+	// after every scanned directory
+	ADCacheMan.beginPersistentBatch();
+}
+
+MassAddDialog::~MassAddDialog() {
+	ADCacheMan.endPersistentBatch();
 }
 
 struct GameTargetLess {
@@ -157,6 +168,10 @@ void MassAddDialog::handleCommand(CommandSender *sender, uint32 cmd, uint32 data
 		close();
 	} else if (cmd == kCancelCmd) {
 		// User cancelled, so we don't do anything and just leave.
+		if (_scanInProgress) {
+			ADCacheMan.clearArchives();
+			_scanInProgress = false;
+		}
 		_games.clear();
 		close();
 	} else if (cmd == kListSelectionChangedCmd) {
@@ -183,100 +198,134 @@ void MassAddDialog::updateGameList() {
 	}
 }
 
-void MassAddDialog::handleTickle() {
-	if (_scanStack.empty())
-		return;	// We have finished scanning
-
-	uint32 t = g_system->getMillis();
+void MassAddDialog::startDirectoryScan(const Common::FSNode &dir) {
+	_scanFiles.clear();
+	if (!dir.getChildren(_scanFiles, Common::FSNode::kListAll)) {
+		_dirsScanned++;
+		return;
+	}
 
-	// Perform a breadth-first scan of the filesystem.
-	while (!_scanStack.empty() && (g_system->getMillis() - t) < kMaxScanTime) {
-		Common::FSNode dir = _scanStack.pop();
+	// Queue all subdirs right away, so the progress shows the whole
+	// amount of work known so far
+	for (Common::FSList::const_iterator file = _scanFiles.begin(); file != _scanFiles.end(); ++file) {
+		if (file->isDirectory()) {
+			_scanStack.push(*file);
 
-		Common::FSList files;
-		if (!dir.getChildren(files, Common::FSNode::kListAll)) {
-			continue;
+			_dirTotal++;
 		}
+	}
 
-		// Run the detector on the dir
-		DetectionResults detectionResults = EngineMan.detectGames(files, (ADGF_WARNING | ADGF_UNSUPPORTED), true);
+	if (_scanFiles.empty()) {
+		_dirsScanned++;
+		return;
+	}
 
-		if (detectionResults.foundUnknownGames()) {
-			Common::U32String report = detectionResults.generateUnknownGameReport(false, 80);
-			g_system->logMessage(LogMessageType::kInfo, report.encode().c_str());
-		}
+	// Clear md5 cache before each detection starts, just in case.
+	ADCacheMan.clear();
 
-		// Just add all detected games / game variants. If we get more than one,
-		// that either means the directory contains multiple games, or the detector
-		// could not fully determine which game variant it was seeing. In either
-		// case, let the user choose which entries he wants to keep.
-		//
-		// However, we only add games which are not already in the config file.
-		DetectedGames candidates = detectionResults.listRecognizedGames();
-		for (DetectedGames::const_iterator cand = candidates.begin(); cand != candidates.end(); ++cand) {
-			const DetectedGame &result = *cand;
-
-			Common::Path path = dir.getPath();
-			path.removeTrailingSeparators();
-
-			// Check for existing config entries for this path/engineid/gameid/lang/platform combination
-			if (_pathToTargets.contains(path)) {
-				Common::String resultPlatformCode = Common::getPlatformCode(result.platform);
-				Common::String resultLanguageCode = Common::getLanguageCode(result.language);
-
-				bool duplicate = false;
-				const Common::StringArray &targets = _pathToTargets[path];
-				for (Common::StringArray::const_iterator iter = targets.begin(); iter != targets.end(); ++iter) {
-					// If the engineid, gameid, platform and language match -> skip it
-					Common::ConfigManager::Domain *dom = ConfMan.getDomain(*iter);
-					assert(dom);
-
-					if ((!dom->contains("engineid") || (*dom)["engineid"] == result.engineId) &&
-						(*dom)["gameid"] == result.gameId &&
-					    dom->getValOrDefault("platform") == resultPlatformCode &&
-						parseLanguage(dom->getValOrDefault("language")) == parseLanguage(resultLanguageCode)) {
-						duplicate = true;
-						break;
-					}
-				}
-				if (duplicate) {
-					_oldGamesCount++;
-					continue;	// Skip duplicates
-				}
-			}
-			_games.push_back(result);
+	_scanDir = dir;
+	_scanCandidates.clear();
+	_scanEngine = 0;
+	_scanInProgress = true;
+}
 
-			_list->append(result.description);
-		}
+void MassAddDialog::finishDirectoryScan() {
+	// Close all archives that were opened during detection
+	ADCacheMan.clearArchives();
+	_scanInProgress = false;
+	_scanFiles.clear();
 
-		for (DetectedGame &game : _games) {
-			game.isSelected = true;
-		}
+	DetectionResults detectionResults(_scanCandidates);
+	_scanCandidates.clear();
 
-		updateGameList();
+	if (detectionResults.foundUnknownGames()) {
+		Common::U32String report = detectionResults.generateUnknownGameReport(false, 80);
+		g_system->logMessage(LogMessageType::kInfo, report.encode().c_str());
+	}
 
-		// Recurse into all subdirs
-		for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
-			if (file->isDirectory()) {
-				_scanStack.push(*file);
+	// Just add all detected games / game variants. If we get more than one,
+	// that either means the directory contains multiple games, or the detector
+	// could not fully determine which game variant it was seeing. In either
+	// case, let the user choose which entries he wants to keep.
+	//
+	// However, we only add games which are not already in the config file.
+	DetectedGames candidates = detectionResults.listRecognizedGames();
+	for (DetectedGames::const_iterator cand = candidates.begin(); cand != candidates.end(); ++cand) {
+		const DetectedGame &result = *cand;
+
+		Common::Path path = _scanDir.getPath();
+		path.removeTrailingSeparators();
 
-				_dirTotal++;
+		// Check for existing config entries for this path/engineid/gameid/lang/platform combination
+		if (_pathToTargets.contains(path)) {
+			Common::String resultPlatformCode = Common::getPlatformCode(result.platform);
+			Common::String resultLanguageCode = Common::getLanguageCode(result.language);
+
+			bool duplicate = false;
+			const Common::StringArray &targets = _pathToTargets[path];
+			for (Common::StringArray::const_iterator iter = targets.begin(); iter != targets.end(); ++iter) {
+				// If the engineid, gameid, platform and language match -> skip it
+				Common::ConfigManager::Domain *dom = ConfMan.getDomain(*iter);
+				assert(dom);
+
+				if ((!dom->contains("engineid") || (*dom)["engineid"] == result.engineId) &&
+					(*dom)["gameid"] == result.gameId &&
+				    dom->getValOrDefault("platform") == resultPlatformCode &&
+					parseLanguage(dom->getValOrDefault("language")) == parseLanguage(resultLanguageCode)) {
+					duplicate = true;
+					break;
+				}
+			}
+			if (duplicate) {
+				_oldGamesCount++;
+				continue;	// Skip duplicates
 			}
 		}
+		_games.push_back(result);
+		_games.back().isSelected = true;
+	}
 
-		_dirsScanned++;
+	if (!candidates.empty())
+		updateGameList();
+
+	_dirsScanned++;
 
 #if defined(USE_TASKBAR)
-		g_system->getTaskbarManager()->setProgressValue(_dirsScanned, _dirTotal);
-		g_system->getTaskbarManager()->setCount(_games.size());
+	g_system->getTaskbarManager()->setProgressValue(_dirsScanned, _dirTotal);
+	g_system->getTaskbarManager()->setCount(_games.size());
 #endif
+}
+
+void MassAddDialog::handleTickle() {
+	if (isScanComplete())
+		return;	// We have finished scanning
+
+	uint32 t = g_system->getMillis();
+	const PluginList &plugins = EngineMan.getPlugins(PLUGIN_TYPE_ENGINE_DETECTION);
+
+	// Perform a breadth-first scan of the filesystem. Every step either
+	// lists a directory, or runs a single engine's detector on it. The
+	// steps run on the GUI thread, as many steps as fit into one tick.
+	while (!isScanComplete() && (g_system->getMillis() - t) < kMaxScanTime) {
+		if (!_scanInProgress) {
+			startDirectoryScan(_scanStack.pop());
+		} else if (_scanEngine < plugins.size()) {
+			DetectedGames engineCandidates = EngineMan.detectGames(plugins[_scanEngine], _scanFiles, (ADGF_WARNING | ADGF_UNSUPPORTED), true);
+			_scanCandidates.push_back(engineCandidates);
+			_scanEngine++;
+		} else {
+			finishDirectoryScan();
+		}
 	}
 
+	updateProgress();
+}
 
+void MassAddDialog::updateProgress() {
 	// Update the dialog
 	Common::U32String buf;
 
-	if (_scanStack.empty()) {
+	if (isScanComplete()) {
 		// Enable the OK button
 		_okButton->setEnabled(true);
 
@@ -287,7 +336,7 @@ void MassAddDialog::handleTickle() {
 		_gameProgressText->setLabel(buf);
 
 	} else {
-		buf = Common::U32String::format(_("Scanned %d directories ..."), _dirsScanned);
+		buf = Common::U32String::format(_("Scanned %d of %d directories ..."), _dirsScanned, _dirTotal + 1);
 		_dirProgressText->setLabel(buf);
 
 		buf = Common::U32String::format(_("Discovered %d new games, ignored %d previously added games ..."), _games.size(), _oldGamesCount);
@@ -37,6 +37,7 @@ class MassAddListWidget;
 class MassAddDialog : public Dialog {
 public:
 	MassAddDialog(const Common::FSNode &startDir);
+	~MassAddDialog() override;
 
 	//void open();
 	void handleCommand(CommandSender *sender, uint32 cmd, uint32 data) override;
@@ -52,7 +53,26 @@ private:
 	Common::Stack<Common::FSNode>  _scanStack;
 	DetectedGames _games;
 
+	/**
+	 * The directory currently being scanned. Its detection runs one engine
+	 * at a time, so a single slow directory doesn't block the GUI, and a
+	 * cancellation takes effect right away.
+	 *
+	 * TODO: Run the detectors on a worker pool. This first needs the engine
+	 * detectors and ADCacheMan to be thread safe, and directory listings
+	 * which can be handed between threads.
+	 */
+	Common::FSNode _scanDir;
+	Common::FSList _scanFiles;
+	DetectedGames _scanCandidates;
+	uint _scanEngine;
+	bool _scanInProgress;
+
 	void updateGameList();
+	bool isScanComplete() const { return _scanStack.empty() && !_scanInProgress; }
+	void startDirectoryScan(const Common::FSNode &dir);
+	void finishDirectoryScan();
+	void updateProgress();
 
 	/**
 	 * Map each path occurring in the config file to the target(s) using that path.
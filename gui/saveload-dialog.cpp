@@ -39,10 +39,98 @@
 #include "common/savefile.h"
 #include "engines/engine.h"
 
+namespace Common {
+DECLARE_SINGLETON(GUI::SaveMetaInfoLoader);
+}
+
 namespace GUI {
 
 #define SCALEVALUE(val) ((val) * g_gui.getScaleFactor())
 
+enum {
+	// Time spent loading meta infos on each GUI frame, in milliseconds
+	kMetaInfoLoadBudget = 8
+};
+
+SaveMetaInfoLoader::SaveMetaInfoLoader() : _metaEngine(nullptr) {
+}
+
+void SaveMetaInfoLoader::setTarget(const MetaEngine *metaEngine, const Common::String &target) {
+	if (target != _target) {
+		_cache.clear();
+		_target = target;
+	}
+
+	_metaEngine = metaEngine;
+	_requests.clear();
+
+	// Entries without file information can't be checked, so they are only
+	// kept until the list of saves is refreshed
+	for (Common::HashMap<int, Entry>::iterator i = _cache.begin(); i != _cache.end(); ++i) {
+		if (i->_value.hasStats)
+			i->_value.verified = false;
+		else
+			_cache.erase(i);
+	}
+}
+
+void SaveMetaInfoLoader::stop() {
+	_metaEngine = nullptr;
+	_requests.clear();
+}
+
+bool SaveMetaInfoLoader::lookup(int slot, SaveStateDescriptor &desc) {
+	Common::HashMap<int, Entry>::iterator i = _cache.find(slot);
+	if (i == _cache.end())
+		return false;
+
+	Entry &entry = i->_value;
+	if (!entry.verified) {
+		int64 size, modificationTime;
+		if (!getSaveFileStats(slot, size, modificationTime) || size != entry.size || modificationTime != entry.modificationTime) {
+			_cache.erase(i);
+			return false;
+		}
+
+		entry.verified = true;
+	}
+
+	desc = entry.desc;
+	return true;
+}
+
+void SaveMetaInfoLoader::request(int slot) {
+	if (Common::find(_requests.begin(), _requests.end(), slot) == _requests.end())
+		_requests.push_back(slot);
+}
+
+bool SaveMetaInfoLoader::poll(uint32 timeBudget) {
+	if (!_metaEngine || _requests.empty())
+		return false;
+
+	const uint32 start = g_system->getMillis();
+	do {
+		const int slot = _requests.front();
+		_requests.remove_at(0);
+
+		Entry entry;
+		entry.hasStats = getSaveFileStats(slot, entry.size, entry.modificationTime);
+		entry.verified = true;
+		entry.desc = _metaEngine->querySaveMetaInfos(_target.c_str(), slot);
+		_cache.setVal(slot, entry);
+	} while (!_requests.empty() && g_system->getMillis() - start < timeBudget);
+
+	return true;
+}
+
+bool SaveMetaInfoLoader::getSaveFileStats(int slot, int64 &size, int64 &modificationTime) const {
+	if (!_metaEngine)
+		return false;
+
+	const Common::String filename = _metaEngine->getSavegameFile(slot, _target.c_str());
+	return g_system->getSavefileManager()->getSavefileStats(filename, size, modificationTime);
+}
+
 #if defined(USE_CLOUD) && defined(USE_LIBCURL)
 
 enum {
@@ -217,6 +305,8 @@ void SaveLoadChooserDialog::open() {
 }
 
 void SaveLoadChooserDialog::close() {
+	SaveMetaInfoLoader::instance().stop();
+
 	Dialog::close();
 }
 
@@ -290,6 +380,9 @@ void SaveLoadChooserDialog::handleTickle() {
 
 	pollCloudMan();
 #endif
+	if (SaveMetaInfoLoader::instance().poll(kMetaInfoLoadBudget))
+		handleMetaInfosLoaded();
+
 	Dialog::handleTickle();
 }
 
@@ -327,6 +420,7 @@ void SaveLoadChooserDialog::updateSaveList() {
 void SaveLoadChooserDialog::listSaves() {
 	if (!_metaEngine) return; //very strange
 	_saveList = _metaEngine->listSaves(_target.c_str(), _saveMode);
+	SaveMetaInfoLoader::instance().setTarget(_metaEngine, _target);
 
 #if defined(USE_CLOUD) && defined(USE_LIBCURL)
 	//if there is Cloud support, add currently synced files as "locked" saves in the list
@@ -359,8 +453,12 @@ void SaveLoadChooserDialog::listSaves() {
 void SaveLoadChooserDialog::activate(int slot, const Common::U32String &description) {
 	if (!_saveList.empty() && slot < int(_saveList.size())) {
 		const SaveStateDescriptor &desc = _saveList[slot];
-		if (_saveMode)
+		if (_saveMode) {
 			_resultString = description.empty() ? desc.getDescription() : description;
+			// The save file might be rewritten within the resolution of its
+			// modification time
+			SaveMetaInfoLoader::instance().invalidate(desc.getSaveSlot());
+		}
 		setResult(desc.getSaveSlot());
 	}
 	close();
@@ -643,13 +741,25 @@ void SaveLoadChooserSimple::updateSelection(bool redraw) {
 	_playtime->setLabel(_("No playtime saved"));
 
 	if (selItem >= 0 && _metaInfoSupport) {
-		SaveStateDescriptor desc = (_saveList[selItem].getLocked() ? _saveList[selItem] : _metaEngine->querySaveMetaInfos(_target.c_str(), _saveList[selItem].getSaveSlot()));
-		if (!_saveList[selItem].getLocked() && desc.getSaveSlot() >= 0 && !desc.getDescription().empty())
-			_saveList[selItem] = desc;
+		SaveMetaInfoLoader &loader = SaveMetaInfoLoader::instance();
+		SaveStateDescriptor desc = _saveList[selItem];
+		bool isLoaded = true;
+		if (!_saveList[selItem].getLocked()) {
+			isLoaded = loader.lookup(_saveList[selItem].getSaveSlot(), desc);
+			if (isLoaded) {
+				if (desc.getSaveSlot() >= 0 && !desc.getDescription().empty())
+					_saveList[selItem] = desc;
+			} else {
+				// Show the entry from the list of saves until the meta infos are loaded
+				loader.clearRequests();
+				loader.request(_saveList[selItem].getSaveSlot());
+			}
+		}
 
 		isDeletable = _saveList[selItem].getDeletableFlag() && _delSupport;
+		// Don't allow overwriting the save before knowing it is not write protected
 		isWriteProtected = desc.getWriteProtectedFlag() ||
-			_saveList[selItem].getWriteProtectedFlag();
+			_saveList[selItem].getWriteProtectedFlag() || (_saveMode && !isLoaded);
 		isLocked = desc.getLocked();
 
 		if (_thumbnailSupport) {
@@ -700,6 +810,10 @@ void SaveLoadChooserSimple::updateSelection(bool redraw) {
 	}
 }
 
+void SaveLoadChooserSimple::handleMetaInfosLoaded() {
+	updateSelection(true);
+}
+
 void SaveLoadChooserSimple::open() {
 	SaveLoadChooserDialog::open();
 
@@ -899,6 +1013,11 @@ void SaveLoadChooserGrid::updateSaveList() {
 	g_gui.scheduleTopDialogRedraw();
 }
 
+void SaveLoadChooserGrid::handleMetaInfosLoaded() {
+	updateSaves();
+	g_gui.scheduleTopDialogRedraw();
+}
+
 void SaveLoadChooserGrid::open() {
 	SaveLoadChooserDialog::open();
 
@@ -1141,14 +1260,28 @@ void SaveLoadChooserGrid::hideButtons() {
 void SaveLoadChooserGrid::updateSaves() {
 	hideButtons();
 
+	// Only the slots of the current page are loaded
+	SaveMetaInfoLoader &loader = SaveMetaInfoLoader::instance();
+	loader.clearRequests();
+
 	bool isWriteProtected = false;
 
 	for (uint i = _curPage * _entriesPerPage, curNum = 0; i < _saveList.size() && curNum < _entriesPerPage; ++i, ++curNum) {
 		const uint saveSlot = _saveList[i].getSaveSlot();
 
-		SaveStateDescriptor desc =  (_saveList[i].getLocked() ? _saveList[i] : _metaEngine->querySaveMetaInfos(_target.c_str(), saveSlot));
-		if (!_saveList[i].getLocked() && desc.getSaveSlot() >= 0 && !desc.getDescription().empty())
-			_saveList[i] = desc;
+		// Until its meta infos are loaded, the slot is shown with the entry
+		// from the list of saves and an empty thumbnail
+		SaveStateDescriptor desc = _saveList[i];
+		bool isLoaded = true;
+		if (!_saveList[i].getLocked()) {
+			isLoaded = loader.lookup(saveSlot, desc);
+			if (isLoaded) {
+				if (desc.getSaveSlot() >= 0 && !desc.getDescription().empty())
+					_saveList[i] = desc;
+			} else {
+				loader.request(saveSlot);
+			}
+		}
 		SlotButton &curButton = _buttons[curNum];
 		curButton.setVisible(true);
 		const Graphics::Surface *thumbnail = desc.getThumbnail();
@@ -1186,11 +1319,12 @@ void SaveLoadChooserGrid::updateSaves() {
 
 		curButton.button->setTooltip(tooltip);
 
-		// In save mode we disable the button, when it's write protected.
+		// In save mode we disable the button, when it's write protected or its
+		// meta infos are not loaded yet.
 		// TODO: Maybe we should not display it at all then?
 		// We also disable and description the button if slot is locked
 		isWriteProtected = desc.getWriteProtectedFlag() ||
-			_saveList[i].getWriteProtectedFlag();
+			_saveList[i].getWriteProtectedFlag() || !isLoaded;
 		if ((_saveMode && isWriteProtected) || desc.getLocked()) {
 			curButton.button->setEnabled(false);
 		} else {
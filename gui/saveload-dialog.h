@@ -25,10 +25,81 @@
 #include "gui/dialog.h"
 #include "gui/widgets/list.h"
 
+#include "common/hashmap.h"
+#include "common/singleton.h"
+
 #include "engines/metaengine.h"
 
 namespace GUI {
 
+/**
+ * Loads the meta infos of the save states shown by the save/load choosers.
+ *
+ * The choosers request the slots they show, draw them with placeholders,
+ * and fill them in as poll() loads them from the dialog's tickle handler,
+ * a few slots per frame.
+ *
+ * The loaded meta infos are cached for the last target shown, and reused
+ * for as long as the size and modification time of the save file stay the
+ * same.
+ */
+class SaveMetaInfoLoader : public Common::Singleton<SaveMetaInfoLoader> {
+	friend class Common::Singleton<SingletonBaseType>;
+
+public:
+	/**
+	 * Start loading the save states of a target. This drops all pending
+	 * requests, and makes the cached entries be checked against their save
+	 * file again before being used.
+	 */
+	void setTarget(const MetaEngine *metaEngine, const Common::String &target);
+
+	/** Drop the pending requests and forget the meta engine. */
+	void stop();
+
+	/**
+	 * Get the meta infos of a slot if they are loaded and up to date.
+	 *
+	 * @return true if desc was filled in, false otherwise.
+	 */
+	bool lookup(int slot, SaveStateDescriptor &desc);
+
+	/** Queue loading the meta infos of a slot. */
+	void request(int slot);
+
+	/** Drop the pending requests. */
+	void clearRequests() { _requests.clear(); }
+
+	/** Remove a slot from the cache, for example after it was overwritten. */
+	void invalidate(int slot) { _cache.erase(slot); }
+
+	/**
+	 * Load requested slots until the given number of milliseconds is spent.
+	 * At least one slot is loaded if any is pending.
+	 *
+	 * @return true if any slot was loaded.
+	 */
+	bool poll(uint32 timeBudget);
+
+private:
+	SaveMetaInfoLoader();
+
+	struct Entry {
+		SaveStateDescriptor desc;
+		bool hasStats;   ///< Whether the size and modification time are known.
+		bool verified;   ///< Whether the entry was checked since setTarget().
+		int64 size;
+		int64 modificationTime;
+	};
+
+	bool getSaveFileStats(int slot, int64 &size, int64 &modificationTime) const;
+
+	const MetaEngine *_metaEngine;
+	Common::String _target;
+	Common::Array<int> _requests;
+	Common::HashMap<int, Entry> _cache;
+};
+
 #if defined(USE_CLOUD) && defined(USE_LIBCURL)
 class SaveLoadChooserDialog;
 
@@ -114,6 +185,9 @@ protected:
 
 	void activate(int slot, const Common::U32String &description);
 
+	/** Called when requested meta infos have been loaded by SaveMetaInfoLoader. */
+	virtual void handleMetaInfosLoaded() {}
+
 	const bool					_saveMode;
 	const MetaEngine		    *_metaEngine;
 	bool						_delSupport;
@@ -163,6 +237,7 @@ public:
 	void close() override;
 protected:
 	void updateSaveList() override;
+	void handleMetaInfosLoaded() override;
 private:
 	int runIntern() override;
 
@@ -220,6 +295,7 @@ protected:
 	void handleCommand(CommandSender *sender, uint32 cmd, uint32 data) override;
 	void handleMouseWheel(int x, int y, int direction) override;
 	void updateSaveList() override;
+	void handleMetaInfosLoaded() override;
 private:
 	int runIntern() override;
 
@@ -20,7 +20,13 @@
  */
 
 #include "common/system.h"
+#include "common/atomic.h"
+#include "common/config-manager.h"
+#include "common/crc.h"
 #include "common/file.h"
+#include "common/memstream.h"
+#include "common/compression/deflate.h"
+#include "common/compression/unzip.h"
 #include "common/language.h"
 #include "common/platform.h"
 #include "common/tokenizer.h"
@@ -397,6 +403,150 @@ Graphics::ManagedSurface *loadSurfaceFromFile(const Common::String &name, int re
 	return surf;
 }
 
+// Scaled thumbnails are kept in the icon-cache directory next to the configuration
+// file, one compressed file per icon and size. The icons live in archives which do
+// not provide modification times, so entries are validated against the size and
+// the CRC32 of the icon file instead.
+static const uint32 kIconCacheMagic = MKTAG('S', 'I', 'C', 'N');
+static const byte kIconCacheVersion = 1;
+
+static Common::Path getIconCacheDirectory() {
+	Common::Path configFile = ConfMan.getCustomConfigFileName();
+	if (configFile.empty())
+		configFile = g_system->getDefaultConfigFileName();
+
+	return configFile.getParent().appendComponent("icon-cache");
+}
+
+static Common::FSNode getIconCacheFile(const Common::FSNode &dir, const Common::String &key) {
+	Common::CRC32 crc;
+	return dir.getChild(Common::String::format("%08x.bin", crc.crcFast((const byte *)key.c_str(), key.size())));
+}
+
+static Graphics::ManagedSurface *loadCachedThumbnail(const Common::FSNode &node, const Common::String &key, uint32 sourceSize, uint32 sourceCrc) {
+	if (!node.exists())
+		return nullptr;
+
+	Common::SeekableReadStream *stream = Common::wrapCompressedReadStream(node.createReadStream());
+	if (!stream)
+		return nullptr;
+
+	Graphics::ManagedSurface *surf = nullptr;
+	if (stream->readUint32BE() == kIconCacheMagic && stream->readByte() == kIconCacheVersion) {
+		Common::String storedKey = stream->readPascalString();
+		const uint32 storedSize = stream->readUint32LE();
+		const uint32 storedCrc = stream->readUint32LE();
+		const uint16 w = stream->readUint16LE();
+		const uint16 h = stream->readUint16LE();
+
+		Graphics::PixelFormat format;
+		format.bytesPerPixel = stream->readByte();
+		format.rLoss = stream->readByte();
+		format.gLoss = stream->readByte();
+		format.bLoss = stream->readByte();
+		format.aLoss = stream->readByte();
+		format.rShift = stream->readByte();
+		format.gShift = stream->readByte();
+		format.bShift = stream->readByte();
+		format.aShift = stream->readByte();
+
+		if (!stream->err() && storedKey == key && storedSize == sourceSize && storedCrc == sourceCrc &&
+			format.bytesPerPixel >= 2 && format.bytesPerPixel <= 4) {
+			surf = new Graphics::ManagedSurface(w, h, format);
+			for (int y = 0; y < h; y++)
+				stream->read(surf->getBasePtr(0, y), w * format.bytesPerPixel);
+
+			if (stream->err() || stream->eos()) {
+				delete surf;
+				surf = nullptr;
+			}
+		}
+	}
+
+	delete stream;
+	return surf;
+}
+
+static void saveCachedThumbnail(const Common::FSNode &dir, const Common::FSNode &node, const Common::String &key, uint32 sourceSize, uint32 sourceCrc, const Graphics::ManagedSurface &surf) {
+	// The key is stored as a Pascal string
+	if (key.size() > 255)
+		return;
+
+	if (!dir.exists() && !dir.createDirectory())
+		return;
+
+	Common::DumpFile *file = new Common::DumpFile();
+	if (!file->open(node)) {
+		delete file;
+		return;
+	}
+
+	Common::WriteStream *stream = Common::wrapCompressedWriteStream(file);
+	stream->writeUint32BE(kIconCacheMagic);
+	stream->writeByte(kIconCacheVersion);
+	stream->writeByte(key.size());
+	stream->writeString(key);
+	stream->writeUint32LE(sourceSize);
+	stream->writeUint32LE(sourceCrc);
+	stream->writeUint16LE(surf.w);
+	stream->writeUint16LE(surf.h);
+
+	const Graphics::PixelFormat &format = surf.format;
+	stream->writeByte(format.bytesPerPixel);
+	stream->writeByte(format.rLoss);
+	stream->writeByte(format.gLoss);
+	stream->writeByte(format.bLoss);
+	stream->writeByte(format.aLoss);
+	stream->writeByte(format.rShift);
+	stream->writeByte(format.gShift);
+	stream->writeByte(format.bShift);
+	stream->writeByte(format.aShift);
+
+	for (int y = 0; y < surf.h; y++)
+		stream->write(surf.getBasePtr(0, y), surf.w * format.bytesPerPixel);
+
+	stream->finalize();
+	if (stream->err())
+		warning("Unable to write icon cache file for '%s'", key.c_str());
+	delete stream;
+}
+
+// Decodes and scales an icon on a worker thread. The task only gets the contents
+// of the icon file, since the file system and the icon archives are only used from
+// the GUI thread.
+struct ThumbnailLoader {
+	byte *data;					// Freed by the task
+	uint32 size;
+	int width, height;
+	volatile uint32 *cancelled;
+
+	const Graphics::ManagedSurface *operator()() const {
+		Common::MemoryReadStream memStream(data, size, DisposeAfterUse::YES);
+		if (Common::atomicLoadAcquire(cancelled))
+			return nullptr;
+
+#ifdef USE_PNG
+		Image::PNGDecoder decoder;
+		if (!decoder.loadStream(memStream))
+			return nullptr;
+
+		const Graphics::Surface *srcSurface = decoder.getSurface();
+		if (!srcSurface || srcSurface->format.bytesPerPixel == 1)
+			return nullptr;
+
+		Graphics::ManagedSurface *surf = new Graphics::ManagedSurface();
+		surf->copyFrom(*srcSurface);
+
+		const Graphics::ManagedSurface *scSurf = scaleGfx(surf, width, height, true);
+		if (scSurf != surf)
+			delete surf;
+		return scSurf;
+#else
+		return nullptr;
+#endif
+	}
+};
+
 #pragma mark -
 
 GridWidget::GridWidget(GuiObject *boss, const Common::String &name)
@@ -444,9 +594,20 @@ GridWidget::GridWidget(GuiObject *boss, const Common::String &name)
 
 	_selectedEntry = nullptr;
 	_isGridInvalid = true;
+
+	_thumbnailLoader = nullptr;
+	_cancelThumbnailLoading = 0;
+	setFlags(WIDGET_WANT_TICKLE);
 }
 
 GridWidget::~GridWidget() {
+	// Let the queued decoding tasks return early, and drop their results
+	Common::atomicStoreRelease(&_cancelThumbnailLoading, 1);
+	delete _thumbnailLoader;
+	for (uint i = 0; i < _pendingThumbnails.size(); ++i)
+		delete _pendingThumbnails[i].surface.get();
+	_pendingThumbnails.clear();
+
 	unloadSurfaces(_platformIcons);
 	unloadSurfaces(_languageIcons);
 	unloadSurfaces(_extraIcons);
@@ -707,32 +868,182 @@ void GridWidget::reloadThumbnails() {
 		if (!_loadedSurfaces.contains(entry->thumbPath)) {
 			_loadedSurfaces[entry->thumbPath] = nullptr;
 			Common::String path = Common::String::format("icons/%s-%s.png", entry->engineid.c_str(), entry->gameid.c_str());
-			Graphics::ManagedSurface *surf = loadSurfaceFromFile(path);
-			if (!surf) {
+			g_gui.lockIconsSet();
+			const bool hasIcon = g_gui.getIconsSet().hasFile(Common::Path(path));
+			g_gui.unlockIconsSet();
+
+			if (!hasIcon) {
 				path = Common::String::format("icons/%s.png", entry->engineid.c_str());
-				if (!_loadedSurfaces.contains(path)) {
-					surf = loadSurfaceFromFile(path);
-				} else {
+				if (_loadedSurfaces.contains(path)) {
+					// The engine icon is either loaded already, missing, or still being loaded
 					const Graphics::ManagedSurface *scSurf = _loadedSurfaces[path];
-					_loadedSurfaces[entry->thumbPath] = new Graphics::ManagedSurface(*scSurf);
+					if (scSurf)
+						_loadedSurfaces[entry->thumbPath] = new Graphics::ManagedSurface(*scSurf);
+					else
+						requestThumbnail(entry->thumbPath, path, thumbnailWidth, thumbnailHeight);
+					continue;
 				}
 			}
 
-			if (surf) {
-				const Graphics::ManagedSurface *scSurf(scaleGfx(surf, thumbnailWidth, thumbnailHeight, true));
-				_loadedSurfaces[entry->thumbPath] = scSurf;
+			requestThumbnail(entry->thumbPath, path, thumbnailWidth, thumbnailHeight);
+		}
+	}
 
-				if (path != entry->thumbPath) {
-					_loadedSurfaces[path] = new Graphics::ManagedSurface(*scSurf);
-				}
+	// Without worker threads, the thumbnails have been decoded already
+	collectThumbnails();
+}
 
-				if (surf != scSurf) {
-					surf->free();
-					delete surf;
-				}
+void GridWidget::requestThumbnail(const Common::String &target, const Common::String &path, int width, int height) {
+	// Share the result if the same icon is already being loaded
+	for (uint i = 0; i < _pendingThumbnails.size(); ++i) {
+		PendingThumbnail &pending = _pendingThumbnails[i];
+		if (pending.path == path && pending.width == width && pending.height == height) {
+			if (target != path)
+				pending.targets.push_back(target);
+			return;
+		}
+	}
+
+	// Avoid loading a missing engine icon again for every entry using it
+	if (path != target && !_loadedSurfaces.contains(path))
+		_loadedSurfaces[path] = nullptr;
+
+	// The size and the CRC32 of icons in ZIP archives are known without
+	// decompressing them, so that cached thumbnails can be checked cheaply
+	uint32 sourceSize = 0, sourceCrc = 0;
+	bool hasChecksum = false;
+
+	g_gui.lockIconsSet();
+	Common::Archive *container = nullptr;
+	const bool hasIcon = g_gui.getIconsSet().getMember(Common::Path(path), &container) != nullptr;
+	if (hasIcon)
+		hasChecksum = Common::getZipMemberChecksum(*container, Common::Path(path), sourceSize, sourceCrc);
+	g_gui.unlockIconsSet();
+	if (!hasIcon) {
+		debug(5, "GridWidget: Cannot read file '%s'", path.c_str());
+		return;
+	}
+
+	Common::StringArray targets;
+	if (target != path)
+		targets.push_back(target);
+
+	const Common::String key = Common::String::format("%s:%dx%d", path.c_str(), width, height);
+	const bool useCache = ConfMan.getBool("enable_icon_cache");
+	Common::FSNode cacheFile;
+	if (useCache)
+		cacheFile = getIconCacheFile(Common::FSNode(getIconCacheDirectory()), key);
+
+	if (hasChecksum && useCache) {
+		Graphics::ManagedSurface *surf = loadCachedThumbnail(cacheFile, key, sourceSize, sourceCrc);
+		if (surf) {
+			setThumbnail(path, targets, surf);
+			return;
+		}
+	}
+
+	// The icon is read here, and only decoded in the background
+	byte *data = nullptr;
+	uint32 size = 0;
+	g_gui.lockIconsSet();
+	Common::SeekableReadStream *stream = g_gui.getIconsSet().createReadStreamForMember(Common::Path(path));
+	if (stream) {
+		size = stream->size();
+		data = (byte *)malloc(size);
+		if (data && stream->read(data, size) != size) {
+			free(data);
+			data = nullptr;
+		}
+		delete stream;
+	}
+	g_gui.unlockIconsSet();
+	if (!data) {
+		warning("GridWidget: Failed to read '%s'", path.c_str());
+		return;
+	}
+
+	if (!hasChecksum && useCache) {
+		// Icons outside of ZIP archives are checked against their contents
+		sourceSize = size;
+		sourceCrc = Common::CRC32().crcFast(data, size);
+		Graphics::ManagedSurface *surf = loadCachedThumbnail(cacheFile, key, sourceSize, sourceCrc);
+		if (surf) {
+			free(data);
+			setThumbnail(path, targets, surf);
+			return;
+		}
+	}
+
+	if (!_thumbnailLoader)
+		_thumbnailLoader = new Common::ThreadPool(1);
+
+	PendingThumbnail pending;
+	pending.path = path;
+	pending.targets = targets;
+	pending.width = width;
+	pending.height = height;
+	if (useCache)
+		pending.cacheKey = key;
+	pending.sourceSize = sourceSize;
+	pending.sourceCrc = sourceCrc;
+
+	ThumbnailLoader loader;
+	loader.data = data;
+	loader.size = size;
+	loader.width = width;
+	loader.height = height;
+	loader.cancelled = &_cancelThumbnailLoading;
+	pending.surface = _thumbnailLoader->submit(loader);
+
+	_pendingThumbnails.push_back(pending);
+}
+
+void GridWidget::setThumbnail(const Common::String &path, const Common::StringArray &targets, const Graphics::ManagedSurface *surf) {
+	for (uint i = 0; i < targets.size(); ++i) {
+		Graphics::ManagedSurface *copy = new Graphics::ManagedSurface();
+		copy->copyFrom(*surf);
+		delete _loadedSurfaces[targets[i]];
+		_loadedSurfaces[targets[i]] = copy;
+	}
+
+	delete _loadedSurfaces[path];
+	_loadedSurfaces[path] = surf;
+}
+
+bool GridWidget::collectThumbnails() {
+	const int thumbnailWidth = MAX(_thumbnailWidth - 2 * _thumbnailMargin, 0);
+	const int thumbnailHeight = MAX(_thumbnailHeight - 2 * _thumbnailMargin, 0);
+	bool added = false;
+
+	for (uint i = 0; i < _pendingThumbnails.size();) {
+		const PendingThumbnail &pending = _pendingThumbnails[i];
+		if (!pending.surface.isReady()) {
+			++i;
+			continue;
+		}
+
+		const Graphics::ManagedSurface *surf = pending.surface.get();
+		if (!surf) {
+			warning("GridWidget: Failed to decode '%s'", pending.path.c_str());
+		} else {
+			if (!pending.cacheKey.empty()) {
+				const Common::FSNode dir(getIconCacheDirectory());
+				saveCachedThumbnail(dir, getIconCacheFile(dir, pending.cacheKey), pending.cacheKey, pending.sourceSize, pending.sourceCrc, *surf);
+			}
+
+			// The thumbnail size may have changed in the meantime
+			if (pending.width == thumbnailWidth && pending.height == thumbnailHeight) {
+				setThumbnail(pending.path, pending.targets, surf);
+				added = true;
+			} else {
+				delete surf;
 			}
 		}
+
+		_pendingThumbnails.remove_at(i);
 	}
+
+	return added;
 }
 
 void GridWidget::loadFlagIcons() {
@@ -952,6 +1263,13 @@ void GridWidget::handleCommand(CommandSender *sender, uint32 cmd, uint32 data) {
 	}
 }
 
+void GridWidget::handleTickle() {
+	if (collectThumbnails()) {
+		updateGrid();
+		markAsDirty();
+	}
+}
+
 void GridWidget::calcInnerHeight() {
 	int row = 0;
 	int col = 0;
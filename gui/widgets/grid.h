@@ -25,6 +25,8 @@
 #include "gui/dialog.h"
 #include "gui/widgets/scrollbar.h"
 #include "common/str.h"
+#include "common/str-array.h"
+#include "common/threadpool.h"
 
 #include "image/bmp.h"
 #include "image/png.h"
@@ -109,6 +111,19 @@ protected:
 	// Images are mapped by filename -> surface.
 	Common::HashMap<Common::String, const Graphics::ManagedSurface *> _loadedSurfaces;
 
+	// Thumbnails being decoded and scaled in the background
+	struct PendingThumbnail {
+		Common::String path;
+		Common::StringArray targets;
+		int width, height;
+		Common::String cacheKey;		// Empty when the icon cache is disabled
+		uint32 sourceSize, sourceCrc;
+		Common::Future<const Graphics::ManagedSurface *> surface;
+	};
+	Common::Array<PendingThumbnail>	_pendingThumbnails;
+	Common::ThreadPool				*_thumbnailLoader;
+	volatile uint32					_cancelThumbnailLoading;
+
 	Common::Array<GridItemInfo>			_dataEntryList;
 	Common::Array<GridItemInfo>			_headerEntryList;
 	Common::Array<GridItemInfo *>		_sortedEntryList;
@@ -198,6 +213,10 @@ public:
 	void saveClosedGroups(const Common::U32String &groupName);
 
 	void reloadThumbnails();
+	void requestThumbnail(const Common::String &target, const Common::String &path, int width, int height);
+	void setThumbnail(const Common::String &path, const Common::StringArray &targets, const Graphics::ManagedSurface *surf);
+	/// Store the thumbnails decoded in the background, and returns true if any was added.
+	bool collectThumbnails();
 	void loadFlagIcons();
 	void loadPlatformIcons();
 	void loadExtraIcons();
@@ -219,6 +238,7 @@ public:
 
 	void handleMouseWheel(int x, int y, int direction) override;
 	void handleCommand(CommandSender *sender, uint32 cmd, uint32 data) override;
+	void handleTickle() override;
 	void reflowLayout() override;
 
 	bool wantsFocus() override { return true; }
@@ -0,0 +1,280 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/decoders/raw.h"
+#include "audio/audiostream.h"
+#include "audio/mixer_intern.h"
+#include "audio/mixer_kernels.h"
+
+#include "common/atomic.h"
+#include "common/memstream.h"
+#include "common/threadpool.h"
+
+#include "../null_osystem.h"
+
+class MixerTestSuite : public CxxTest::TestSuite {
+private:
+	static Audio::AudioStream *createSilence(int numSamples) {
+		byte *data = (byte *)calloc(numSamples, 2);
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream(data, numSamples * 2, DisposeAfterUse::YES);
+		return Audio::makeRawStream(stream, 22050, Audio::FLAG_16BITS);
+	}
+
+	// An endless silent stream which counts how many instances are alive,
+	// and optionally how often it was read after being stopped
+	class CountedStream : public Audio::AudioStream {
+	public:
+		CountedStream(volatile uint32 *alive, volatile uint32 *stopped = nullptr, volatile uint32 *lateReads = nullptr)
+			: _alive(alive), _stopped(stopped), _lateReads(lateReads) { Common::atomicFetchAdd(_alive, 1); }
+		~CountedStream() override { Common::atomicFetchAdd(_alive, (uint32)-1); }
+
+		int readBuffer(int16 *buffer, const int numSamples) override {
+			if (_stopped && Common::atomicLoadAcquire(_stopped))
+				Common::atomicFetchAdd(_lateReads, 1);
+			memset(buffer, 0, numSamples * sizeof(int16));
+			return numSamples;
+		}
+		bool isStereo() const override { return false; }
+		int getRate() const override { return 22050; }
+		bool endOfData() const override { return false; }
+
+	private:
+		volatile uint32 *_alive;
+		volatile uint32 *_stopped;
+		volatile uint32 *_lateReads;
+	};
+
+	// A stream which calls back into the mixer from the audio thread, like
+	// the streams of some engines do
+	class ReentrantStream : public Audio::AudioStream {
+	public:
+		ReentrantStream(Audio::Mixer *mixer, Audio::SoundHandle other) : _mixer(mixer), _other(other) {}
+
+		int readBuffer(int16 *buffer, const int numSamples) override {
+			_mixer->setChannelVolume(_other, 10);
+			_mixer->stopHandle(_other);
+			memset(buffer, 0, numSamples * sizeof(int16));
+			return numSamples;
+		}
+		bool isStereo() const override { return false; }
+		int getRate() const override { return 22050; }
+		bool endOfData() const override { return false; }
+
+	private:
+		Audio::Mixer *_mixer;
+		Audio::SoundHandle _other;
+	};
+
+	struct MixLoop {
+		Audio::MixerImpl *mixer;
+		volatile uint32 *done;
+
+		void operator()() const {
+			byte buffer[256 * 4];
+			while (!Common::atomicLoadAcquire(done))
+				mixer->mixCallback(buffer, sizeof(buffer));
+		}
+	};
+
+public:
+	void test_queued_changes_are_visible_right_away() {
+		Common::install_null_g_system();
+
+		Audio::MixerImpl mixerImpl(44100);
+		mixerImpl.setReady(true);
+		Audio::Mixer &mixer = mixerImpl;
+
+		Audio::SoundHandle handle;
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &handle, createSilence(22050), 42);
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+		TS_ASSERT(mixer.isSoundIDActive(42));
+		TS_ASSERT_EQUALS(mixer.getSoundID(handle), 42);
+		TS_ASSERT(mixer.hasActiveChannelOfType(Audio::Mixer::kSFXSoundType));
+
+		mixer.setChannelVolume(handle, 100);
+		mixer.setChannelBalance(handle, -20);
+		mixer.setChannelRate(handle, 11025);
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), 100);
+		TS_ASSERT_EQUALS(mixer.getChannelBalance(handle), -20);
+		TS_ASSERT_EQUALS(mixer.getChannelRate(handle), 11025u);
+
+		mixer.resetChannelRate(handle);
+		TS_ASSERT_EQUALS(mixer.getChannelRate(handle), 22050u);
+
+		mixer.stopHandle(handle);
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+		TS_ASSERT(!mixer.isSoundIDActive(42));
+	}
+
+	void test_finished_sounds_are_reported() {
+		Common::install_null_g_system();
+
+		// The null OSystem cannot report CPU features
+		Audio::MixerKernels::accumulateFunc = Audio::MixerKernels::accumulateGeneric;
+		Audio::MixerKernels::clampFunc = Audio::MixerKernels::clampGeneric;
+
+		Audio::MixerImpl mixerImpl(22050);
+		mixerImpl.setReady(true);
+		Audio::Mixer &mixer = mixerImpl;
+
+		Audio::SoundHandle handle;
+		mixer.playStream(Audio::Mixer::kMusicSoundType, &handle, createSilence(100));
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+
+		byte buffer[1024 * 4];
+		mixerImpl.mixCallback(buffer, sizeof(buffer));
+		// The stream has ended, and the channel is cleaned up in the next callback
+		mixerImpl.mixCallback(buffer, sizeof(buffer));
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+	}
+
+	void test_command_queue_overflow() {
+		Common::install_null_g_system();
+
+		Audio::MixerImpl mixerImpl(22050);
+		mixerImpl.setReady(true);
+		Audio::Mixer &mixer = mixerImpl;
+
+		Audio::SoundHandle handle;
+		mixer.playStream(Audio::Mixer::kMusicSoundType, &handle, createSilence(22050));
+
+		// Without an audio thread, the queue fills up. Repeated changes are
+		// merged until the audio thread catches up again.
+		for (int i = 0; i < 1000; i++)
+			mixer.setChannelVolume(handle, i & 0xFF);
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), 999 & 0xFF);
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+
+		byte buffer[256 * 4];
+		mixerImpl.mixCallback(buffer, sizeof(buffer));
+		mixer.stopHandle(handle);
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+	}
+
+	void test_stats() {
+		Common::install_null_g_system();
+
+		Audio::MixerKernels::accumulateFunc = Audio::MixerKernels::accumulateGeneric;
+		Audio::MixerKernels::clampFunc = Audio::MixerKernels::clampGeneric;
+
+		Audio::MixerImpl mixerImpl(22050);
+		mixerImpl.setReady(true);
+		Audio::Mixer &mixer = mixerImpl;
+
+		Audio::SoundHandle handle, queueHandle;
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &handle, createSilence(22050), 7);
+		// An empty queue which never ends has to be reported as starved
+		Audio::QueuingAudioStream *queue = Audio::makeQueuingAudioStream(22050, false);
+		mixer.playStream(Audio::Mixer::kMusicSoundType, &queueHandle, queue);
+
+		byte buffer[1024 * 4];
+		mixerImpl.mixCallback(buffer, sizeof(buffer));
+		mixerImpl.mixCallback(buffer, sizeof(buffer));
+
+		Audio::Mixer::MixerStats stats;
+		Common::Array<Audio::Mixer::ChannelStats> channels;
+		mixer.getStats(stats, channels);
+		TS_ASSERT_EQUALS(stats.callbacks, 2u);
+		TS_ASSERT_EQUALS(stats.samplesRequested, 2048u);
+		TS_ASSERT_EQUALS(channels.size(), 2u);
+
+		for (uint i = 0; i < channels.size(); i++) {
+			TS_ASSERT_EQUALS(channels[i].callbacks, 2u);
+			if (channels[i].type == Audio::Mixer::kSFXSoundType) {
+				TS_ASSERT_EQUALS(channels[i].id, 7);
+				TS_ASSERT_EQUALS(channels[i].rate, 22050u);
+				TS_ASSERT_EQUALS(channels[i].samplesProduced, 2048u);
+				TS_ASSERT_EQUALS(channels[i].starvedCallbacks, 0u);
+			} else {
+				TS_ASSERT_EQUALS(channels[i].samplesProduced, 0u);
+				TS_ASSERT_EQUALS(channels[i].starvedCallbacks, 2u);
+			}
+		}
+
+		// The statistics are reset by the audio thread in the next callback
+		mixer.resetStats();
+		mixerImpl.mixCallback(buffer, sizeof(buffer));
+		mixer.getStats(stats, channels);
+		TS_ASSERT_EQUALS(stats.callbacks, 1u);
+		TS_ASSERT_EQUALS(stats.samplesRequested, 1024u);
+		TS_ASSERT_EQUALS(channels.size(), 2u);
+		for (uint i = 0; i < channels.size(); i++)
+			TS_ASSERT_EQUALS(channels[i].callbacks, 1u);
+
+		mixer.stopAll();
+	}
+
+	void test_streams_can_call_the_mixer() {
+		Common::install_null_g_system();
+
+		Audio::MixerKernels::accumulateFunc = Audio::MixerKernels::accumulateGeneric;
+		Audio::MixerKernels::clampFunc = Audio::MixerKernels::clampGeneric;
+
+		Audio::MixerImpl mixerImpl(22050);
+		mixerImpl.setReady(true);
+		Audio::Mixer &mixer = mixerImpl;
+
+		volatile uint32 alive = 0;
+		Audio::SoundHandle other, handle;
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &other, new CountedStream(&alive));
+		mixer.playStream(Audio::Mixer::kMusicSoundType, &handle, new ReentrantStream(&mixer, other));
+
+		// The audio thread can't wait for itself, so the stop only happens
+		// in the next callback. The stream is deleted by the next API call.
+		byte buffer[1024 * 4];
+		mixerImpl.mixCallback(buffer, sizeof(buffer));
+		TS_ASSERT(!mixer.isSoundHandleActive(other));
+		mixerImpl.mixCallback(buffer, sizeof(buffer));
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+		TS_ASSERT_EQUALS(alive, 0u);
+
+		mixer.stopAll();
+	}
+
+	void test_threaded_stop_is_synchronous() {
+#if THREADED_NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_threaded_null_g_system();
+
+		Audio::MixerKernels::accumulateFunc = Audio::MixerKernels::accumulateGeneric;
+		Audio::MixerKernels::clampFunc = Audio::MixerKernels::clampGeneric;
+
+		volatile uint32 alive = 0;
+		volatile uint32 stopped[500];
+		volatile uint32 lateReads = 0;
+		{
+			Audio::MixerImpl mixerImpl(22050);
+			mixerImpl.setReady(true);
+			Audio::Mixer &mixer = mixerImpl;
+
+			volatile uint32 done = 0;
+			Common::ThreadPool pool(1);
+			MixLoop loop = { &mixerImpl, &done };
+			Common::Future<void> audioThread = pool.submit(loop);
+
+			// Once a stop returns, the audio thread must be done with the
+			// stream, while other API calls carry on
+			for (int i = 0; i < 500; i++) {
+				stopped[i] = 0;
+
+				Audio::SoundHandle handle;
+				mixer.playStream(Audio::Mixer::kSFXSoundType, &handle, new CountedStream(&alive, &stopped[i], &lateReads), i);
+				mixer.setChannelVolume(handle, i & 0xFF);
+				if (i & 1)
+					mixer.stopHandle(handle);
+				else
+					mixer.stopID(i);
+				Common::atomicExchange(&stopped[i], 1);
+
+				Audio::Mixer::MixerStats stats;
+				Common::Array<Audio::Mixer::ChannelStats> channels;
+				mixer.getStats(stats, channels);
+				mixer.getElapsedTime(handle);
+			}
+
+			Common::atomicExchange(&done, 1);
+			audioThread.wait();
+		}
+		TS_ASSERT_EQUALS(lateReads, 0u);
+		TS_ASSERT_EQUALS(alive, 0u);
+#endif
+	}
+};
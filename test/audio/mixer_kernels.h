@@ -0,0 +1,86 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mixer_kernels.h"
+
+#include "../instrset_detect.h"
+
+class MixerKernelsTestSuite : public CxxTest::TestSuite {
+private:
+	typedef void(*AccumulateFunc)(int32 *, const int16 *, uint, Audio::st_volume_t, Audio::st_volume_t);
+	typedef void(*ClampFunc)(int16 *, const int32 *, uint);
+	typedef int32(*ConvolveFunc)(const int16 *, const int16 *, uint);
+
+	static void fillBlock(int16 *block, uint numSamples, uint seed) {
+		for (uint i = 0; i < numSamples; i++) {
+			seed = seed * 1103515245 + 12345;
+			block[i] = (int16)(seed >> 16);
+		}
+		// Make sure the extremes are covered, too
+		block[0] = -32768;
+		block[1] = 32767;
+	}
+
+	void checkKernels(AccumulateFunc accumulate, ClampFunc clamp, ConvolveFunc convolve) {
+		// Use an odd length so the scalar tails are exercised as well
+		const uint numFrames = 1029;
+		int16 block[numFrames * 2];
+		int32 expected[numFrames * 2], actual[numFrames * 2];
+		int16 expectedOut[numFrames * 2], actualOut[numFrames * 2];
+
+		memset(expected, 0, sizeof(expected));
+		memset(actual, 0, sizeof(actual));
+
+		static const Audio::st_volume_t volumes[][2] = {
+			{ 256, 256 }, { 255, 0 }, { 17, 200 }, { 1, 129 }, { 256, 256 }, { 256, 256 }
+		};
+
+		for (uint i = 0; i < ARRAYSIZE(volumes); i++) {
+			fillBlock(block, numFrames * 2, i);
+			Audio::MixerKernels::accumulateGeneric(expected, block, numFrames, volumes[i][0], volumes[i][1]);
+			accumulate(actual, block, numFrames, volumes[i][0], volumes[i][1]);
+		}
+		TS_ASSERT_EQUALS(memcmp(expected, actual, sizeof(expected)), 0);
+
+		Audio::MixerKernels::clampGeneric(expectedOut, expected, numFrames * 2);
+		clamp(actualOut, actual, numFrames * 2);
+		TS_ASSERT_EQUALS(memcmp(expectedOut, actualOut, sizeof(expectedOut)), 0);
+
+		int16 coefs[64];
+		fillBlock(coefs, ARRAYSIZE(coefs), 42);
+		for (uint taps = 16; taps <= ARRAYSIZE(coefs); taps += 16)
+			TS_ASSERT_EQUALS(convolve(block + 3, coefs, taps), Audio::MixerKernels::convolveGeneric(block + 3, coefs, taps));
+	}
+
+public:
+	void test_generic_matches_rate_converter_volume() {
+		int16 block[2] = { -32768, 1001 };
+		int32 acc[2] = { 0, 0 };
+		Audio::MixerKernels::accumulateGeneric(acc, block, 1, 100, 3);
+		TS_ASSERT_EQUALS(acc[0], (-32768 * 100) / 256);
+		TS_ASSERT_EQUALS(acc[1], (1001 * 3) / 256);
+	}
+
+	void test_clamp_saturates() {
+		int32 acc[4] = { 40000, -40000, 32767, -32768 };
+		int16 out[4];
+		Audio::MixerKernels::clampGeneric(out, acc, 4);
+		TS_ASSERT_EQUALS(out[0], 32767);
+		TS_ASSERT_EQUALS(out[1], -32768);
+		TS_ASSERT_EQUALS(out[2], 32767);
+		TS_ASSERT_EQUALS(out[3], -32768);
+	}
+
+	void test_simd_kernels() {
+#ifdef SCUMMVM_NEON
+		checkKernels(Audio::MixerKernels::accumulateNEON, Audio::MixerKernels::clampNEON, Audio::MixerKernels::convolveNEON);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			checkKernels(Audio::MixerKernels::accumulateSSE2, Audio::MixerKernels::clampSSE2, Audio::MixerKernels::convolveSSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			checkKernels(Audio::MixerKernels::accumulateAVX2, Audio::MixerKernels::clampAVX2, Audio::MixerKernels::convolveAVX2);
+#endif
+	}
+};
@@ -0,0 +1,164 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/decoders/raw.h"
+#include "audio/audiostream.h"
+#include "audio/mixer_kernels.h"
+#include "audio/rate.h"
+#include "audio/rate_polyphase.h"
+
+#include "common/memstream.h"
+
+#include "../null_osystem.h"
+
+#include <math.h>
+
+class PolyphaseRateConverterTestSuite : public CxxTest::TestSuite {
+private:
+	static Audio::SeekableAudioStream *createToneStream(int rate, int frequency, int numSamples, double amplitude) {
+		int16 *tone = (int16 *)malloc(numSamples * sizeof(int16));
+		for (int i = 0; i < numSamples; i++)
+			WRITE_LE_UINT16(&tone[i], (int16)floor(sin(2.0 * M_PI * frequency * i / rate) * amplitude + 0.5));
+
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream((const byte *)tone, numSamples * sizeof(int16), DisposeAfterUse::YES);
+		return Audio::makeRawStream(stream, rate, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN);
+	}
+
+	void checkTone(int inRate, int outRate, int frequency) {
+		// The null OSystem cannot report CPU features
+		Audio::MixerKernels::convolveFunc = Audio::MixerKernels::convolveGeneric;
+
+		const double amplitude = 16384.0;
+		const int inSamples = inRate / 4;
+		const int outSamples = (int)((int64)inSamples * outRate / inRate);
+
+		Audio::SeekableAudioStream *stream = createToneStream(inRate, frequency, inSamples, amplitude);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, false, true, false, Audio::Mixer::kResamplerPolyphase);
+
+		int16 *out = new int16[outSamples * 2];
+		const int converted = converter->convertBlock(*stream, out, outSamples);
+		TS_ASSERT_LESS_THAN_EQUALS(outSamples - 64, converted);
+
+		// Compare against the ideal tone, away from the edges of the input
+		double maxError = 0.0;
+		for (int i = 64; i < converted - 64; i++) {
+			const double expected = sin(2.0 * M_PI * frequency * i / outRate) * amplitude;
+			maxError = MAX(maxError, fabs(out[i * 2] - expected));
+			TS_ASSERT_EQUALS(out[i * 2], out[i * 2 + 1]);
+		}
+		TS_ASSERT_LESS_THAN(maxError, amplitude * 0.01);
+
+		delete[] out;
+		delete converter;
+		delete stream;
+	}
+
+public:
+	void test_upsample_tone() {
+		Common::install_null_g_system();
+
+		checkTone(11025, 44100, 440);
+		checkTone(22050, 48000, 1000);
+	}
+
+	void test_downsample_tone() {
+		Common::install_null_g_system();
+
+		checkTone(48000, 22050, 440);
+	}
+
+	void test_end_of_stream_is_flushed() {
+		Common::install_null_g_system();
+		Audio::MixerKernels::convolveFunc = Audio::MixerKernels::convolveGeneric;
+
+		const int inSamples = 11025;
+		Audio::SeekableAudioStream *stream = createToneStream(11025, 440, inSamples, 16384.0);
+		Audio::RateConverter *converter = Audio::makeRateConverter(11025, 44100, false, true, false, Audio::Mixer::kResamplerPolyphase);
+
+		// Ask for more than the stream holds; everything up to the frame
+		// centered on the last input frame must come out
+		const int maxSamples = inSamples * 4 + 1024;
+		int16 *out = new int16[maxSamples * 2];
+		const int converted = converter->convertBlock(*stream, out, maxSamples);
+		TS_ASSERT_LESS_THAN_EQUALS((inSamples - 1) * 4 + 1, converted);
+		TS_ASSERT_LESS_THAN_EQUALS(converted, inSamples * 4);
+		TS_ASSERT(!converter->needsDraining());
+
+		// The tone is still there right before the end
+		int peak = 0;
+		for (int i = converted - 40; i < converted; i++)
+			peak = MAX<int>(peak, ABS<int>(out[i * 2]));
+		TS_ASSERT_LESS_THAN(8192, peak);
+
+		delete[] out;
+		delete converter;
+		delete stream;
+	}
+
+	void test_filter_cache_is_shared() {
+		Common::install_null_g_system();
+
+		Audio::PolyphaseFilterCache &cache = Audio::PolyphaseFilterCache::instance();
+		const Audio::PolyphaseFilter *a = cache.acquire(22050, 44100);
+		const Audio::PolyphaseFilter *b = cache.acquire(22050, 44100);
+		const Audio::PolyphaseFilter *c = cache.acquire(11025, 44100);
+		TS_ASSERT_EQUALS(a, b);
+		TS_ASSERT_DIFFERS(a, c);
+		TS_ASSERT_EQUALS(a->refCount, 2);
+		TS_ASSERT_EQUALS(a->phases, 2u);
+
+		// Every phase has unity gain
+		for (uint phase = 0; phase < c->phases; phase++) {
+			int sum = 0;
+			for (uint i = 0; i < c->taps; i++)
+				sum += c->coefs[phase * c->taps + i];
+			TS_ASSERT_EQUALS(sum, 1 << 14);
+		}
+
+		cache.release(a);
+		cache.release(b);
+		cache.release(c);
+		TS_ASSERT_EQUALS(a->refCount, 0);
+	}
+
+	void test_threaded_filter_is_computed_in_background() {
+#if THREADED_NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_threaded_null_g_system();
+		Audio::MixerKernels::convolveFunc = Audio::MixerKernels::convolveGeneric;
+
+		// Start over with a cache which has a worker thread
+		Audio::PolyphaseFilterCache::destroy();
+		Audio::PolyphaseFilterCache &cache = Audio::PolyphaseFilterCache::instance();
+
+		// Until the filter bank is there, the converter interpolates linearly,
+		// so the output is complete and close to the tone
+		const double amplitude = 16384.0;
+		const int inSamples = 8000 / 4;
+		const int outSamples = (int)((int64)inSamples * 44100 / 8000);
+		Audio::SeekableAudioStream *stream = createToneStream(8000, 200, inSamples, amplitude);
+		Audio::RateConverter *converter = Audio::makeRateConverter(8000, 44100, false, true, false, Audio::Mixer::kResamplerPolyphase);
+
+		int16 *out = new int16[outSamples * 2];
+		const int converted = converter->convertBlock(*stream, out, 256);
+		TS_ASSERT_EQUALS(converted, 256);
+		for (int i = 64; i < converted; i++) {
+			const double expected = sin(2.0 * M_PI * 200 * i / 44100) * amplitude;
+			TS_ASSERT_LESS_THAN(fabs(out[i * 2] - expected), amplitude * 0.05);
+		}
+
+		const Audio::PolyphaseFilter *filter = nullptr;
+		for (int i = 0; i < 1000 && !filter; i++) {
+			filter = cache.acquire(8000, 44100);
+			if (!filter)
+				g_system->delayMillis(1);
+		}
+		TS_ASSERT(filter);
+		cache.release(filter);
+
+		delete[] out;
+		delete converter;
+		delete stream;
+
+		Audio::PolyphaseFilterCache::destroy();
+#endif
+	}
+};
@@ -0,0 +1,93 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/ptr.h"
+#include "common/stream.h"
+
+#include "../null_osystem.h"
+
+class ArchiveContentsCacheTestSuite : public CxxTest::TestSuite {
+private:
+	// Every member is 1000 bytes filled with the first letter of its name
+	class CountingArchive : public Common::MemcachingCaseInsensitiveArchive {
+	public:
+		mutable int reads;
+
+		CountingArchive() : reads(0) {}
+
+		bool hasFile(const Common::Path &path) const override { return true; }
+		int listMembers(Common::ArchiveMemberList &list) const override { return 0; }
+		const Common::ArchiveMemberPtr getMember(const Common::Path &path) const override { return Common::ArchiveMemberPtr(); }
+
+		Common::SharedArchiveContents readContentsForPath(const Common::Path &translatedPath) const override {
+			reads++;
+			byte *data = new byte[1000];
+			memset(data, translatedPath.toString()[0], 1000);
+			return Common::SharedArchiveContents(data, 1000);
+		}
+	};
+
+	static bool openAndCheck(const Common::Archive &archive, const char *name) {
+		Common::ScopedPtr<Common::SeekableReadStream> stream(archive.createReadStreamForMember(name));
+		return stream && stream->size() == 1000 && stream->readByte() == name[0];
+	}
+
+public:
+	void test_reopened_members_stay_cached() {
+		Common::install_null_g_system();
+		Common::MemcachingCaseInsensitiveArchive::setCacheBudget(4000);
+
+		CountingArchive archive;
+		TS_ASSERT(openAndCheck(archive, "a"));
+		TS_ASSERT(openAndCheck(archive, "a"));
+		TS_ASSERT(openAndCheck(archive, "b"));
+		TS_ASSERT(openAndCheck(archive, "a"));
+		TS_ASSERT_EQUALS(archive.reads, 2);
+	}
+
+	void test_least_recently_used_members_are_evicted() {
+		Common::install_null_g_system();
+		Common::MemcachingCaseInsensitiveArchive::setCacheBudget(3000);
+
+		CountingArchive archive;
+		TS_ASSERT(openAndCheck(archive, "a"));
+		TS_ASSERT(openAndCheck(archive, "b"));
+		TS_ASSERT(openAndCheck(archive, "c"));
+		// Touching a makes b the least recently used member
+		TS_ASSERT(openAndCheck(archive, "a"));
+		TS_ASSERT(openAndCheck(archive, "d"));
+		TS_ASSERT_EQUALS(archive.reads, 4);
+
+		TS_ASSERT(openAndCheck(archive, "a"));
+		TS_ASSERT(openAndCheck(archive, "c"));
+		TS_ASSERT(openAndCheck(archive, "d"));
+		TS_ASSERT_EQUALS(archive.reads, 4);
+
+		TS_ASSERT(openAndCheck(archive, "b"));
+		TS_ASSERT_EQUALS(archive.reads, 5);
+
+		// Shrinking the budget drops contents once their archive is used
+		Common::MemcachingCaseInsensitiveArchive::setCacheBudget(0);
+		TS_ASSERT(openAndCheck(archive, "b"));
+		TS_ASSERT(openAndCheck(archive, "c"));
+		TS_ASSERT_EQUALS(archive.reads, 6);
+	}
+
+	void test_contents_are_released_by_their_archive() {
+		Common::install_null_g_system();
+		Common::MemcachingCaseInsensitiveArchive::setCacheBudget(2000);
+
+		CountingArchive first, second;
+		TS_ASSERT(openAndCheck(first, "a"));
+		TS_ASSERT(openAndCheck(first, "b"));
+		// Evicts a, which is only released by the next use of first
+		TS_ASSERT(openAndCheck(second, "c"));
+		TS_ASSERT(openAndCheck(first, "b"));
+		TS_ASSERT_EQUALS(first.reads, 2);
+
+		TS_ASSERT(openAndCheck(first, "a"));
+		TS_ASSERT_EQUALS(first.reads, 3);
+		TS_ASSERT(openAndCheck(second, "c"));
+		TS_ASSERT_EQUALS(second.reads, 1);
+	}
+};
@@ -0,0 +1,232 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/atomic.h"
+#include "common/system.h"
+#include "common/threadpool.h"
+
+#include "../null_osystem.h"
+
+class ThreadPoolTestSuite : public CxxTest::TestSuite {
+private:
+	struct Square {
+		int value;
+		Square(int v) : value(v) {}
+		int operator()() const { return value * value; }
+	};
+
+	struct Mark {
+		Common::Array<uint32> &marks;
+		Mark(Common::Array<uint32> &m) : marks(m) {}
+		void operator()(int i) const { Common::atomicFetchAdd(&marks[i], 1); }
+	};
+
+	struct Count {
+		volatile uint32 *counter;
+		Count(volatile uint32 *c) : counter(c) {}
+		void operator()() const { Common::atomicFetchAdd(counter, 1); }
+	};
+
+	// Blocks until the flag is set
+	struct Gate {
+		volatile uint32 *open;
+		Gate(volatile uint32 *o) : open(o) {}
+		void operator()() const {
+			while (!Common::atomicLoadAcquire(open))
+				g_system->delayMillis(1);
+		}
+	};
+
+	// Only returns once the given number of tasks are running at once, or
+	// after a timeout
+	struct Rendezvous {
+		volatile uint32 *arrived;
+		uint32 count;
+		Rendezvous(volatile uint32 *a, uint32 c) : arrived(a), count(c) {}
+		bool operator()() const {
+			Common::atomicFetchAdd(arrived, 1);
+			const uint32 start = g_system->getMillis();
+			while (Common::atomicLoadAcquire(arrived) < count) {
+				if (g_system->getMillis() - start > 10000)
+					return false;
+				g_system->delayMillis(1);
+			}
+			return true;
+		}
+	};
+
+	// Submits and waits for further tasks from inside a task
+	struct Nested {
+		Common::ThreadPool *pool;
+		Nested(Common::ThreadPool *p) : pool(p) {}
+		int operator()() const {
+			Common::Future<int> a = pool->submit(Square(3));
+			Common::Future<int> b = pool->submit(Square(4));
+			return a.get() + b.get();
+		}
+	};
+
+	void checkFutures() {
+		Common::ThreadPool pool;
+
+		Common::Array<Common::Future<int> > futures;
+		for (int i = 0; i < 100; i++)
+			futures.push_back(pool.submit(Square(i)));
+		for (int i = 0; i < 100; i++)
+			TS_ASSERT_EQUALS(futures[i].get(), i * i);
+
+		Common::Future<int> nested = pool.submit(Nested(&pool));
+		TS_ASSERT_EQUALS(nested.get(), 25);
+
+		volatile uint32 counter = 0;
+		Common::Future<void> done = pool.submit(Count(&counter));
+		done.wait();
+		TS_ASSERT(done.isReady());
+		TS_ASSERT_EQUALS(counter, 1u);
+
+		Common::Future<void> empty;
+		TS_ASSERT(!empty.isValid());
+		TS_ASSERT(empty.isReady());
+	}
+
+	void checkParallelFor() {
+		Common::ThreadPool pool;
+
+		const int sizes[] = { 0, 1, 7, 1000 };
+		for (uint i = 0; i < ARRAYSIZE(sizes); i++) {
+			Common::Array<uint32> marks(sizes[i] + 20, 0);
+			pool.parallelFor(10, 10 + sizes[i], Mark(marks), 3);
+
+			bool ok = true;
+			for (int j = 0; j < (int)marks.size(); j++)
+				ok = ok && marks[j] == ((j >= 10 && j < 10 + sizes[i]) ? 1u : 0u);
+			TS_ASSERT(ok);
+		}
+	}
+
+	void checkQueuedTasksFinishBeforeDestruction() {
+		volatile uint32 counter = 0;
+		{
+			Common::ThreadPool pool(2);
+			for (int i = 0; i < 50; i++)
+				pool.submit(Count(&counter));
+		}
+		TS_ASSERT_EQUALS(counter, 50u);
+	}
+
+public:
+	void test_atomics() {
+		volatile uint32 value = 5;
+		TS_ASSERT_EQUALS(Common::atomicFetchAdd(&value, 3), 5u);
+		TS_ASSERT_EQUALS(Common::atomicLoadAcquire(&value), 8u);
+		TS_ASSERT_EQUALS(Common::atomicFetchAdd(&value, (uint32)-1), 8u);
+		TS_ASSERT_EQUALS(Common::atomicExchange(&value, 42), 7u);
+		TS_ASSERT(!Common::atomicCompareExchange(&value, 41, 1));
+		TS_ASSERT(Common::atomicCompareExchange(&value, 42, 1));
+		TS_ASSERT_EQUALS(value, 1u);
+	}
+
+	// The plain null OSystem has no threads, so these only cover the
+	// synchronous fallback, where tasks run as soon as they are submitted
+	void test_futures() {
+		Common::install_null_g_system();
+		checkFutures();
+	}
+
+	void test_parallel_for() {
+		Common::install_null_g_system();
+		checkParallelFor();
+	}
+
+	void test_queued_tasks_finish_before_destruction() {
+		Common::install_null_g_system();
+		checkQueuedTasksFinishBeforeDestruction();
+	}
+
+	void test_no_workers_without_threads() {
+		Common::install_null_g_system();
+		Common::ThreadPool pool(4);
+		TS_ASSERT_EQUALS(pool.getThreadCount(), 0u);
+	}
+
+	// The same, on worker threads
+	void test_threaded_futures() {
+#if THREADED_NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_threaded_null_g_system();
+		checkFutures();
+#endif
+	}
+
+	void test_threaded_parallel_for() {
+#if THREADED_NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_threaded_null_g_system();
+		checkParallelFor();
+#endif
+	}
+
+	void test_threaded_queued_tasks_finish_before_destruction() {
+#if THREADED_NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_threaded_null_g_system();
+		checkQueuedTasksFinishBeforeDestruction();
+#endif
+	}
+
+	void test_threaded_wait_blocks() {
+#if THREADED_NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_threaded_null_g_system();
+		Common::ThreadPool pool(2);
+		TS_ASSERT_EQUALS(pool.getThreadCount(), 2u);
+
+		// The task can only finish once this thread opens the gate, so it
+		// can't have run synchronously, and it is only done after a worker
+		// has woken up for it
+		volatile uint32 open = 0;
+		Common::Future<void> gate = pool.submit(Gate(&open));
+		g_system->delayMillis(5);
+		TS_ASSERT(!gate.isReady());
+
+		Common::atomicExchange(&open, 1);
+		gate.wait();
+		TS_ASSERT(gate.isReady());
+#endif
+	}
+
+	void test_threaded_tasks_run_concurrently() {
+#if THREADED_NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_threaded_null_g_system();
+		Common::ThreadPool pool(3);
+		TS_ASSERT_EQUALS(pool.getThreadCount(), 3u);
+
+		// Every task waits for all the others to start, which only works if
+		// the workers wake up and run them at the same time
+		volatile uint32 arrived = 0;
+		Common::Array<Common::Future<bool> > futures;
+		for (int i = 0; i < 3; i++)
+			futures.push_back(pool.submit(Rendezvous(&arrived, 3)));
+		for (int i = 0; i < 3; i++)
+			TS_ASSERT(futures[i].get());
+#endif
+	}
+
+	void test_threaded_shutdown_with_busy_workers() {
+#if THREADED_NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_threaded_null_g_system();
+
+		volatile uint32 open = 0;
+		volatile uint32 counter = 0;
+		{
+			Common::ThreadPool pool(2);
+			pool.submit(Gate(&open));
+			pool.submit(Gate(&open));
+			for (int i = 0; i < 20; i++)
+				pool.submit(Count(&counter));
+
+			// Both workers are blocked, so the counting tasks stay queued
+			// until the gate opens, and the destructor has to wait for them
+			g_system->delayMillis(5);
+			TS_ASSERT_EQUALS(Common::atomicLoadAcquire(&counter), 0u);
+			Common::atomicExchange(&open, 1);
+		}
+		TS_ASSERT_EQUALS(counter, 20u);
+#endif
+	}
+};
@@ -0,0 +1,136 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/system.h"
+#include "backends/timer/default/default-timer.h"
+
+#include "../null_osystem.h"
+
+class TimerManagerTestSuite : public CxxTest::TestSuite {
+private:
+	struct Counter {
+		DefaultTimerManager *manager;
+		uint32 calls;
+		uint32 sleep;
+		bool removeSelf;
+
+		Counter() : manager(nullptr), calls(0), sleep(0), removeSelf(false) {}
+	};
+
+	// Every installed timer needs its own callback
+	template<int N>
+	static void countProc(void *refCon) {
+		Counter *counter = (Counter *)refCon;
+		counter->calls++;
+
+		if (counter->sleep)
+			g_system->delayMillis(counter->sleep);
+		if (counter->removeSelf)
+			counter->manager->removeTimerProc(&countProc<N>);
+	}
+
+	// Call the handler every millisecond for the given time, and return the
+	// time passed since start. The tests use a manual clock, so this doesn't
+	// depend on the load of the machine.
+	static uint32 runTimers(DefaultTimerManager &manager, uint32 start, uint32 duration) {
+		while (g_system->getMillis(true) - start < duration) {
+			manager.handler();
+			g_system->delayMillis(1);
+		}
+		manager.handler();
+
+		return g_system->getMillis(true) - start;
+	}
+
+public:
+	void test_schedule() {
+		Common::install_manual_clock_null_g_system();
+		DefaultTimerManager manager;
+
+		static const int32 intervals[] = { 10000, 2500, 7000, 1000, 4000 };
+		Counter counters[ARRAYSIZE(intervals)];
+
+		const uint32 start = g_system->getMillis(true);
+		manager.installTimerProc(&countProc<0>, intervals[0], &counters[0], "timer0");
+		manager.installTimerProc(&countProc<1>, intervals[1], &counters[1], "timer1");
+		manager.installTimerProc(&countProc<2>, intervals[2], &counters[2], "timer2");
+		manager.installTimerProc(&countProc<3>, intervals[3], &counters[3], "timer3");
+		manager.installTimerProc(&countProc<4>, intervals[4], &counters[4], "timer4");
+
+		const uint32 elapsed = runTimers(manager, start, 60);
+
+		// Overdue timers are all caught up by the last call of the handler
+		for (uint i = 0; i < ARRAYSIZE(intervals); i++) {
+			const int32 expected = elapsed * 1000 / intervals[i];
+			TS_ASSERT_LESS_THAN_EQUALS(expected - 2, (int32)counters[i].calls);
+			TS_ASSERT_LESS_THAN_EQUALS((int32)counters[i].calls, expected + 1);
+		}
+
+		Common::Array<Common::TimerManager::TimerStats> stats;
+		manager.getStats(stats);
+		TS_ASSERT_EQUALS(stats.size(), ARRAYSIZE(intervals));
+
+		// The handler runs every millisecond, and the callbacks take no time
+		for (uint i = 0; i < stats.size(); i++) {
+			const int index = stats[i].id.lastChar() - '0';
+			TS_ASSERT_EQUALS(stats[i].interval, intervals[index]);
+			TS_ASSERT_EQUALS(stats[i].calls, counters[index].calls);
+			TS_ASSERT_LESS_THAN_EQUALS(stats[i].maxJitter, 1000u);
+			TS_ASSERT_EQUALS(stats[i].missedDeadlines, 0u);
+			TS_ASSERT_EQUALS(stats[i].overruns, 0u);
+		}
+
+		manager.removeTimerProc(&countProc<3>);
+		manager.getStats(stats);
+		TS_ASSERT_EQUALS(stats.size(), ARRAYSIZE(intervals) - 1);
+		for (uint i = 0; i < stats.size(); i++)
+			TS_ASSERT_DIFFERS(stats[i].id, "timer3");
+	}
+
+	void test_overrun() {
+		Common::install_manual_clock_null_g_system();
+		DefaultTimerManager manager;
+
+		Counter counter;
+		counter.sleep = 3;
+
+		const uint32 start = g_system->getMillis(true);
+		manager.installTimerProc(&countProc<0>, 1000, &counter, "slow");
+		runTimers(manager, start, 20);
+
+		Common::Array<Common::TimerManager::TimerStats> stats;
+		manager.getStats(stats);
+		TS_ASSERT_EQUALS(stats.size(), 1u);
+		TS_ASSERT_EQUALS(stats[0].calls, counter.calls);
+		TS_ASSERT_EQUALS(stats[0].overruns, counter.calls);
+		TS_ASSERT_EQUALS(stats[0].maxCallbackTime, 3000u);
+		TS_ASSERT_LESS_THAN_EQUALS(1u, stats[0].missedDeadlines);
+
+		manager.resetStats();
+		manager.getStats(stats);
+		TS_ASSERT_EQUALS(stats[0].calls, 0u);
+		TS_ASSERT_EQUALS(stats[0].overruns, 0u);
+		TS_ASSERT_EQUALS(stats[0].id, "slow");
+	}
+
+	void test_remove_from_callback() {
+		Common::install_manual_clock_null_g_system();
+		DefaultTimerManager manager;
+
+		Counter counters[2];
+		counters[0].manager = &manager;
+		counters[0].removeSelf = true;
+
+		const uint32 start = g_system->getMillis(true);
+		manager.installTimerProc(&countProc<0>, 1000, &counters[0], "once");
+		manager.installTimerProc(&countProc<1>, 1000, &counters[1], "repeated");
+		runTimers(manager, start, 10);
+
+		TS_ASSERT_EQUALS(counters[0].calls, 1u);
+		TS_ASSERT_LESS_THAN_EQUALS(5u, counters[1].calls);
+
+		Common::Array<Common::TimerManager::TimerStats> stats;
+		manager.getStats(stats);
+		TS_ASSERT_EQUALS(stats.size(), 1u);
+		TS_ASSERT_EQUALS(stats[0].id, "repeated");
+	}
+};
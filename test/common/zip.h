@@ -0,0 +1,264 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/crc.h"
+#include "common/compression/deflate.h"
+#include "common/compression/unzip.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
+#include "common/str.h"
+
+#include "../null_osystem.h"
+
+class ZipArchiveTestSuite : public CxxTest::TestSuite {
+private:
+	enum {
+		kStored = 0,
+		kDeflated = 8
+	};
+
+	struct Member {
+		const char *name;
+		uint16 method;
+		uint32 crc;
+		uint32 size;
+		uint32 offset;
+		Common::Array<byte> data;
+	};
+
+	// Large enough to be streamed, compressible but not trivially so
+	static void fillData(Common::Array<byte> &data, uint32 size) {
+		static const char *const words[] = { "lorem ", "ipsum ", "dolor ", "sit ", "amet, ", "consectetur\n" };
+		uint32 seed = 12345;
+
+		data.resize(size);
+		for (uint32 i = 0; i < size; ) {
+			seed = seed * 1103515245 + 12345;
+			const char *word = words[(seed >> 16) % ARRAYSIZE(words)];
+			for (; *word && i < size; word++, i++)
+				data[i] = *word ^ ((seed >> 8) & 1);
+		}
+	}
+
+	static void writeMember(Common::MemoryWriteStreamDynamic &zip, Member &member, const Common::Array<byte> &contents) {
+		member.offset = zip.pos();
+		member.size = contents.size();
+		member.crc = Common::CRC32().crcFast(contents.data(), contents.size());
+		member.data = contents;
+
+		if (member.method == kDeflated) {
+			Common::MemoryWriteStreamDynamic *gzip = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::YES);
+			Common::ScopedPtr<Common::WriteStream> compressor(Common::wrapCompressedWriteStream(gzip));
+			compressor->write(contents.data(), contents.size());
+			compressor->finalize();
+
+			// Strip the gzip header and trailer off the deflated data.
+			// Without zlib, the data stays uncompressed.
+			if (gzip->size() > 18 && gzip->getData()[0] == 0x1F && gzip->getData()[1] == 0x8B)
+				member.data = Common::Array<byte>(gzip->getData() + 10, gzip->size() - 18);
+			else
+				member.method = kStored;
+		}
+
+		zip.writeUint32LE(0x04034b50);
+		zip.writeUint16LE(20);
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(member.method);
+		zip.writeUint32LE(0);
+		zip.writeUint32LE(member.crc);
+		zip.writeUint32LE(member.data.size());
+		zip.writeUint32LE(member.size);
+		zip.writeUint16LE(strlen(member.name));
+		zip.writeUint16LE(0);
+		zip.writeString(member.name);
+		zip.write(member.data.data(), member.data.size());
+	}
+
+	static void writeCentralDirectory(Common::MemoryWriteStreamDynamic &zip, const Member *members, uint count) {
+		const uint32 start = zip.pos();
+		for (uint i = 0; i < count; i++) {
+			zip.writeUint32LE(0x02014b50);
+			zip.writeUint16LE(20);
+			zip.writeUint16LE(20);
+			zip.writeUint16LE(0);
+			zip.writeUint16LE(members[i].method);
+			zip.writeUint32LE(0);
+			zip.writeUint32LE(members[i].crc);
+			zip.writeUint32LE(members[i].data.size());
+			zip.writeUint32LE(members[i].size);
+			zip.writeUint16LE(strlen(members[i].name));
+			zip.writeUint16LE(0);
+			zip.writeUint16LE(0);
+			zip.writeUint16LE(0);
+			zip.writeUint16LE(0);
+			zip.writeUint32LE(0);
+			zip.writeUint32LE(members[i].offset);
+			zip.writeString(members[i].name);
+		}
+		const uint32 end = zip.pos();
+
+		zip.writeUint32LE(0x06054b50);
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(count);
+		zip.writeUint16LE(count);
+		zip.writeUint32LE(end - start);
+		zip.writeUint32LE(start);
+		zip.writeUint16LE(0);
+	}
+
+	static bool checkRange(Common::SeekableReadStream &stream, const Common::Array<byte> &expected, uint32 pos, uint32 len) {
+		Common::Array<byte> buffer(len);
+		if (!stream.seek(pos) || stream.read(buffer.data(), len) != len)
+			return false;
+		return !memcmp(buffer.data(), expected.data() + pos, len);
+	}
+
+public:
+	void test_streamed_members() {
+		Common::install_null_g_system();
+
+		Common::Array<byte> small, large;
+		fillData(small, 1000);
+		fillData(large, 6 * 1024 * 1024 + 123);
+
+		Member members[3] = {
+			{ "small.txt", kDeflated, 0, 0, 0, Common::Array<byte>() },
+			{ "large.bin", kDeflated, 0, 0, 0, Common::Array<byte>() },
+			{ "stored.bin", kStored, 0, 0, 0, Common::Array<byte>() }
+		};
+
+		Common::MemoryWriteStreamDynamic zip(DisposeAfterUse::NO);
+		writeMember(zip, members[0], small);
+		writeMember(zip, members[1], large);
+		writeMember(zip, members[2], large);
+		writeCentralDirectory(zip, members, ARRAYSIZE(members));
+
+		Common::ScopedPtr<Common::Archive> archive(Common::makeZipArchive(new Common::MemoryReadStream(zip.getData(), zip.size(), DisposeAfterUse::YES)));
+		TS_ASSERT(archive);
+		if (!archive)
+			return;
+
+		Common::ScopedPtr<Common::SeekableReadStream> stream(archive->createReadStreamForMember("small.txt"));
+		TS_ASSERT(stream);
+		TS_ASSERT_EQUALS(stream->size(), 1000);
+		TS_ASSERT(checkRange(*stream, small, 0, 1000));
+
+		const char *const largeNames[] = { "large.bin", "stored.bin" };
+		for (uint i = 0; i < ARRAYSIZE(largeNames); i++) {
+			stream.reset(archive->createReadStreamForMember(largeNames[i]));
+			TS_ASSERT(stream);
+			TS_ASSERT_EQUALS(stream->size(), (int64)large.size());
+
+			// Sequential read through the whole member
+			Common::Array<byte> buffer(large.size());
+			TS_ASSERT_EQUALS(stream->read(buffer.data(), buffer.size()), large.size());
+			TS_ASSERT(!memcmp(buffer.data(), large.data(), large.size()));
+			TS_ASSERT(!stream->err());
+
+			// Backward seeks, within the window and across checkpoints
+			TS_ASSERT(checkRange(*stream, large, large.size() - 100, 100));
+			TS_ASSERT(checkRange(*stream, large, large.size() - 20000, 5000));
+			TS_ASSERT(checkRange(*stream, large, 3 * 1024 * 1024 + 77, 70000));
+			TS_ASSERT(checkRange(*stream, large, 10, 100));
+			// Forward seeks past data which has been inflated before
+			TS_ASSERT(checkRange(*stream, large, 5 * 1024 * 1024 + 5, 1000));
+			TS_ASSERT(checkRange(*stream, large, 1024 * 1024 - 10, 20));
+
+			// Reading past the end
+			TS_ASSERT(stream->seek(-10, SEEK_END));
+			TS_ASSERT_EQUALS(stream->read(buffer.data(), 100), 10u);
+			TS_ASSERT(stream->eos());
+		}
+
+		// Several streams of the same archive may be used at once
+		Common::ScopedPtr<Common::SeekableReadStream> other(archive->createReadStreamForMember("large.bin"));
+		TS_ASSERT(checkRange(*stream, large, 4000000, 100));
+		TS_ASSERT(checkRange(*other, large, 100, 4000000));
+		TS_ASSERT(checkRange(*stream, large, 4000100, 100));
+
+		// Streamed members stay readable after the archive has been deleted
+		archive.reset();
+		TS_ASSERT(checkRange(*stream, large, 5000000, 1000));
+		TS_ASSERT(checkRange(*other, large, 200, 1000));
+	}
+
+	void test_streamed_member_crc() {
+#ifdef USE_ZLIB
+		Common::install_null_g_system();
+
+		// Hardly compressible, so inflating stops wherever the compressed
+		// data has to be refilled, which differs after a backward seek
+		Common::Array<byte> large(5 * 1024 * 1024 + 5);
+		uint32 seed = 54321;
+		for (uint32 i = 0; i < large.size(); i++) {
+			seed = seed * 1103515245 + 12345;
+			large[i] = seed >> 16;
+		}
+
+		for (int corrupt = 0; corrupt < 2; corrupt++) {
+			Member members[1] = {
+				{ "large.bin", kDeflated, 0, 0, 0, Common::Array<byte>() }
+			};
+
+			Common::MemoryWriteStreamDynamic zip(DisposeAfterUse::NO);
+			writeMember(zip, members[0], large);
+			if (corrupt) {
+				// Both the local header and the central directory hold the CRC
+				members[0].crc ^= 1;
+				WRITE_LE_UINT32(zip.getData() + members[0].offset + 14, members[0].crc);
+			}
+			writeCentralDirectory(zip, members, ARRAYSIZE(members));
+
+			Common::ScopedPtr<Common::Archive> archive(Common::makeZipArchive(new Common::MemoryReadStream(zip.getData(), zip.size(), DisposeAfterUse::YES)));
+			TS_ASSERT(archive);
+			if (!archive)
+				return;
+
+			Common::ScopedPtr<Common::SeekableReadStream> stream(archive->createReadStreamForMember("large.bin"));
+			TS_ASSERT(stream);
+			if (!stream)
+				return;
+
+			// Inflating resumes from a checkpoint after the backward seek,
+			// and the rest of the member still has to be checksummed
+			Common::Array<byte> buffer(3100000);
+			TS_ASSERT_EQUALS(stream->read(buffer.data(), buffer.size()), buffer.size());
+			TS_ASSERT(stream->seek(2 * 1024 * 1024 + 100000));
+			while (!stream->eos() && !stream->err())
+				stream->read(buffer.data(), 4093);
+			TS_ASSERT_EQUALS(stream->err(), corrupt != 0);
+		}
+#endif
+	}
+
+	void test_member_checksum() {
+		Common::install_null_g_system();
+
+		Common::Array<byte> data;
+		fillData(data, 5000);
+
+		Member members[1] = {
+			{ "icons/icon.png", kDeflated, 0, 0, 0, Common::Array<byte>() }
+		};
+
+		Common::MemoryWriteStreamDynamic zip(DisposeAfterUse::NO);
+		writeMember(zip, members[0], data);
+		writeCentralDirectory(zip, members, ARRAYSIZE(members));
+
+		Common::ScopedPtr<Common::Archive> archive(Common::makeZipArchive(new Common::MemoryReadStream(zip.getData(), zip.size(), DisposeAfterUse::YES)));
+		TS_ASSERT(archive);
+		if (!archive)
+			return;
+
+		uint32 size = 0, crc = 0;
+		TS_ASSERT(Common::getZipMemberChecksum(*archive, "icons/ICON.png", size, crc));
+		TS_ASSERT_EQUALS(size, 5000u);
+		TS_ASSERT_EQUALS(crc, Common::CRC32().crcFast(data.data(), data.size()));
+		TS_ASSERT(!Common::getZipMemberChecksum(*archive, "icons/missing.png", size, crc));
+
+		// Only ZIP archives provide checksums
+		Common::SearchSet set;
+		TS_ASSERT(!Common::getZipMemberChecksum(set, "icons/icon.png", size, crc));
+	}
+};
@@ -0,0 +1,97 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/file.h"
+#include "common/system.h"
+#include "engines/detectionCache.h"
+
+#include "../null_osystem.h"
+
+// The files are written to the directory the tests are run from
+#define DETECTION_CACHE_TEST_FILE "test-detection-cache.dat"
+#define DETECTION_CACHE_TEST_GAME_FILE "test-detection-cache.bin"
+
+class DetectionCacheTestSuite : public CxxTest::TestSuite {
+private:
+	static bool writeFile(const char *name, const char *contents) {
+		Common::DumpFile file;
+		if (!file.open(Common::FSNode(Common::Path(name))))
+			return false;
+
+		file.writeString(contents);
+		file.finalize();
+		return true;
+	}
+
+public:
+	void setUp() {
+		Common::install_null_g_system();
+	}
+
+	void test_round_trip() {
+		TS_ASSERT(writeFile(DETECTION_CACHE_TEST_FILE, ""));
+		TS_ASSERT(writeFile(DETECTION_CACHE_TEST_GAME_FILE, "game data"));
+		Common::FSNode gameFile(Common::Path(DETECTION_CACHE_TEST_GAME_FILE));
+
+		PersistentDetectionCache cache;
+		cache.load(Common::Path(DETECTION_CACHE_TEST_FILE));
+		TS_ASSERT_EQUALS(cache.size(), 0u);
+
+		cache.store("md5:5000:game", gameFile, "0123456789abcdef0123456789abcdef", 9);
+		cache.store("md5t:5000:game", gameFile, "fedcba9876543210fedcba9876543210", 9);
+		TS_ASSERT(cache.isDirty());
+		cache.save();
+		TS_ASSERT(!cache.isDirty());
+
+		PersistentDetectionCache loaded;
+		loaded.load(Common::Path(DETECTION_CACHE_TEST_FILE));
+		TS_ASSERT_EQUALS(loaded.size(), 2u);
+
+		Common::String md5;
+		int64 size = 0;
+		TS_ASSERT(loaded.lookup("md5:5000:game", gameFile, md5, size));
+		TS_ASSERT_EQUALS(md5, "0123456789abcdef0123456789abcdef");
+		TS_ASSERT_EQUALS(size, 9);
+		TS_ASSERT(loaded.lookup("md5t:5000:game", gameFile, md5, size));
+		TS_ASSERT_EQUALS(md5, "fedcba9876543210fedcba9876543210");
+		TS_ASSERT(!loaded.lookup("md5:5000:missing", gameFile, md5, size));
+		TS_ASSERT(!loaded.isDirty());
+	}
+
+	void test_changed_file_is_invalidated() {
+		TS_ASSERT(writeFile(DETECTION_CACHE_TEST_FILE, ""));
+		TS_ASSERT(writeFile(DETECTION_CACHE_TEST_GAME_FILE, "game data"));
+		Common::FSNode gameFile(Common::Path(DETECTION_CACHE_TEST_GAME_FILE));
+
+		PersistentDetectionCache cache;
+		cache.load(Common::Path(DETECTION_CACHE_TEST_FILE));
+		cache.store("md5:5000:game", gameFile, "0123456789abcdef0123456789abcdef", 9);
+		cache.save();
+
+		TS_ASSERT(writeFile(DETECTION_CACHE_TEST_GAME_FILE, "patched game data"));
+
+		PersistentDetectionCache loaded;
+		loaded.load(Common::Path(DETECTION_CACHE_TEST_FILE));
+		TS_ASSERT_EQUALS(loaded.size(), 1u);
+
+		Common::String md5;
+		int64 size = 0;
+		TS_ASSERT(!loaded.lookup("md5:5000:game", gameFile, md5, size));
+		TS_ASSERT_EQUALS(loaded.size(), 0u);
+		TS_ASSERT(loaded.isDirty());
+
+		// The outdated entry is gone from the file as well
+		loaded.save();
+		PersistentDetectionCache reloaded;
+		reloaded.load(Common::Path(DETECTION_CACHE_TEST_FILE));
+		TS_ASSERT_EQUALS(reloaded.size(), 0u);
+	}
+
+	void test_unknown_format_is_ignored() {
+		TS_ASSERT(writeFile(DETECTION_CACHE_TEST_FILE, "Some other file\n0123\t9\t9\t0\tkey\n"));
+
+		PersistentDetectionCache cache;
+		cache.load(Common::Path(DETECTION_CACHE_TEST_FILE));
+		TS_ASSERT(cache.isLoaded());
+		TS_ASSERT_EQUALS(cache.size(), 0u);
+	}
+};
@@ -0,0 +1,104 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/fs.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+#include "graphics/font.h"
+#include "graphics/fonts/ttf.h"
+#include "graphics/surface.h"
+
+#include "../null_osystem.h"
+
+// The CJK font from the GUI themes, copied next to the test runner. It has
+// enough glyphs to exercise the reuse of the glyph atlas pages.
+#define TTF_TEST_FONT "test/fonts/VL-Gothic-Regular.ttf"
+
+// Define this to measure how fast strings are drawn
+//#define TTF_BENCHMARK
+
+class TTFFontTestSuite : public CxxTest::TestSuite {
+private:
+#ifdef USE_FREETYPE2
+	// Draw a string character by character, like drawString did it
+	static void drawChars(const Graphics::Font *font, Graphics::Surface *dst, const Common::U32String &str, int x, int y, uint32 color) {
+		uint32 last = 0;
+		for (uint i = 0; i < str.size(); i++) {
+			x += font->getKerningOffset(last, str[i]);
+			last = str[i];
+			font->drawChar(dst, str[i], x, y, color);
+			x += font->getCharWidth(str[i]);
+		}
+	}
+
+	static Common::U32String makeString(uint32 first, uint count) {
+		Common::U32String str;
+		for (uint i = 0; i < count; i++)
+			str += (Common::u32char_type_t)(first + i);
+		return str;
+	}
+#endif
+
+public:
+	void test_draw_string() {
+#ifdef USE_FREETYPE2
+		Common::install_null_g_system();
+
+		Common::SeekableReadStream *stream = Common::FSNode(TTF_TEST_FONT).createReadStream();
+		TS_ASSERT(stream);
+		if (!stream)
+			return;
+
+		Graphics::Font *font = Graphics::loadTTFFont(stream, DisposeAfterUse::YES, 16);
+		TS_ASSERT(font);
+		if (!font)
+			return;
+
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 16, 8, 0, 24);
+		const uint32 color = format.RGBToColor(255, 255, 255);
+		Graphics::Surface expected, actual;
+		expected.create(4000, font->getFontHeight(), format);
+		actual.create(4000, font->getFontHeight(), format);
+
+		// Latin text, then enough CJK ideographs to reuse atlas pages
+		const Common::U32String strings[] = {
+			Common::U32String("The quick brown fox jumps over the lazy dog. AVAWAY To Ta"),
+			makeString(0x4E00, 200),
+			makeString(0x5000, 6000)
+		};
+
+		for (uint i = 0; i < ARRAYSIZE(strings); i++) {
+			for (uint start = 0; start < strings[i].size(); start += 200) {
+				const Common::U32String str(strings[i].substr(start, 200));
+				expected.fillRect(Common::Rect(expected.w, expected.h), 0);
+				actual.fillRect(Common::Rect(actual.w, actual.h), 0);
+
+				drawChars(font, &expected, str, 0, 0, color);
+				font->drawString(&actual, str, 0, 0, actual.w, color);
+				TS_ASSERT_EQUALS(memcmp(expected.getPixels(), actual.getPixels(), actual.h * actual.pitch), 0);
+			}
+		}
+
+#ifdef TTF_BENCHMARK
+		const uint32 kIterations = 2000;
+		const Common::U32String &str = strings[0];
+
+		uint32 start = g_system->getMillis();
+		for (uint32 i = 0; i < kIterations; i++)
+			drawChars(font, &expected, str, 0, 0, color);
+		const uint32 charTime = g_system->getMillis() - start;
+
+		start = g_system->getMillis();
+		for (uint32 i = 0; i < kIterations; i++)
+			font->drawString(&actual, str, 0, 0, actual.w, color);
+		const uint32 stringTime = g_system->getMillis() - start;
+
+		debug("TTF: %u strings drawn in %u ms character by character, %u ms with drawString", kIterations, charTime, stringTime);
+#endif
+
+		expected.free();
+		actual.free();
+		delete font;
+#endif
+	}
+};
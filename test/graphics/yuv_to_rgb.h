@@ -0,0 +1,121 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_kernels.h"
+
+#include "../instrset_detect.h"
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite {
+private:
+	typedef int(*ConvertRowFunc)(byte *, const byte *, const byte *, const byte *, int, const Graphics::YUVToRGBKernels::Params &);
+
+	enum Mode {
+		kMode444,
+		kMode422,
+		kMode420
+	};
+
+	static void setKernels(ConvertRowFunc convertRow444, ConvertRowFunc convertRow422) {
+		Graphics::YUVToRGBKernels::funcsSelected = true;
+		Graphics::YUVToRGBKernels::convertRow444Func = convertRow444;
+		Graphics::YUVToRGBKernels::convertRow422Func = convertRow422;
+	}
+
+	static void convert(Graphics::Surface &dst, Mode mode, Graphics::YUVToRGBManager::LuminanceScale scale, const byte *y, const byte *u, const byte *v, int yPitch, int uvPitch) {
+		switch (mode) {
+		case kMode444:
+			YUVToRGBMan.convert444(&dst, scale, y, u, v, dst.w, dst.h, yPitch, uvPitch);
+			break;
+		case kMode422:
+			YUVToRGBMan.convert422(&dst, scale, y, u, v, dst.w, dst.h, yPitch, uvPitch);
+			break;
+		case kMode420:
+			YUVToRGBMan.convert420(&dst, scale, y, u, v, dst.w, dst.h, yPitch, uvPitch);
+			break;
+		}
+	}
+
+	// Convert random planes and check the kernels give the same result as the lookup tables
+	void checkRandom(ConvertRowFunc convertRow444, ConvertRowFunc convertRow422, const Graphics::PixelFormat &format, Mode mode, Graphics::YUVToRGBManager::LuminanceScale scale, int width, int height) {
+		const int yPitch = width + 3;
+		const int uvPitch = yPitch;
+		Common::Array<byte> y(yPitch * height), u(uvPitch * height), v(uvPitch * height);
+
+		uint32 seed = width * 31 + height;
+		for (uint i = 0; i < y.size(); i++) {
+			seed = seed * 1103515245 + 12345;
+			y[i] = seed >> 24;
+			u[i] = seed >> 16;
+			v[i] = seed >> 8;
+		}
+
+		checkPlanes(convertRow444, convertRow422, format, mode, scale, width, height, y.data(), u.data(), v.data(), yPitch, uvPitch);
+	}
+
+	void checkPlanes(ConvertRowFunc convertRow444, ConvertRowFunc convertRow422, const Graphics::PixelFormat &format, Mode mode, Graphics::YUVToRGBManager::LuminanceScale scale, int width, int height, const byte *y, const byte *u, const byte *v, int yPitch, int uvPitch) {
+		Graphics::Surface expected, actual;
+		expected.create(width, height, format);
+		actual.create(width, height, format);
+
+		setKernels(nullptr, nullptr);
+		convert(expected, mode, scale, y, u, v, yPitch, uvPitch);
+		setKernels(convertRow444, convertRow422);
+		convert(actual, mode, scale, y, u, v, yPitch, uvPitch);
+		setKernels(nullptr, nullptr);
+
+		TS_ASSERT_EQUALS(memcmp(expected.getPixels(), actual.getPixels(), expected.pitch * height), 0);
+
+		expected.free();
+		actual.free();
+	}
+
+	void checkKernels(ConvertRowFunc convertRow444, ConvertRowFunc convertRow422) {
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0)
+		};
+		const Graphics::YUVToRGBManager::LuminanceScale scales[] = {
+			Graphics::YUVToRGBManager::kScaleFull,
+			Graphics::YUVToRGBManager::kScaleITU
+		};
+
+		for (uint f = 0; f < ARRAYSIZE(formats); f++) {
+			for (uint s = 0; s < ARRAYSIZE(scales); s++) {
+				// All combinations of chroma values, with varying luminance
+				Common::Array<byte> y(256 * 256), u(256 * 256), v(256 * 256);
+				for (int i = 0; i < 256 * 256; i++) {
+					u[i] = i & 0xFF;
+					v[i] = i >> 8;
+					y[i] = (i * 7 + (i >> 8) * 13) & 0xFF;
+				}
+				checkPlanes(convertRow444, convertRow422, formats[f], kMode444, scales[s], 256, 256, y.data(), u.data(), v.data(), 256, 256);
+
+				// Widths which leave a remainder for the lookup tables
+				const int widths[] = { 2, 16, 70, 130 };
+				for (uint w = 0; w < ARRAYSIZE(widths); w++) {
+					checkRandom(convertRow444, convertRow422, formats[f], kMode444, scales[s], widths[w], 6);
+					checkRandom(convertRow444, convertRow422, formats[f], kMode422, scales[s], widths[w], 6);
+					checkRandom(convertRow444, convertRow422, formats[f], kMode420, scales[s], widths[w], 6);
+				}
+			}
+		}
+	}
+
+public:
+	void test_simd_kernels() {
+#ifdef SCUMMVM_NEON
+		checkKernels(Graphics::YUVToRGBKernels::convertRow444NEON, Graphics::YUVToRGBKernels::convertRow422NEON);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			checkKernels(Graphics::YUVToRGBKernels::convertRow444SSE2, Graphics::YUVToRGBKernels::convertRow422SSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			checkKernels(Graphics::YUVToRGBKernels::convertRow444AVX2, Graphics::YUVToRGBKernels::convertRow422AVX2);
+#endif
+	}
+};
@@ -5,21 +5,25 @@
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/common/formats/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h $(srcdir)/test/image/*.h
-TEST_LIBS    :=
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/common/formats/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h $(srcdir)/test/image/*.h $(srcdir)/test/graphics/*.h $(srcdir)/test/video/*.h $(srcdir)/test/engines/*.h
+TEST_LIBS    := engines/detectionCache.o
 
 ifdef POSIX
 TEST_LIBS += test/null_osystem.o \
+	backends/timer/default/default-timer.o \
 	backends/fs/posix/posix-fs-factory.o \
 	backends/fs/posix/posix-fs.o \
 	backends/fs/posix/posix-iostream.o \
 	backends/fs/abstract-fs.o \
 	backends/fs/stdiostream.o \
-	backends/modular-backend.o
+	backends/modular-backend.o \
+	backends/mutex/pthread/pthread-mutex.o \
+	backends/thread/pthread/pthread-thread.o
 endif
 
 ifdef WIN32
 TEST_LIBS += test/null_osystem.o \
+	backends/timer/default/default-timer.o \
 	backends/fs/windows/windows-fs-factory.o \
 	backends/fs/windows/windows-fs.o \
 	backends/fs/abstract-fs.o \
@@ -28,7 +32,7 @@ TEST_LIBS += test/null_osystem.o \
 	backends/platform/sdl/win32/win32_wrapper.o
 endif
 
-TEST_LIBS +=	audio/libaudio.a math/libmath.a common/formats/libformats.a common/compression/libcompression.a common/libcommon.a image/libimage.a graphics/libgraphics.a
+TEST_LIBS +=	video/libvideo.a audio/libaudio.a math/libmath.a common/formats/libformats.a common/compression/libcompression.a common/libcommon.a image/libimage.a graphics/libgraphics.a
 
 ifeq ($(ENABLE_WINTERMUTE), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/wintermute/*.h
@@ -49,6 +53,11 @@ endif
 TEST_FLAGS   := --runner=StdioPrinter --no-std --no-eh
 TEST_CFLAGS  := $(CFLAGS) -I$(srcdir)/test/cxxtest
 TEST_LDFLAGS := $(LDFLAGS) $(LIBS)
+
+# The threaded null OSystem uses the pthread backend
+ifdef POSIX
+TEST_LDFLAGS += -lpthread
+endif
 TEST_CXXFLAGS  := $(filter-out -Wglobal-constructors,$(CXXFLAGS))
 TEST_CXXFLAGS += -Wno-self-assign-overloaded
 
@@ -81,13 +90,17 @@ test/runner.cpp: $(TESTS) $(srcdir)/test/module.mk
 
 clean: clean-test
 clean-test:
-	-$(RM) test/runner.cpp test/runner test/engine-data/encoding.dat test/null_osystem.o
-	-rmdir test/engine-data
+	-$(RM) test/runner.cpp test/runner test/engine-data/encoding.dat test/fonts/VL-Gothic-Regular.ttf test/null_osystem.o
+	-rmdir test/engine-data test/fonts
 
 test/engine-data/encoding.dat: $(srcdir)/dists/engine-data/encoding.dat
 	$(MKDIR) test/engine-data
 	$(CP) $(srcdir)/dists/engine-data/encoding.dat test/engine-data/encoding.dat
 
-copy-dat: test/engine-data/encoding.dat
+test/fonts/VL-Gothic-Regular.ttf: $(srcdir)/gui/themes/fonts-cjk/VL-Gothic-Regular.ttf
+	$(MKDIR) test/fonts
+	$(CP) $(srcdir)/gui/themes/fonts-cjk/VL-Gothic-Regular.ttf test/fonts/VL-Gothic-Regular.ttf
+
+copy-dat: test/engine-data/encoding.dat test/fonts/VL-Gothic-Regular.ttf
 
 .PHONY: test clean-test copy-dat
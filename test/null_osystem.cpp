@@ -17,6 +17,32 @@ void Common::install_null_g_system() {
 	g_system = OSystem_NULL_create(silenceLogs);
 }
 
+void Common::install_manual_clock_null_g_system() {
+#ifdef DISPLAY_ERROR_MESSAGES
+	const bool silenceLogs = false;
+#else
+	const bool silenceLogs = true;
+#endif
+
+	OSystem_NULL *system = new OSystem_NULL(silenceLogs);
+	system->_manualClock = true;
+	g_system = system;
+}
+
+#if defined(POSIX)
+void Common::install_threaded_null_g_system() {
+#ifdef DISPLAY_ERROR_MESSAGES
+	const bool silenceLogs = false;
+#else
+	const bool silenceLogs = true;
+#endif
+
+	OSystem_NULL *system = new OSystem_NULL(silenceLogs);
+	system->_threaded = true;
+	g_system = system;
+}
+#endif
+
 void OSystem_NULL::quit() {
 	abort();
 }
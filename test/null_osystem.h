@@ -3,9 +3,26 @@
 namespace Common {
 #if defined(POSIX) || defined(WIN32)
 void install_null_g_system();
+
+/**
+ * Install a null OSystem whose clock only advances through delayMillis(),
+ * for tests which must not depend on the load of the machine.
+ */
+void install_manual_clock_null_g_system();
 #define NULL_OSYSTEM_IS_AVAILABLE 1
 #else
 #define NULL_OSYSTEM_IS_AVAILABLE 0
 #endif
+
+#if defined(POSIX)
+/**
+ * Install a null OSystem which creates real threads, condition variables
+ * and mutexes, for tests which need concurrency.
+ */
+void install_threaded_null_g_system();
+#define THREADED_NULL_OSYSTEM_IS_AVAILABLE 1
+#else
+#define THREADED_NULL_OSYSTEM_IS_AVAILABLE 0
+#endif
 }
 #endif
@@ -0,0 +1,86 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/fs.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+#include "common/threadpool.h"
+
+#include "video/bink_decoder.h"
+
+#include "../null_osystem.h"
+
+// Define this to the path of a Bink video to measure how fast it is decoded.
+// The multi-threaded run needs a backend with threads, which the test null
+// OSystem only provides on POSIX.
+//#define BINK_BENCHMARK_FILE "video.bik"
+
+class BinkDecoderTestSuite : public CxxTest::TestSuite {
+private:
+#if defined(USE_BINK) && defined(BINK_BENCHMARK_FILE)
+	// Decode all the frames of the video, and return the time taken
+	static uint32 decodeAll(int numThreads, uint &frameCount, uint32 &checksum) {
+		Video::BinkDecoder decoder;
+		decoder.setThreadCount(numThreads);
+
+		Common::SeekableReadStream *stream = Common::FSNode(BINK_BENCHMARK_FILE).createReadStream();
+		if (!stream || !decoder.loadStream(stream))
+			return 0;
+
+		decoder.setOutputPixelFormat(Graphics::PixelFormat(4, 8, 8, 8, 8, 8, 16, 24, 0));
+
+		frameCount = 0;
+		checksum = 0;
+
+		const uint32 start = g_system->getMillis();
+		while (!decoder.endOfVideo()) {
+			const Graphics::Surface *frame = decoder.decodeNextFrame();
+			if (!frame)
+				break;
+
+			for (int y = 0; y < frame->h; y++) {
+				const uint32 *row = (const uint32 *)frame->getBasePtr(0, y);
+				for (int x = 0; x < frame->w; x++)
+					checksum = checksum * 31 + row[x];
+			}
+
+			frameCount++;
+		}
+
+		return g_system->getMillis() - start;
+	}
+#endif
+
+public:
+	void test_decoding_speed() {
+#if defined(USE_BINK) && defined(BINK_BENCHMARK_FILE)
+#if THREADED_NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_threaded_null_g_system();
+#else
+		Common::install_null_g_system();
+#endif
+
+		uint frames[2] = { 0, 0 };
+		uint32 checksums[2] = { 0, 0 };
+		const uint32 singleTime = decodeAll(0, frames[0], checksums[0]);
+
+		// Without threads, the thread pool runs everything inline, so there
+		// is nothing to compare against
+		if (g_system->getCpuCount() < 2 || !Common::ThreadPool(1).getThreadCount()) {
+			TS_ASSERT(frames[0] > 0);
+			debug("Bink: %u frames, %.1f fps single-threaded, no worker threads to compare with",
+				frames[0], frames[0] * 1000.0 / MAX<uint32>(singleTime, 1));
+			return;
+		}
+
+		const uint32 multiTime = decodeAll(-1, frames[1], checksums[1]);
+
+		TS_ASSERT(frames[0] > 0);
+		TS_ASSERT_EQUALS(frames[0], frames[1]);
+		TS_ASSERT_EQUALS(checksums[0], checksums[1]);
+
+		debug("Bink: %u frames, %.1f fps single-threaded, %.1f fps multi-threaded (%u cores)",
+			frames[0], frames[0] * 1000.0 / MAX<uint32>(singleTime, 1), frames[1] * 1000.0 / MAX<uint32>(multiTime, 1),
+			g_system->getCpuCount());
+#endif
+	}
+};
@@ -0,0 +1,179 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/atomic.h"
+#include "common/system.h"
+
+#include "graphics/surface.h"
+#include "video/video_decoder.h"
+
+#include "../null_osystem.h"
+
+namespace {
+
+// A decoder for a video track without audio, whose frames are decoded ahead
+class CountingDecoder : public Video::VideoDecoder {
+public:
+	CountingDecoder() : _decoding(0), _overlaps(0), _packets(0) {}
+
+	bool loadStream(Common::SeekableReadStream *stream) override { return false; }
+
+	void load(int frameCount) {
+		addTrack(new CountingVideoTrack(frameCount, &_decoding, &_overlaps));
+	}
+
+	uint32 getOverlaps() { return Common::atomicLoadAcquire(&_overlaps); }
+	uint32 getPackets() { return Common::atomicLoadAcquire(&_packets); }
+
+protected:
+	// A video track whose frames are filled with their frame number
+	class CountingVideoTrack : public FixedRateVideoTrack {
+	public:
+		CountingVideoTrack(int frameCount, volatile uint32 *decoding, volatile uint32 *overlaps) :
+				_frameCount(frameCount), _curFrame(-1), _decoding(decoding), _overlaps(overlaps) {
+			_surface.create(4, 4, Graphics::PixelFormat::createFormatCLUT8());
+		}
+
+		~CountingVideoTrack() { _surface.free(); }
+
+		bool isSeekable() const override { return true; }
+		bool seek(const Audio::Timestamp &time) override {
+			_curFrame = getFrameAtTime(time) - 1;
+			return true;
+		}
+
+		uint16 getWidth() const override { return _surface.w; }
+		uint16 getHeight() const override { return _surface.h; }
+		Graphics::PixelFormat getPixelFormat() const override { return _surface.format; }
+		int getCurFrame() const override { return _curFrame; }
+		int getFrameCount() const override { return _frameCount; }
+
+		const Graphics::Surface *decodeNextFrame() override {
+			Common::atomicStoreRelease(_decoding, 1);
+			g_system->delayMillis(1);
+
+			_curFrame++;
+			_surface.fillRect(Common::Rect(_surface.w, _surface.h), (uint32)_curFrame);
+
+			Common::atomicStoreRelease(_decoding, 0);
+			return &_surface;
+		}
+
+	protected:
+		Common::Rational getFrameRate() const override { return 30; }
+
+		void pauseIntern(bool shouldPause) override {
+			// The worker thread must not decode while the tracks are paused
+			if (Common::atomicLoadAcquire(_decoding))
+				Common::atomicFetchAdd(_overlaps, 1);
+		}
+
+	private:
+		Graphics::Surface _surface;
+		int _frameCount;
+		int _curFrame;
+		volatile uint32 *_decoding;
+		volatile uint32 *_overlaps;
+	};
+
+	void readNextPacket() override { Common::atomicFetchAdd(&_packets, 1); }
+
+private:
+	volatile uint32 _decoding;
+	volatile uint32 _overlaps;
+	volatile uint32 _packets;
+};
+
+// Return the frame number the frame was filled with
+int frameNumber(const Graphics::Surface *frame) {
+	return frame ? *(const byte *)frame->getPixels() : -1;
+}
+
+} // End of anonymous namespace
+
+class VideoDecoderTestSuite : public CxxTest::TestSuite {
+public:
+	void test_frame_ahead_order() {
+#if THREADED_NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_threaded_null_g_system();
+
+		CountingDecoder decoder;
+		decoder.load(5);
+		TS_ASSERT(decoder.setFrameAheadCount(3));
+
+		for (int i = 0; i < 5; i++) {
+			// The worker may already have reached the end of the track, but
+			// the video only ends once the last frame was handed over
+			TS_ASSERT(!decoder.endOfVideo());
+
+			const Graphics::Surface *frame = decoder.decodeNextFrame();
+			TS_ASSERT_EQUALS(frameNumber(frame), i);
+			TS_ASSERT_EQUALS(decoder.getCurFrame(), i);
+
+			// Give the worker the time to decode ahead
+			g_system->delayMillis(10);
+		}
+
+		TS_ASSERT(decoder.endOfVideo());
+		TS_ASSERT(decoder.getPackets() >= 5);
+		TS_ASSERT_EQUALS(decoder.getOverlaps(), 0u);
+#endif
+	}
+
+	void test_frame_ahead_seek_flushes() {
+#if THREADED_NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_threaded_null_g_system();
+
+		CountingDecoder decoder;
+		decoder.load(30);
+		TS_ASSERT(decoder.setFrameAheadCount(4));
+
+		for (int i = 0; i < 3; i++)
+			TS_ASSERT_EQUALS(frameNumber(decoder.decodeNextFrame()), i);
+
+		// The frames decoded ahead are dropped, and decoding continues from
+		// the new position
+		g_system->delayMillis(10);
+		TS_ASSERT(decoder.seekToFrame(20));
+		TS_ASSERT_EQUALS(frameNumber(decoder.decodeNextFrame()), 20);
+		TS_ASSERT_EQUALS(frameNumber(decoder.decodeNextFrame()), 21);
+
+		g_system->delayMillis(10);
+		TS_ASSERT(decoder.rewind());
+		TS_ASSERT(!decoder.endOfVideo());
+		for (int i = 0; i < 30; i++) {
+			TS_ASSERT(!decoder.endOfVideo());
+			TS_ASSERT_EQUALS(frameNumber(decoder.decodeNextFrame()), i);
+		}
+
+		TS_ASSERT(decoder.endOfVideo());
+		TS_ASSERT_EQUALS(decoder.getOverlaps(), 0u);
+#endif
+	}
+
+	void test_frame_ahead_pause_and_stop() {
+#if THREADED_NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_threaded_null_g_system();
+
+		CountingDecoder decoder;
+		decoder.load(40);
+		TS_ASSERT(decoder.setFrameAheadCount(8));
+		decoder.start();
+
+		// Pausing and stopping wait for the worker thread, but keep the
+		// frames that were decoded ahead
+		int expected = 0;
+		for (int i = 0; i < 10; i++) {
+			TS_ASSERT_EQUALS(frameNumber(decoder.decodeNextFrame()), expected++);
+
+			decoder.pauseVideo(true);
+			decoder.pauseVideo(false);
+			TS_ASSERT_EQUALS(frameNumber(decoder.decodeNextFrame()), expected++);
+
+			decoder.stop();
+			decoder.start();
+		}
+
+		TS_ASSERT_EQUALS(decoder.getOverlaps(), 0u);
+#endif
+	}
+};
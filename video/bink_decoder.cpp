@@ -36,6 +36,7 @@
 #include "common/bitstream.h"
 #include "common/compression/huffman.h"
 #include "common/system.h"
+#include "common/threadpool.h"
 
 #include "graphics/yuv_to_rgb.h"
 #include "graphics/surface.h"
@@ -61,14 +62,64 @@ static const uint32 kDCStartBits = 11;
 
 namespace Video {
 
+// Decoders using the default number of threads share a pool, which exists
+// as long as any of them has a video loaded. Videos are loaded and closed
+// on the thread playing them, which is always the same one.
+static Common::ThreadPool *s_sharedThreadPool = nullptr;
+static uint s_sharedThreadPoolUsers = 0;
+
 BinkDecoder::BinkDecoder() {
 	_bink = 0;
+
+	_threadCount = -1;
+	_threadPool = nullptr;
 }
 
 BinkDecoder::~BinkDecoder() {
 	close();
 }
 
+void BinkDecoder::setThreadCount(int numThreads) {
+	if (numThreads == _threadCount)
+		return;
+
+	_threadCount = numThreads;
+
+	if (_threadPool) {
+		releaseThreadPool();
+		acquireThreadPool();
+	}
+}
+
+void BinkDecoder::acquireThreadPool() {
+	if (_threadPool || _threadCount == 0)
+		return;
+
+	if (_threadCount > 0) {
+		_threadPool = new Common::ThreadPool(_threadCount);
+		return;
+	}
+
+	if (!s_sharedThreadPool)
+		s_sharedThreadPool = new Common::ThreadPool();
+	s_sharedThreadPoolUsers++;
+	_threadPool = s_sharedThreadPool;
+}
+
+void BinkDecoder::releaseThreadPool() {
+	if (!_threadPool)
+		return;
+
+	if (_threadPool != s_sharedThreadPool) {
+		delete _threadPool;
+	} else if (--s_sharedThreadPoolUsers == 0) {
+		delete s_sharedThreadPool;
+		s_sharedThreadPool = nullptr;
+	}
+
+	_threadPool = nullptr;
+}
+
 bool BinkDecoder::loadStream(Common::SeekableReadStream *stream) {
 	close();
 
@@ -141,12 +192,16 @@ bool BinkDecoder::loadStream(Common::SeekableReadStream *stream) {
 
 	_frames[frameCount - 1].size = _bink->size() - _frames[frameCount - 1].offset;
 
+	acquireThreadPool();
+
 	return true;
 }
 
 void BinkDecoder::close() {
 	VideoDecoder::close();
 
+	releaseThreadPool();
+
 	delete _bink;
 	_bink = 0;
 
@@ -167,6 +222,10 @@ void BinkDecoder::readNextPacket() {
 
 	uint32 frameSize = frame.size;
 
+	// The audio packets are read into memory, so that they can be decoded
+	// on the worker threads while the video packet is read from the file
+	Common::Array<Common::Future<void> > audioPackets;
+
 	for (uint32 i = 0; i < _audioTracks.size(); i++) {
 		AudioInfo &audio = _audioTracks[i];
 
@@ -180,19 +239,17 @@ void BinkDecoder::readNextPacket() {
 		if (audioPacketLength >= 4) {
 			// Get our track - audio index plus one as the first track is video
 			BinkAudioTrack *audioTrack = (BinkAudioTrack *)getTrack(i + 1);
-			uint32 audioPacketStart = _bink->pos();
-			uint32 audioPacketEnd   = _bink->pos() + audioPacketLength;
+			uint32 audioPacketEnd = _bink->pos() + audioPacketLength;
 
 			//                  Number of samples in bytes
 			audio.sampleCount = _bink->readUint32LE() / (2 * audio.channels);
 
-			audio.bits = new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
-					audioPacketStart + 4, audioPacketEnd), DisposeAfterUse::YES);
+			audio.bits = new Common::BitStream32LELSB(_bink->readStream(audioPacketLength - 4), DisposeAfterUse::YES);
 
-			audioTrack->decodePacket();
-
-			delete audio.bits;
-			audio.bits = 0;
+			if (_threadPool)
+				audioPackets.push_back(_threadPool->submit(DecodeAudioPacket(audioTrack)));
+			else
+				audioTrack->decodePacket();
 
 			_bink->seek(audioPacketEnd);
 
@@ -206,10 +263,18 @@ void BinkDecoder::readNextPacket() {
 	frame.bits = new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
 			videoPacketStart, videoPacketEnd), DisposeAfterUse::YES);
 
-	videoTrack->decodePacket(frame);
+	videoTrack->decodePacket(frame, _threadPool);
 
 	delete frame.bits;
 	frame.bits = 0;
+
+	for (uint32 i = 0; i < audioPackets.size(); i++)
+		audioPackets[i].wait();
+
+	for (uint32 i = 0; i < _audioTracks.size(); i++) {
+		delete _audioTracks[i].bits;
+		_audioTracks[i].bits = 0;
+	}
 }
 
 VideoDecoder::AudioTrack *BinkDecoder::getAudioTrack(int index) {
@@ -446,7 +511,7 @@ bool BinkDecoder::BinkVideoTrack::rewind() {
 	return true;
 }
 
-void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
+void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame, Common::ThreadPool *pool) {
 	assert(frame.bits);
 
 	if (!_surface) {
@@ -478,24 +543,60 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 			break;
 	}
 
+	convertFrame(pool);
+
+	// And swap the planes with the reference planes
+	for (int i = 0; i < 4; i++)
+		SWAP(_curPlanes[i], _oldPlanes[i]);
+
+	_curFrame++;
+}
+
+void BinkDecoder::BinkVideoTrack::convertFrame(Common::ThreadPool *pool) {
+	if (!pool || pool->getThreadCount() == 0 || _surfaceHeight <= kConvertStripeHeight) {
+		convertRows(0, _surfaceHeight);
+		return;
+	}
+
+	// The first stripe is converted before the others are queued, so that
+	// the conversion tables are set up before they are used concurrently
+	const int stripeCount = (_surfaceHeight + kConvertStripeHeight - 1) / kConvertStripeHeight;
+
+	convertRows(0, kConvertStripeHeight);
+	pool->parallelFor(1, stripeCount, ConvertStripe(this));
+}
+
+void BinkDecoder::BinkVideoTrack::ConvertStripe::operator()(int stripe) const {
+	const int top = stripe * kConvertStripeHeight;
+
+	track->convertRows(top, MIN(kConvertStripeHeight, track->_surfaceHeight - top));
+}
+
+void BinkDecoder::BinkVideoTrack::convertRows(int top, int height) {
 	// Convert the YUV data we have to our format
 	// The width used here is the surface-width, and not the video-width
 	// to allow for odd-sized videos.
+	const int yPitch  = _yBlockWidth  * 8;
+	const int uvPitch = _uvBlockWidth * 8;
+
+	Graphics::Surface dst;
+	dst.init(_surfaceWidth, height, _surface->pitch, _surface->getBasePtr(0, top), _surface->format);
+
+	const byte *y = _curPlanes[0] + top * yPitch;
+	const byte *u = _curPlanes[1] + (top / 2) * uvPitch;
+	const byte *v = _curPlanes[2] + (top / 2) * uvPitch;
+
 	if (_hasAlpha) {
 		assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2] && _curPlanes[3]);
-		YUVToRGBMan.convert420Alpha(_surface, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2], _curPlanes[3],
-				_surfaceWidth, _surfaceHeight, _yBlockWidth * 8, _uvBlockWidth * 8);
+		const byte *a = _curPlanes[3] + top * yPitch;
+
+		YUVToRGBMan.convert420Alpha(&dst, Graphics::YUVToRGBManager::kScaleITU, y, u, v, a,
+				_surfaceWidth, height, yPitch, uvPitch);
 	} else {
 		assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2]);
-		YUVToRGBMan.convert420(_surface, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2],
-				_surfaceWidth, _surfaceHeight, _yBlockWidth * 8, _uvBlockWidth * 8);
+		YUVToRGBMan.convert420(&dst, Graphics::YUVToRGBManager::kScaleITU, y, u, v,
+				_surfaceWidth, height, yPitch, uvPitch);
 	}
-
-	// And swap the planes with the reference planes
-	for (int i = 0; i < 4; i++)
-		SWAP(_curPlanes[i], _oldPlanes[i]);
-
-	_curFrame++;
 }
 
 void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, bool isChroma) {
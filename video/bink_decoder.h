@@ -47,6 +47,7 @@ namespace Common {
 class SeekableReadStream;
 template <class BITSTREAM>
 class Huffman;
+class ThreadPool;
 }
 
 namespace Math {
@@ -76,6 +77,24 @@ public:
 
 	Common::Rational getFrameRate();
 
+	/**
+	 * Set the number of worker threads used for decoding.
+	 *
+	 * The audio packets of a frame are decoded while the video packet is
+	 * being decoded, and the conversion of the decoded planes to RGB is
+	 * split into stripes of rows. The planes themselves are always decoded
+	 * in order, since each plane only starts where the previous one ends
+	 * in the bitstream.
+	 *
+	 * The workers only exist while a video is loaded. With the default
+	 * number, all decoders share the same workers.
+	 *
+	 * @param numThreads  The number of worker threads, 0 to decode on the
+	 *                    calling thread only, or -1 (the default) for one
+	 *                    worker per additional CPU core.
+	 */
+	void setThreadCount(int numThreads);
+
 protected:
 	void readNextPacket();
 	bool supportsAudioTrackSwitching() const { return true; }
@@ -163,7 +182,7 @@ private:
 		void setCurFrame(uint32 frame) { _curFrame = frame; }
 
 		/** Decode a video packet. */
-		void decodePacket(VideoFrame &frame);
+		void decodePacket(VideoFrame &frame, Common::ThreadPool *pool);
 
 		Common::Rational getFrameRate() const override { return _frameRate; }
 
@@ -262,6 +281,17 @@ private:
 
 		Common::Huffman<Common::BitStream32LELSB> *_huffman[16]; ///< The 16 Huffman codebooks used in Bink decoding.
 
+		/** Height of the stripes of rows converted to RGB in parallel. */
+		static const int kConvertStripeHeight = 32;
+
+		/** Converts a stripe of rows of the current frame to RGB. */
+		struct ConvertStripe {
+			BinkVideoTrack *track;
+
+			ConvertStripe(BinkVideoTrack *t) : track(t) {}
+			void operator()(int stripe) const;
+		};
+
 		/** Huffman codebooks to use for decoding high nibbles in color data types. */
 		Huffman _colHighHuffman[16];
 		/** Value of the last decoded high nibble in color data types. */
@@ -283,6 +313,11 @@ private:
 		/** Initialize the Huffman decoders. */
 		void initHuffman();
 
+		/** Convert the current frame to RGB, using the pool's workers if any. */
+		void convertFrame(Common::ThreadPool *pool);
+		/** Convert the given rows of the current frame to RGB. */
+		void convertRows(int top, int height);
+
 		/** Decode a plane. */
 		void decodePlane(VideoFrame &video, int planeIdx, bool isChroma);
 
@@ -371,8 +406,24 @@ private:
 		static void floatToInt16Interleave(int16 *dst, const float **src, uint32 length, uint8 channels);
 	};
 
+	/** Decodes the pending packet of an audio track. */
+	struct DecodeAudioPacket {
+		BinkAudioTrack *track;
+
+		DecodeAudioPacket(BinkAudioTrack *t) : track(t) {}
+		void operator()() const { track->decodePacket(); }
+	};
+
 	Common::SeekableReadStream *_bink;
 
+	int _threadCount;                ///< The number of worker threads requested.
+	Common::ThreadPool *_threadPool; ///< The worker threads, while a video is loaded.
+
+	/** Get a thread pool for the requested number of threads, shared by default. */
+	void acquireThreadPool();
+	/** Give back the thread pool, deleting it once no decoder uses it. */
+	void releaseThreadPool();
+
 	Common::Array<AudioInfo> _audioTracks; ///< All audio tracks.
 	Common::Array<VideoFrame> _frames;      ///< All video frames.
 
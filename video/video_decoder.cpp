@@ -26,10 +26,242 @@
 
 #include "common/rational.h"
 #include "common/file.h"
+#include "common/mutex.h"
 #include "common/system.h"
+#include "common/threadpool.h"
+
+#include "graphics/surface.h"
 
 namespace Video {
 
+/**
+ * A ring of frames decoded ahead by a worker thread.
+ *
+ * The ring holds one frame more than can be decoded ahead, which is the one
+ * last handed over by nextFrame(). While the queue is active, the worker
+ * thread owns the track, and the state of the track as seen by playback is
+ * taken from the frames handed over instead.
+ */
+class VideoDecoder::FrameAheadQueue {
+public:
+	FrameAheadQueue(VideoDecoder *decoder, VideoTrack *track, uint count);
+	~FrameAheadQueue();
+
+	/** Return whether frames can be decoded on a worker thread. */
+	bool hasWorker() const { return _pool.getThreadCount() != 0; }
+
+	VideoTrack *getTrack() const { return _track; }
+	bool isActive() const { return _active; }
+
+	/** Start decoding ahead, from the current position of the track. */
+	void start();
+
+	/**
+	 * Wait for the worker thread and drop all frames decoded ahead. The
+	 * track can then be accessed directly again, until start() is called.
+	 */
+	void flush();
+
+	/** Wait until the worker thread has stopped decoding. */
+	void finish() { _filling.wait(); }
+
+	/**
+	 * Stop the worker thread, keeping the frames decoded ahead. Decoding
+	 * ahead continues with the next nextFrame() call.
+	 */
+	void stopFilling();
+
+	/** Hand over the next frame, waiting for it to be decoded if necessary. */
+	const Graphics::Surface *nextFrame();
+
+	// State of the track after decoding the last frame handed over
+	int getCurFrame() const { return _curFrame; }
+	uint32 getNextFrameStartTime() const { return _nextFrameStartTime; }
+	bool endOfTrack() const { return _endOfTrack; }
+	bool hasDirtyPalette() const { return _dirtyPalette; }
+	const byte *getPalette() const { return _palette; }
+
+private:
+	struct Frame {
+		Graphics::Surface surface;
+		bool valid;
+		bool dirtyPalette;
+		byte palette[256 * 3];
+		int curFrame;
+		uint32 nextFrameStartTime;
+		bool endOfTrack;
+	};
+
+	struct FillFunction {
+		FrameAheadQueue *queue;
+		FillFunction(FrameAheadQueue *q) : queue(q) {}
+		void operator()() const { queue->fill(); }
+	};
+
+	void startFilling();
+	void fill();
+	void decodeFrame(Frame &frame);
+
+	VideoDecoder *_decoder;
+	VideoTrack *_track;
+	uint _count;
+	bool _active;
+
+	Common::Array<Frame> _frames;
+	Common::Mutex _mutex;
+	uint _head;
+	uint _queued;
+	bool _trackEnded;
+	bool _cancel;
+
+	int _curFrame;
+	uint32 _nextFrameStartTime;
+	bool _endOfTrack;
+	bool _dirtyPalette;
+	byte _palette[256 * 3];
+
+	Common::Future<void> _filling;
+	Common::ThreadPool _pool;
+};
+
+VideoDecoder::FrameAheadQueue::FrameAheadQueue(VideoDecoder *decoder, VideoTrack *track, uint count) :
+		_decoder(decoder), _track(track), _count(count), _active(false), _frames(count + 1),
+		_head(0), _queued(0), _trackEnded(false), _cancel(false), _curFrame(-1),
+		_nextFrameStartTime(0), _endOfTrack(false), _dirtyPalette(false), _pool(1) {
+	memset(_palette, 0, sizeof(_palette));
+}
+
+VideoDecoder::FrameAheadQueue::~FrameAheadQueue() {
+	flush();
+
+	for (uint i = 0; i < _frames.size(); i++)
+		_frames[i].surface.free();
+}
+
+void VideoDecoder::FrameAheadQueue::start() {
+	// Allocate the surfaces up front, so that decoding does not have to
+	const uint16 width = _track->getWidth();
+	const uint16 height = _track->getHeight();
+	const Graphics::PixelFormat format = _track->getPixelFormat();
+	for (uint i = 0; i < _frames.size(); i++) {
+		Graphics::Surface &surface = _frames[i].surface;
+		if (surface.w != width || surface.h != height || surface.format != format) {
+			surface.free();
+			if (width && height && format.bytesPerPixel)
+				surface.create(width, height, format);
+		}
+	}
+
+	_curFrame = _track->getCurFrame();
+	_nextFrameStartTime = _track->getNextFrameStartTime();
+	_endOfTrack = _trackEnded = _track->endOfTrack();
+	_dirtyPalette = false;
+	_head = 0;
+	_queued = 0;
+	_active = true;
+
+	startFilling();
+}
+
+void VideoDecoder::FrameAheadQueue::stopFilling() {
+	_mutex.lock();
+	_cancel = true;
+	_mutex.unlock();
+
+	_filling.wait();
+
+	_cancel = false;
+}
+
+void VideoDecoder::FrameAheadQueue::flush() {
+	stopFilling();
+
+	_queued = 0;
+	_active = false;
+}
+
+const Graphics::Surface *VideoDecoder::FrameAheadQueue::nextFrame() {
+	_mutex.lock();
+	while (_queued == 0 && !_trackEnded) {
+		_mutex.unlock();
+		startFilling();
+		_filling.wait();
+		_mutex.lock();
+	}
+
+	if (_queued == 0) {
+		_mutex.unlock();
+		return nullptr;
+	}
+
+	const Frame &frame = _frames[_head];
+	_head = (_head + 1) % _frames.size();
+	_queued--;
+	_mutex.unlock();
+
+	_curFrame = frame.curFrame;
+	_nextFrameStartTime = frame.nextFrameStartTime;
+	_endOfTrack = frame.endOfTrack;
+	_dirtyPalette = frame.dirtyPalette;
+	if (_dirtyPalette)
+		memcpy(_palette, frame.palette, sizeof(_palette));
+
+	// Refill the slot which was just freed
+	startFilling();
+
+	return frame.valid ? &frame.surface : nullptr;
+}
+
+void VideoDecoder::FrameAheadQueue::startFilling() {
+	// A single task fills the queue, as frames must be decoded in order
+	if (_filling.isReady())
+		_filling = _pool.submit(FillFunction(this));
+}
+
+void VideoDecoder::FrameAheadQueue::fill() {
+	for (;;) {
+		_mutex.lock();
+		if (_cancel || _trackEnded || _queued >= _count) {
+			_mutex.unlock();
+			return;
+		}
+
+		// Neither the queued frames nor the one handed over last are touched
+		Frame &frame = _frames[(_head + _queued) % _frames.size()];
+		_mutex.unlock();
+
+		decodeFrame(frame);
+
+		_mutex.lock();
+		_queued++;
+		_trackEnded = frame.endOfTrack;
+		_mutex.unlock();
+	}
+}
+
+void VideoDecoder::FrameAheadQueue::decodeFrame(Frame &frame) {
+	_decoder->readNextPacket();
+
+	const Graphics::Surface *surface = _track->decodeNextFrame();
+	frame.valid = surface != nullptr;
+	if (surface) {
+		if (frame.surface.w == surface->w && frame.surface.h == surface->h && frame.surface.format == surface->format) {
+			frame.surface.copyRectToSurface(*surface, 0, 0, Common::Rect(surface->w, surface->h));
+		} else {
+			frame.surface.free();
+			frame.surface.copyFrom(*surface);
+		}
+	}
+
+	frame.dirtyPalette = _track->hasDirtyPalette();
+	if (frame.dirtyPalette)
+		memcpy(frame.palette, _track->getPalette(), sizeof(frame.palette));
+
+	frame.curFrame = _track->getCurFrame();
+	frame.nextFrameStartTime = _track->getNextFrameStartTime();
+	frame.endOfTrack = _track->endOfTrack();
+}
+
 VideoDecoder::VideoDecoder() {
 	_startTime = 0;
 	_dirtyPalette = false;
@@ -48,12 +280,23 @@ VideoDecoder::VideoDecoder() {
 	_canSetDither = true;
 	_canSetDefaultFormat = true;
 	_videoCodecAccuracy = Image::CodecAccuracy::Default;
+	_frameAhead = nullptr;
+	_frameAheadSuspended = false;
+}
+
+VideoDecoder::~VideoDecoder() {
+	delete _frameAhead;
 }
 
 void VideoDecoder::close() {
 	if (isPlaying())
 		stop();
 
+	// Stop the worker thread before the tracks go away
+	delete _frameAhead;
+	_frameAhead = nullptr;
+	_frameAheadSuspended = false;
+
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		delete *it;
 
@@ -136,9 +379,11 @@ void VideoDecoder::pauseVideo(bool pause) {
 	if (_pauseLevel == 1 && pause) {
 		_pauseStartTime = g_system->getMillis(); // Store the starting time from pausing to keep it for later
 
+		holdFrameAhead();
 		for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
 			(*it)->pause(true);
 	} else if (_pauseLevel == 0) {
+		holdFrameAhead();
 		for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
 			(*it)->pause(false);
 
@@ -212,6 +457,27 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	_canSetDither = false;
 	_canSetDefaultFormat = false;
 
+	if (_frameAhead && !_frameAheadSuspended) {
+		if (!_frameAhead->isActive())
+			_frameAhead->start();
+
+		if (!_frameAhead->endOfTrack()) {
+			const Graphics::Surface *frame = _frameAhead->nextFrame();
+
+			if (_frameAhead->hasDirtyPalette()) {
+				_palette = _frameAhead->getPalette();
+				_dirtyPalette = true;
+			}
+
+			findNextVideoTrack();
+			return frame;
+		}
+
+		// The video track is finished, but there may still be audio to read.
+		// Make sure the worker thread is done with the track first.
+		_frameAhead->finish();
+	}
+
 	readNextPacket();
 
 	// If we have no next video track at this point, there shouldn't be
@@ -237,6 +503,10 @@ bool VideoDecoder::setReverse(bool reverse) {
 	if (reverse && hasAudio())
 		return false;
 
+	// Frames are only decoded ahead in the forward direction
+	if (reverse && _frameAhead)
+		return false;
+
 	// Attempt to make sure all the tracks are in the requested direction
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo && ((VideoTrack *)*it)->isReversed() != reverse) {
@@ -261,7 +531,7 @@ int VideoDecoder::getCurFrame() const {
 
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo)
-			frame += ((VideoTrack *)*it)->getCurFrame() + 1;
+			frame += getTrackCurFrame((const VideoTrack *)*it) + 1;
 
 	return frame;
 }
@@ -302,7 +572,7 @@ uint32 VideoDecoder::getTimeToNextFrame() const {
 		return 0;
 
 	uint32 currentTime = getTime();
-	uint32 nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
+	uint32 nextFrameStartTime = getTrackNextFrameStartTime(_nextVideoTrack);
 
 	if (_nextVideoTrack->isReversed()) {
 		// For reversed videos, we need to handle the time difference the opposite way.
@@ -323,8 +593,8 @@ bool VideoDecoder::endOfVideo() const {
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		const Track *track = *it;
 
-		bool videoEndTimeReached = _endTimeSet && track->getTrackType() == Track::kTrackTypeVideo && ((const VideoTrack *)track)->getNextFrameStartTime() >= (uint)_endTime.msecs();
-		bool endReached = track->endOfTrack() || (isPlaying() && videoEndTimeReached);
+		bool videoEndTimeReached = _endTimeSet && track->getTrackType() == Track::kTrackTypeVideo && getTrackNextFrameStartTime((const VideoTrack *)track) >= (uint)_endTime.msecs();
+		bool endReached = isTrackAtEnd(track) || (isPlaying() && videoEndTimeReached);
 		if (!endReached)
 			return false;
 	}
@@ -348,12 +618,16 @@ bool VideoDecoder::rewind() {
 		return false;
 
 	// Stop all tracks so they can be rewound
+	suspendFrameAhead();
 	if (isPlaying())
 		stopAudio();
 
-	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
-		if (!(*it)->rewind())
+	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
+		if (!(*it)->rewind()) {
+			resumeFrameAhead();
 			return false;
+		}
+	}
 
 	// Now that we've rewound, start all tracks again
 	if (isPlaying())
@@ -362,6 +636,7 @@ bool VideoDecoder::rewind() {
 	_lastTimeChange = 0;
 	_startTime = g_system->getMillis();
 	resetPauseStartTime();
+	resumeFrameAhead();
 	findNextVideoTrack();
 	return true;
 }
@@ -382,17 +657,23 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 		return false;
 
 	// Stop all tracks so they can be seek'ed
+	suspendFrameAhead();
 	if (isPlaying())
 		stopAudio();
 
 	// Do the actual seeking
-	if (!seekIntern(time))
+	if (!seekIntern(time)) {
+		resumeFrameAhead();
 		return false;
+	}
 
 	// Seek any external track too
-	for (TrackListIterator it = _externalTracks.begin(); it != _externalTracks.end(); it++)
-		if (!(*it)->seek(time))
+	for (TrackListIterator it = _externalTracks.begin(); it != _externalTracks.end(); it++) {
+		if (!(*it)->seek(time)) {
+			resumeFrameAhead();
 			return false;
+		}
+	}
 
 	_lastTimeChange = time;
 
@@ -404,6 +685,7 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 	}
 
 	resetPauseStartTime();
+	resumeFrameAhead();
 	findNextVideoTrack();
 	_needsUpdate = true;
 	return true;
@@ -577,6 +859,85 @@ void VideoDecoder::setVideoCodecAccuracy(Image::CodecAccuracy accuracy) {
 	}
 }
 
+bool VideoDecoder::setFrameAheadCount(uint frames) {
+	// If a frame was already decoded, we can't set it now.
+	if (!_canSetDefaultFormat)
+		return false;
+
+	delete _frameAhead;
+	_frameAhead = nullptr;
+
+	if (frames == 0)
+		return true;
+
+	VideoTrack *track = nullptr;
+
+	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo) {
+			// We only allow decoding ahead when one video track is present
+			if (track)
+				return false;
+
+			track = (VideoTrack *)*it;
+		}
+	}
+
+	if (!track || track->isReversed())
+		return false;
+
+	_frameAhead = new FrameAheadQueue(this, track, frames);
+	if (!_frameAhead->hasWorker()) {
+		delete _frameAhead;
+		_frameAhead = nullptr;
+		return false;
+	}
+
+	return true;
+}
+
+void VideoDecoder::suspendFrameAhead() {
+	// The tracks are accessed directly until resumeFrameAhead() is called,
+	// which includes any frames decoded by seekIntern().
+	_frameAheadSuspended = true;
+	if (_frameAhead)
+		_frameAhead->flush();
+}
+
+void VideoDecoder::holdFrameAhead() {
+	// The worker thread reads packets, which feed the audio tracks as well,
+	// so it must not run while the tracks are started, stopped or paused.
+	// The frames decoded ahead stay valid.
+	if (_frameAhead)
+		_frameAhead->stopFilling();
+}
+
+void VideoDecoder::resumeFrameAhead() {
+	// Decoding ahead restarts from the new position of the track with
+	// the next decodeNextFrame() call
+	_frameAheadSuspended = false;
+}
+
+bool VideoDecoder::isTrackAtEnd(const Track *track) const {
+	if (_frameAhead && _frameAhead->isActive() && track == _frameAhead->getTrack())
+		return _frameAhead->endOfTrack();
+
+	return track->endOfTrack();
+}
+
+int VideoDecoder::getTrackCurFrame(const VideoTrack *track) const {
+	if (_frameAhead && _frameAhead->isActive() && track == _frameAhead->getTrack())
+		return _frameAhead->getCurFrame();
+
+	return track->getCurFrame();
+}
+
+uint32 VideoDecoder::getTrackNextFrameStartTime(const VideoTrack *track) const {
+	if (_frameAhead && _frameAhead->isActive() && track == _frameAhead->getTrack())
+		return _frameAhead->getNextFrameStartTime();
+
+	return track->getNextFrameStartTime();
+}
+
 VideoDecoder::Track::Track() {
 	_paused = false;
 }
@@ -942,7 +1303,7 @@ void VideoDecoder::setEndFrame(uint frame) {
 
 void VideoDecoder::resetStartTime() {
 	if (_nextVideoTrack) {
-		Audio::Timestamp curTime = _nextVideoTrack->getFrameTime(_nextVideoTrack->getCurFrame());
+		Audio::Timestamp curTime = _nextVideoTrack->getFrameTime(getTrackCurFrame(_nextVideoTrack));
 		if (isPlaying()) {
 			_startTime = g_system->getMillis() - (curTime.msecs() / _playbackRate).toInt();
 		}
@@ -976,9 +1337,9 @@ VideoDecoder::VideoTrack *VideoDecoder::findNextVideoTrack() {
 	uint32 bestTime = 0xFFFFFFFF;
 
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
-		if ((*it)->getTrackType() == Track::kTrackTypeVideo && !(*it)->endOfTrack()) {
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo && !isTrackAtEnd(*it)) {
 			VideoTrack *track = (VideoTrack *)*it;
-			uint32 time = track->getNextFrameStartTime();
+			uint32 time = getTrackNextFrameStartTime(track);
 
 			if (time < bestTime) {
 				bestTime = time;
@@ -991,6 +1352,8 @@ VideoDecoder::VideoTrack *VideoDecoder::findNextVideoTrack() {
 }
 
 void VideoDecoder::startAudio() {
+	holdFrameAhead();
+
 	if (_endTimeSet) {
 		// HACK: Timestamp's subtraction asserts out when subtracting two times
 		// with different rates.
@@ -1004,12 +1367,16 @@ void VideoDecoder::startAudio() {
 }
 
 void VideoDecoder::stopAudio() {
+	holdFrameAhead();
+
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if ((*it)->getTrackType() == Track::kTrackTypeAudio)
 			((AudioTrack *)*it)->stop();
 }
 
 void VideoDecoder::setAudioRate(Common::Rational rate) {
+	holdFrameAhead();
+
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if ((*it)->getTrackType() == Track::kTrackTypeAudio) {
 			((AudioTrack *)*it)->setRate(rate);
@@ -1017,6 +1384,8 @@ void VideoDecoder::setAudioRate(Common::Rational rate) {
 }
 
 void VideoDecoder::startAudioLimit(const Audio::Timestamp &limit) {
+	holdFrameAhead();
+
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if ((*it)->getTrackType() == Track::kTrackTypeAudio)
 			((AudioTrack *)*it)->start(limit);
@@ -1032,8 +1401,8 @@ bool VideoDecoder::hasFramesLeft() const {
 
 		const VideoTrack *track = (const VideoTrack *)*it;
 
-		bool videoEndTimeReached = _endTimeSet && track->getNextFrameStartTime() >= (uint)_endTime.msecs();
-		bool endReached = track->endOfTrack() || (isPlaying() && videoEndTimeReached);
+		bool videoEndTimeReached = _endTimeSet && getTrackNextFrameStartTime(track) >= (uint)_endTime.msecs();
+		bool endReached = isTrackAtEnd(track) || (isPlaying() && videoEndTimeReached);
 		if (!endReached)
 			return true;
 	}
@@ -53,7 +53,7 @@ namespace Video {
 class VideoDecoder {
 public:
 	VideoDecoder();
-	virtual ~VideoDecoder() {}
+	virtual ~VideoDecoder();
 
 	/////////////////////////////////////////
 	// Opening/Closing a Video
@@ -371,7 +371,8 @@ public:
 	 * By default, VideoDecoder will decode forward.
 	 *
 	 * @note This is used by setRate()
-	 * @note This will not work if an audio track is present
+	 * @note This will not work if an audio track is present, or if frames
+	 *       are decoded ahead
 	 * @param reverse true for reverse, false for forward
 	 * @return true on success, false otherwise
 	 */
@@ -407,6 +408,31 @@ public:
 	 */
 	bool setOutputPixelFormat(const Graphics::PixelFormat &format);
 
+	/**
+	 * Decode frames ahead of playback on a worker thread.
+	 *
+	 * A worker thread decodes up to the given number of frames ahead into a
+	 * ring of surfaces, so that decodeNextFrame() only has to hand over a
+	 * frame which is already decoded. The current frame, the timing and the
+	 * end of the video all follow the frames handed over, not the position
+	 * reached by the worker thread, which keeps them in sync with the audio.
+	 * Seeking and rewinding drop the frames decoded ahead.
+	 *
+	 * This only works when one video track is present, which is played
+	 * forwards, and when the backend supports threads. While frames are
+	 * decoded ahead, the tracks must not be accessed other than through the
+	 * functions of this class. Subclasses have to start, stop and pause the
+	 * tracks through them as well, which wait for the worker thread first.
+	 *
+	 * This should be called after loadStream(), but before a decodeNextFrame()
+	 * call. This is enforced. The setting is reset by close().
+	 *
+	 * @param frames The number of frames to decode ahead, or 0 to decode
+	 *               frames when they are requested
+	 * @return true on success, false otherwise
+	 */
+	bool setFrameAheadCount(uint frames);
+
 	/**
 	 * Set the accuracy of the video decoder
 	 */
@@ -1000,6 +1026,18 @@ private:
 	bool _canSetDither;
 	bool _canSetDefaultFormat;
 
+	// Frames decoded ahead on a worker thread
+	class FrameAheadQueue;
+	FrameAheadQueue *_frameAhead;
+	bool _frameAheadSuspended;
+
+	void suspendFrameAhead();
+	void holdFrameAhead();
+	void resumeFrameAhead();
+	bool isTrackAtEnd(const Track *track) const;
+	int getTrackCurFrame(const VideoTrack *track) const;
+	uint32 getTrackNextFrameStartTime(const VideoTrack *track) const;
+
 protected:
 	// Internal helper functions
 	void stopAudio();